@@ -0,0 +1,28 @@
+# - Find FFTW
+# Find the native FFTW (double precision) includes and library
+#
+#  FFTW_INCLUDE_DIR - user modifiable choice of where the FFTW headers are
+#  FFTW_LIBRARY     - user modifiable choice of where the FFTW library is
+#
+# This module returns these variables for the rest of the project to use.
+#
+#  FFTW_FOUND        - True if FFTW was found
+#  FFTW_LIBRARIES    - The FFTW library
+#  FFTW_INCLUDE_DIRS - The directory containing fftw3.h
+
+include(FindPackageHandleStandardArgs)
+
+find_path(FFTW_INCLUDE_DIR fftw3.h
+    PATHS "${FFTW_DIR}/include")
+find_library(FFTW_LIBRARY NAMES fftw3
+    PATHS "${FFTW_DIR}/lib"
+    HINTS "${FFTW_INCLUDE_DIR}/../lib")
+
+find_package_handle_standard_args(FFTW DEFAULT_MSG FFTW_LIBRARY FFTW_INCLUDE_DIR)
+
+if (FFTW_FOUND)
+    set(FFTW_LIBRARIES ${FFTW_LIBRARY})
+    set(FFTW_INCLUDE_DIRS ${FFTW_INCLUDE_DIR})
+endif()
+
+mark_as_advanced(FFTW_INCLUDE_DIR FFTW_LIBRARY)
@@ -0,0 +1,75 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "AdaptiveOmega.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The estimate of the spectral radius is limited to this value. Otherwise, rounding errors in the residual ratio could
+ * lead to an over-relaxation factor close to 2, for which the SOR solver converges extremely slowly.
+ */
+const double MAX_JACOBI_SPECTRAL_RADIUS = 0.9999;
+
+void updateAdaptiveOmega(Real residualStart, Real residualEnd, AdaptiveOmegaData &adaptiveOmegaData) {
+    if (!(residualStart > Real(0.0)) || !(residualEnd > Real(0.0))) {
+        return;
+    }
+
+    // Geometric mean of the residual reduction per iteration, i.e., an estimate of the dominant eigenvalue lambda.
+    const double omg = adaptiveOmegaData.omg;
+    const double lambda = std::pow(
+            double(residualEnd) / double(residualStart),
+            1.0 / double(ADAPTIVE_OMEGA_ESTIMATION_END - ADAPTIVE_OMEGA_ESTIMATION_START));
+
+    // For omega larger than the optimal factor, all eigenvalues have the absolute value omega - 1, and nothing can be
+    // learned from the residual ratio. For the optimal factor, the two largest eigenvalues coincide, and the error
+    // decays like k (omega - 1)^k. Thus, only a reduction slower than this indicates that omega is too small. Otherwise,
+    // the factor would slowly creep past the optimum. Nothing can be learned either if the solver stagnates.
+    const double optimalReduction = (omg - 1.0) * std::pow(
+            double(ADAPTIVE_OMEGA_ESTIMATION_END) / double(ADAPTIVE_OMEGA_ESTIMATION_START),
+            1.0 / double(ADAPTIVE_OMEGA_ESTIMATION_END - ADAPTIVE_OMEGA_ESTIMATION_START));
+    if (lambda <= optimalReduction || lambda >= 1.0) {
+        return;
+    }
+
+    // In the first iterations, the slowly decaying error components don't dominate the residual yet. Thus, the
+    // estimate is too small, and it is only ever increased.
+    double mu = std::sqrt((lambda + omg - 1.0) * (lambda + omg - 1.0) / (lambda * omg * omg));
+    mu = std::min(mu, MAX_JACOBI_SPECTRAL_RADIUS);
+    if (mu <= double(adaptiveOmegaData.jacobiSpectralRadius)) {
+        return;
+    }
+
+    adaptiveOmegaData.jacobiSpectralRadius = Real(mu);
+    adaptiveOmegaData.omg = Real(2.0 / (1.0 + std::sqrt(1.0 - mu * mu)));
+}
+
+}
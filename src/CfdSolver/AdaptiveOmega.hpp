@@ -0,0 +1,70 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_ADAPTIVEOMEGA_HPP
+#define CFD3D_ADAPTIVEOMEGA_HPP
+
+#include "Defines.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The iterations of a solve between which the convergence factor of the SOR solver is measured. The first iterations
+ * are skipped, as the residual there is still dominated by the fast decaying error components.
+ */
+const int ADAPTIVE_OMEGA_ESTIMATION_START = 10;
+const int ADAPTIVE_OMEGA_ESTIMATION_END = 20;
+
+/**
+ * The over-relaxation factor of the SOR solver estimated online.
+ * For consistently ordered matrices (e.g., the 7-point Laplace operator with lexicographic or red-black ordering), the
+ * eigenvalues lambda of the SOR iteration matrix and mu of the Jacobi iteration matrix satisfy
+ * (lambda + omega - 1)^2 = lambda omega^2 mu^2, and the optimal factor is omega = 2 / (1 + sqrt(1 - mu^2)) [Young].
+ * The spectral radius mu of the Jacobi iteration matrix is estimated from the ratio of the residual norms in the first
+ * iterations of a solve. The operator doesn't change between time steps, so the estimate is kept and refined over the
+ * whole simulation.
+ */
+struct AdaptiveOmegaData {
+    bool isEnabled = false;
+    // The current estimate of the spectral radius of the Jacobi iteration matrix (0: no estimate yet).
+    Real jacobiSpectralRadius = Real(0.0);
+    // The over-relaxation factor to use in the next iterations.
+    Real omg = Real(1.0);
+};
+
+/**
+ * Updates the estimate of the spectral radius of the Jacobi iteration matrix and the resulting over-relaxation factor.
+ * @param residualStart The residual norm after ADAPTIVE_OMEGA_ESTIMATION_START iterations.
+ * @param residualEnd The residual norm after ADAPTIVE_OMEGA_ESTIMATION_END iterations.
+ * @param adaptiveOmegaData The estimate to update. adaptiveOmegaData.omg must be the factor used in the iterations.
+ */
+void updateAdaptiveOmega(Real residualStart, Real residualEnd, AdaptiveOmegaData &adaptiveOmegaData);
+
+}
+
+#endif //CFD3D_ADAPTIVEOMEGA_HPP
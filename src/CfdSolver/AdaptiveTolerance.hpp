@@ -0,0 +1,61 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_ADAPTIVETOLERANCE_HPP
+#define CFD3D_ADAPTIVETOLERANCE_HPP
+
+#include "Defines.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The tolerance of a time step may be at most this factor times the divergence left after the previous time step
+ * (divided by dt). Thus, the divergence can only grow gradually from time step to time step.
+ */
+const Real ADAPTIVE_TOLERANCE_MAX_GROWTH = Real(2.0);
+
+/**
+ * Computes the residual for which the solution of the PPE is considered as converged in the current time step
+ * (inexact projection). After the velocity update, the divergence of the velocity field is dt times the residual of the
+ * PPE. Thus, solving the PPE to a tolerance far below the size of the right-hand side RS mostly wastes iterations,
+ * especially when the flow barely changes and the initial guess is already close to the solution. The tolerance is
+ * epsRelative times the norm of RS, but at most ADAPTIVE_TOLERANCE_MAX_GROWTH times the divergence left after the
+ * previous time step (divided by dt), and never smaller than eps.
+ * @param eps The lower bound of the tolerance (i.e., the tolerance of the exact projection).
+ * @param epsRelative The tolerance relative to the norm of the right-hand side.
+ * @param dt The time step size.
+ * @param rsNorm The norm of the right-hand side RS (normalized by the number of fluid cells like the residual).
+ * @param divergenceNorm The norm of the divergence of the velocity field before the projection (normalized by the
+ * number of fluid cells).
+ * @return The tolerance to use for the PPE solver in the current time step.
+ */
+Real computeAdaptiveTolerance(Real eps, Real epsRelative, Real dt, Real rsNorm, Real divergenceNorm);
+
+}
+
+#endif //CFD3D_ADAPTIVETOLERANCE_HPP
@@ -27,3 +27,21 @@
  */
 
 #include "CfdSolver.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+Real CfdSolver::step(bool useTemperature) {
+    setBoundaryValues();
+    setBoundaryValuesScenarioSpecific();
+    Real dt = calculateDt();
+    if (useTemperature) {
+        calculateTemperature();
+    }
+    calculateFgh();
+    calculateRs();
+    executeSorSolver();
+    calculateUvw();
+    return dt;
+}
+
+}
@@ -33,6 +33,8 @@
 #include <cstdint>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * A solver for the incompressible Navier-Stokes equations in 3D.
  * For more details on the approach of implementation chosen, see "Numerical Simulation in Fluid Dynamics. A Practical
@@ -51,6 +53,19 @@ public:
      * @param omg The over-relaxation factor of the SOR solver.
      * @param eps The residual value (epsilon) for which the solution of the SOR solver is considered as converged.
      * @param itermax The maximum number of iterations the SOR solver performs until it gives up.
+     * @param residualCheckInterval The number of iterations of the SOR solver after which the convergence is checked.
+     * @param pressureHistorySize The number of previous pressure solutions the initial guess of the SOR solver is
+     * computed from (0: The last solution is used as the initial guess).
+     * @param adaptiveOmega Whether the over-relaxation factor of the SOR solver is estimated online instead of using a
+     * fixed value (@see AdaptiveOmega.hpp).
+     * @param epsRelative If > 0, the residual for which the solution of the PPE is considered as converged is chosen in
+     * each time step relative to the norm of the right-hand side (@see AdaptiveTolerance.hpp). eps is then a lower
+     * bound.
+     * @param implicitDiffusion Whether the diffusive terms of the momentum and temperature equations are treated
+     * implicitly (backward Euler), such that the time step size is only restricted by the convective terms. Only
+     * supported by the C++ solver.
+     * @param timeIntegrator The explicit time integration scheme of the momentum and temperature equations. Only
+     * supported by the C++ solver.
      * @param alpha Donor-cell scheme factor.
      * @param beta Coefficient of thermal expansion.
      * @param dt If tau > 0: The constant time step to use for simulating. Otherwise, dt is overwritten each iteration.
@@ -77,9 +92,10 @@ public:
      */
     virtual void initialize(
             const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-            Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-            Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-            int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+            Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+            bool adaptiveOmega, Real epsRelative, bool implicitDiffusion, TimeIntegratorType timeIntegrator,
+            Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+            bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
             Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag)=0;
 
     virtual ~CfdSolver() {}
@@ -128,6 +144,15 @@ public:
      */
     virtual void calculateUvw()=0;
 
+    /**
+     * Performs one time step, i.e., sets the boundary values, computes the time step size and calls calculateTemperature
+     * (if useTemperature is true), calculateFgh, calculateRs, executeSorSolver and calculateUvw. Solvers can override
+     * this to fuse the individual passes over the grid.
+     * @param useTemperature Whether the temperature should also be simulated.
+     * @return The time step size used.
+     */
+    virtual Real step(bool useTemperature);
+
 
     /**
      * Copies the values of the internal representations of U, V, W, P and T to the specified arrays.
@@ -141,4 +166,6 @@ public:
     virtual void getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real *T)=0;
 };
 
+}
+
 #endif //CFD3D_CFDSOLVER_HPP
@@ -29,6 +29,8 @@
 #include "BoundaryValuesCpp.hpp"
 #include "../Flag.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void setLeftRightBoundariesCpp(
         Real T_h, Real T_c,
         int imax, int jmax, int kmax,
@@ -537,3 +539,5 @@ void setBoundaryValuesScenarioSpecificCpp(
         }
     }
 }
+
+}
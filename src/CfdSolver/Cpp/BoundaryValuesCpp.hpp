@@ -32,6 +32,8 @@
 #include <string>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Sets the boundary condition values of U, V, W and T using the Flag array.
  */
@@ -50,4 +52,6 @@ void setBoundaryValuesScenarioSpecificCpp(
         Real *U, Real *V, Real *W,
         FlagType *Flag);
 
+}
+
 #endif //CFD3D_BOUNDARYVALUESCPP_HPP
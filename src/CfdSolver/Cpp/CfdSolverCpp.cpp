@@ -32,12 +32,19 @@
 #include "UvwCpp.hpp"
 #include "SorSolverCpp.hpp"
 #include "CfdSolverCpp.hpp"
+#include "CfdSolver/AdaptiveTolerance.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+CfdSolverCpp::CfdSolverCpp(bool useMixedPrecisionPpe) : useMixedPrecisionPpe(useMixedPrecisionPpe) {
+}
 
 void CfdSolverCpp::initialize(
         const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-        Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-        int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+        Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+        bool adaptiveOmega, Real epsRelative, bool implicitDiffusion, TimeIntegratorType timeIntegrator,
+        Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+        bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
         Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag) {
     this->scenarioName = scenarioName;
     this->linearSystemSolverType = linearSystemSolverType;
@@ -47,6 +54,10 @@ void CfdSolverCpp::initialize(
     this->omg = omg;
     this->eps = eps;
     this->itermax = itermax;
+    this->residualCheckInterval = residualCheckInterval;
+    this->adaptiveOmegaData.isEnabled = adaptiveOmega;
+    this->epsRelative = epsRelative;
+    this->implicitDiffusion = implicitDiffusion;
     this->alpha = alpha;
     this->beta = beta;
     this->dt = dt;
@@ -80,7 +91,7 @@ void CfdSolverCpp::initialize(
 
     memset(this->U, 0, sizeof(Real)*(imax+1)*(jmax+2)*(kmax+2));
     memset(this->V, 0, sizeof(Real)*(imax+2)*(jmax+1)*(kmax+2));
-    memset(this->W, 0, sizeof(Real)*(imax+1)*(jmax+2)*(kmax+1));
+    memset(this->W, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+1));
     memset(this->P, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
     memset(this->P_temp, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
     memset(this->T, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
@@ -98,6 +109,44 @@ void CfdSolverCpp::initialize(
     memcpy(this->P, P, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
     memcpy(this->T, T, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
     memcpy(this->Flag, Flag, sizeof(unsigned int)*(imax+2)*(jmax+2)*(kmax+2));
+    createFghMasksCpp(imax, jmax, kmax, this->Flag, fghMasks);
+    createMaxVelocityDataCpp(imax, jmax, kmax, this->Flag, maxVelocityData);
+    if (implicitDiffusion) {
+        createImplicitDiffusionDataCpp(imax, jmax, kmax, this->Flag, implicitDiffusionData);
+    }
+    createTimeIntegratorDataCpp(timeIntegrator, imax, jmax, kmax, timeIntegratorData);
+
+    // The direct DCT solver is selected automatically if the domain contains no obstacles.
+    if (linearSystemSolverType == LINEAR_SOLVER_DCT && !isDctSolverApplicableCpp(imax, jmax, kmax, this->Flag)) {
+        linearSystemSolverType = LINEAR_SOLVER_JACOBI;
+        this->linearSystemSolverType = LINEAR_SOLVER_JACOBI;
+    }
+
+    if (linearSystemSolverType == LINEAR_SOLVER_MULTIGRID
+            || linearSystemSolverType == LINEAR_SOLVER_MULTIGRID_W_CYCLE) {
+        createMultigridHierarchyCpp(
+                dx, dy, dz, imax, jmax, kmax, this->P, this->P_temp, this->RS, this->Flag, multigridLevels);
+    }
+    if (linearSystemSolverType == LINEAR_SOLVER_DCT) {
+        createDctSolverDataCpp(dx, dy, dz, imax, jmax, kmax, dctData);
+    } else if (linearSystemSolverType != LINEAR_SOLVER_MULTIGRID
+            && linearSystemSolverType != LINEAR_SOLVER_MULTIGRID_W_CYCLE) {
+        createPressureOperatorCpp(dx, dy, dz, imax, jmax, kmax, this->Flag, pressureOperator);
+        if (linearSystemSolverType == LINEAR_SOLVER_PCG_JACOBI || linearSystemSolverType == LINEAR_SOLVER_PCG_SGS) {
+            createConjugateGradientDataCpp(imax, jmax, kmax, cgData);
+        } else if (linearSystemSolverType == LINEAR_SOLVER_CHEBYSHEV) {
+            createChebyshevDataCpp(imax, jmax, kmax, pressureOperator, chebyshevData);
+        } else if (isCompressedPressureOperatorApplicableCpp(linearSystemSolverType, imax, jmax, kmax, this->Flag)) {
+            createCompressedPressureOperatorCpp(
+                    imax, jmax, kmax, this->Flag, pressureOperator, this->P, compressedOperator);
+        } else if (useMixedPrecisionPpe && sizeof(Real) == sizeof(double)) {
+            // Iterating on a single precision correction only saves memory traffic if Real is double.
+            createMixedPrecisionDataCpp(imax, jmax, kmax, pressureOperator, mixedPrecisionData);
+        }
+    }
+    if (pressureHistorySize > 0 && linearSystemSolverType != LINEAR_SOLVER_DCT) {
+        createPressureHistoryCpp(pressureHistorySize, imax, jmax, kmax, pressureHistory);
+    }
 }
 
 CfdSolverCpp::~CfdSolverCpp() {
@@ -113,6 +162,19 @@ CfdSolverCpp::~CfdSolverCpp() {
     delete[] H;
     delete[] RS;
     delete[] Flag;
+
+    destroyFghMasksCpp(fghMasks);
+    destroyMaxVelocityDataCpp(maxVelocityData);
+    destroyImplicitDiffusionDataCpp(implicitDiffusionData);
+    destroyTimeIntegratorDataCpp(timeIntegratorData);
+    destroyMultigridHierarchyCpp(multigridLevels);
+    destroyConjugateGradientDataCpp(cgData);
+    destroyPressureOperatorCpp(pressureOperator);
+    destroyDctSolverDataCpp(dctData);
+    destroyMixedPrecisionDataCpp(mixedPrecisionData);
+    destroyChebyshevDataCpp(chebyshevData);
+    destroyCompressedPressureOperatorCpp(compressedOperator);
+    destroyPressureHistoryCpp(pressureHistory);
 }
 
 void CfdSolverCpp::setBoundaryValues() {
@@ -124,7 +186,9 @@ void CfdSolverCpp::setBoundaryValuesScenarioSpecific() {
 }
 
 Real CfdSolverCpp::calculateDt() {
-    calculateDtCpp(Re, Pr, tau, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, useTemperature);
+    calculateDtCpp(
+            Re, Pr, alpha, tau, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, useTemperature, implicitDiffusion,
+            timeIntegratorData.timeIntegrator);
     return dt;
 }
 
@@ -133,11 +197,36 @@ void CfdSolverCpp::calculateTemperature() {
     Real *temp = T;
     T = T_temp;
     T_temp = temp;
-    calculateTemperatureCpp(Re, Pr, alpha, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, T, T_temp, Flag);
+    calculateTemperatureCpp(
+            Re, Pr, alpha, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, T, T_temp, Flag, implicitDiffusion);
+    if (timeIntegratorData.timeIntegrator == TIME_INTEGRATOR_ADAMS_BASHFORTH_2) {
+        applyAdamsBashforthTemperatureCpp(dt, imax, jmax, kmax, T, T_temp, Flag, timeIntegratorData);
+    }
+    if (implicitDiffusion) {
+        solveImplicitTemperatureDiffusionCpp(
+                Re, Pr, dt, dx, dy, dz, imax, jmax, kmax, T, T_temp, implicitDiffusionData);
+    }
 }
 
 void CfdSolverCpp::calculateFgh() {
-    calculateFghCpp(Re, GX, GY, GZ, alpha, beta, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, T, F, G, H, Flag);
+    // Forward Euler uses the buoyancy of the already updated temperature. The higher-order time integrators need the
+    // buoyancy at the beginning of the time step (or stage), i.e., the temperature before calculateTemperature, as
+    // otherwise the lag of the coupling limits them to first order.
+    Real *T_buoyancy = T;
+    if (useTemperature && timeIntegratorData.timeIntegrator != TIME_INTEGRATOR_EULER) {
+        T_buoyancy = T_temp;
+    }
+    calculateFghCpp(
+            Re, GX, GY, GZ, alpha, beta, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, T_buoyancy, F, G, H, fghMasks,
+            implicitDiffusion, nullptr);
+    if (timeIntegratorData.timeIntegrator == TIME_INTEGRATOR_ADAMS_BASHFORTH_2) {
+        applyAdamsBashforthMomentumCpp(dt, imax, jmax, kmax, U, V, W, F, G, H, fghMasks, timeIntegratorData);
+    }
+    if (implicitDiffusion) {
+        solveImplicitMomentumDiffusionCpp(
+                Re, GX, GY, GZ, beta, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, T_buoyancy, F, G, H, fghMasks,
+                implicitDiffusionData);
+    }
 }
 
 void CfdSolverCpp::calculateRs() {
@@ -146,13 +235,88 @@ void CfdSolverCpp::calculateRs() {
 
 
 void CfdSolverCpp::executeSorSolver() {
+    if (pressureHistory.maxSize > 0) {
+        computePressureInitialGuessCpp(imax, jmax, kmax, P, RS, pressureHistory);
+    }
+    Real epsStep = eps;
+    if (epsRelative > Real(0.0)) {
+        // The velocities are still the ones of the last time step, i.e., this is the divergence it left behind.
+        Real divergence = computeDivergenceNormCpp(dx, dy, dz, imax, jmax, kmax, U, V, W, Flag);
+        Real rsNorm = computeRsNormCpp(imax, jmax, kmax, RS, Flag);
+        epsStep = computeAdaptiveTolerance(eps, epsRelative, dt, rsNorm, divergence);
+        if (shallWriteOutput) {
+            std::cout << "\nDivergence: " << divergence << ", PPE tolerance: " << epsStep << std::endl;
+        }
+    }
     sorSolverCpp(
-            omg, eps, itermax, linearSystemSolverType, shallWriteOutput,
-            dx, dy, dz, imax, jmax, kmax, P, P_temp, RS, Flag);
+            omg, epsStep, itermax, residualCheckInterval, linearSystemSolverType, shallWriteOutput,
+            dx, dy, dz, imax, jmax, kmax, P, P_temp, RS, Flag, multigridLevels, cgData,
+            pressureOperator, dctData, mixedPrecisionData, chebyshevData, compressedOperator,
+            adaptiveOmegaData);
+    if (pressureHistory.maxSize > 0) {
+        addPressureSolutionCpp(dx, dy, dz, imax, jmax, kmax, P, Flag, pressureOperator, pressureHistory);
+    }
 }
 
 void CfdSolverCpp::calculateUvw() {
-    calculateUvwCpp(dt, dx, dy, dz, imax, jmax, kmax, U, V, W, F, G, H, P, Flag);
+    Real uMaxAbs, vMaxAbs, wMaxAbs;
+    calculateUvwCpp(dt, dx, dy, dz, imax, jmax, kmax, U, V, W, F, G, H, P, Flag, uMaxAbs, vMaxAbs, wMaxAbs);
+    maxVelocityData.isValid = false;
+}
+
+Real CfdSolverCpp::step(bool useTemperature) {
+    setBoundaryValues();
+    setBoundaryValuesScenarioSpecific();
+    if (maxVelocityData.isValid) {
+        // The maxima over the faces updated in the last step are known from calculateUvwCpp.
+        computeMaxVelocitiesListedFacesCpp(U, V, W, maxVelocityData);
+        calculateDtFromMaxVelocitiesCpp(
+                Re, Pr, alpha, tau, dt, dx, dy, dz, maxVelocityData.uMaxAbs, maxVelocityData.vMaxAbs,
+                maxVelocityData.wMaxAbs, useTemperature, implicitDiffusion, timeIntegratorData.timeIntegrator);
+    } else {
+        calculateDt();
+    }
+
+    if (timeIntegratorData.timeIntegrator == TIME_INTEGRATOR_RUNGE_KUTTA_3) {
+        saveRungeKuttaStateCpp(imax, jmax, kmax, U, V, W, T, useTemperature, timeIntegratorData);
+        computeForwardEulerStage(useTemperature);
+        setBoundaryValues();
+        setBoundaryValuesScenarioSpecific();
+        computeForwardEulerStage(useTemperature);
+        blendRungeKuttaStageCpp(
+                RUNGE_KUTTA_3_STAGE_2_WEIGHT_OLD, imax, jmax, kmax, U, V, W, T, useTemperature, timeIntegratorData);
+        setBoundaryValues();
+        setBoundaryValuesScenarioSpecific();
+        computeForwardEulerStage(useTemperature);
+        blendRungeKuttaStageCpp(
+                RUNGE_KUTTA_3_STAGE_3_WEIGHT_OLD, imax, jmax, kmax, U, V, W, T, useTemperature, timeIntegratorData);
+        // The maxima of the last stage are not the ones of the blended velocities.
+        maxVelocityData.isValid = false;
+    } else {
+        computeForwardEulerStage(useTemperature);
+    }
+    return dt;
+}
+
+void CfdSolverCpp::computeForwardEulerStage(bool useTemperature) {
+    if (useTemperature) {
+        calculateTemperature();
+    }
+    if (implicitDiffusion || timeIntegratorData.timeIntegrator != TIME_INTEGRATOR_EULER) {
+        // The right-hand side of the PPE depends on the solution of the diffusion equations or the Adams-Bashforth
+        // correction of F, G and H, and the higher-order time integrators use a different temperature for the buoyancy.
+        calculateFgh();
+        calculateRs();
+    } else {
+        calculateFghCpp(
+                Re, GX, GY, GZ, alpha, beta, dt, dx, dy, dz, imax, jmax, kmax, U, V, W, T, F, G, H, fghMasks,
+                false, RS);
+    }
+    executeSorSolver();
+    calculateUvwCpp(
+            dt, dx, dy, dz, imax, jmax, kmax, U, V, W, F, G, H, P, Flag,
+            maxVelocityData.uMaxAbs, maxVelocityData.vMaxAbs, maxVelocityData.wMaxAbs);
+    maxVelocityData.isValid = maxVelocityData.facesU != nullptr;
 }
 
 void CfdSolverCpp::getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real *T) {
@@ -163,3 +327,5 @@ void CfdSolverCpp::getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real *T)
     memcpy(P, this->P, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
     memcpy(T, this->T, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
 }
+
+}
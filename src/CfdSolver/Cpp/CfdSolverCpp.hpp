@@ -29,10 +29,31 @@
 #ifndef CFD3D_CFDSOLVERCPP_HPP
 #define CFD3D_CFDSOLVERCPP_HPP
 
+#include <vector>
 #include "CfdSolver/CfdSolver.hpp"
+#include "UvwCpp.hpp"
+#include "MultigridCpp.hpp"
+#include "ConjugateGradientCpp.hpp"
+#include "PressureOperatorCpp.hpp"
+#include "DctSolverCpp.hpp"
+#include "MixedPrecisionCpp.hpp"
+#include "ChebyshevCpp.hpp"
+#include "CompressedPressureOperatorCpp.hpp"
+#include "ImplicitDiffusionCpp.hpp"
+#include "TimeIntegratorCpp.hpp"
+#include "CfdSolver/AdaptiveOmega.hpp"
+#include "PressureHistoryCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
 
 class CfdSolverCpp : public CfdSolver {
 public:
+    /**
+     * @param useMixedPrecisionPpe Whether the Jacobi and SOR type solvers iterate in single precision on the correction
+     * of the pressure (@see MixedPrecisionCpp.hpp). This is only done if Real is double.
+     */
+    explicit CfdSolverCpp(bool useMixedPrecisionPpe = false);
+
     /**
      * Copies the passed initial values of U, V, W, P, T and Flag to the internal representation of the solver.
      * @param scenarioName The name of the scenario as a short string.
@@ -44,6 +65,17 @@ public:
      * @param omg The over-relaxation factor of the SOR solver.
      * @param eps The residual value (epsilon) for which the solution of the SOR solver is considered as converged.
      * @param itermax The maximum number of iterations the SOR solver performs until it gives up.
+     * @param residualCheckInterval The number of iterations of the SOR solver after which the convergence is checked.
+     * @param pressureHistorySize The number of previous pressure solutions the initial guess of the SOR solver is
+     * computed from (0: The last solution is used as the initial guess).
+     * @param adaptiveOmega Whether the over-relaxation factor of the SOR solver is estimated online instead of using a
+     * fixed value (@see AdaptiveOmega.hpp).
+     * @param epsRelative If > 0, the residual for which the solution of the PPE is considered as converged is chosen in
+     * each time step relative to the norm of the right-hand side (@see AdaptiveTolerance.hpp). eps is then a lower
+     * bound.
+     * @param implicitDiffusion Whether the diffusive terms of the momentum and temperature equations are treated
+     * implicitly (backward Euler), such that the time step size is only restricted by the convective terms.
+     * @param timeIntegrator The explicit time integration scheme of the momentum and temperature equations.
      * @param alpha Donor-cell scheme factor.
      * @param beta Coefficient of thermal expansion.
      * @param dt If tau > 0: The constant time step to use for simulating. Otherwise, dt is overwritten each iteration.
@@ -70,9 +102,10 @@ public:
      */
     virtual void initialize(
             const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-            Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-            Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-            int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+            Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+            bool adaptiveOmega, Real epsRelative, bool implicitDiffusion, TimeIntegratorType timeIntegrator,
+            Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+            bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
             Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag);
 
     /**
@@ -124,6 +157,16 @@ public:
      */
     virtual void calculateUvw();
 
+    /**
+     * Performs one time step like the default implementation (@see CfdSolver::step), but computes the right-hand side
+     * of the PPE in the same sweep as F, G and H, and the maximum velocities for the time step size of the next step in
+     * the same sweep as the velocity update. With the Runge-Kutta time integrator, the time step consists of three such
+     * stages with the same time step size.
+     * @param useTemperature Whether the temperature should also be simulated.
+     * @return The time step size used.
+     */
+    virtual Real step(bool useTemperature);
+
 
     /**
      * Copies the values of the internal representations of U, V, W, P and T to the specified arrays.
@@ -137,17 +180,67 @@ public:
     virtual void getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real *T);
 
 private:
+    /**
+     * Computes the forward Euler step of step (or one stage of the Runge-Kutta method) with the current time step size
+     * dt, i.e., calls calculateTemperature (if useTemperature is true), calculateFgh, calculateRs, executeSorSolver and
+     * calculateUvw, fusing the passes over the grid where possible.
+     */
+    void computeForwardEulerStage(bool useTemperature);
+
     std::string scenarioName;
     LinearSystemSolverType linearSystemSolverType;
     bool shallWriteOutput;
-    Real Re, Pr, omg, eps, alpha, beta, dt, tau, GX, GY, GZ, T_h, T_c;
-    bool useTemperature;
-    int itermax;
+    Real Re, Pr, omg, eps, epsRelative, alpha, beta, dt, tau, GX, GY, GZ, T_h, T_c;
+    bool useTemperature, implicitDiffusion;
+    int itermax, residualCheckInterval;
     int imax, jmax, kmax;
     Real dx, dy, dz;
     Real *U, *V, *W , *P, *P_temp, *T, *T_temp, *F, *G, *H, *RS;
     FlagType *Flag;
+
+    // Which faces are computed or copied by the momentum kernel (calculateFghCpp).
+    FghMasksCpp fghMasks;
+
+    // Only used if the diffusive terms are treated implicitly.
+    ImplicitDiffusionDataCpp implicitDiffusionData;
+
+    // The history (Adams-Bashforth) or stage (Runge-Kutta) arrays of the time integrator.
+    TimeIntegratorDataCpp timeIntegratorData;
+
+    // The maximum absolute velocities computed by the velocity update of the fused time step pipeline (step).
+    MaxVelocityDataCpp maxVelocityData;
+
+    // Only used by the multigrid solver for the PPE.
+    std::vector<MultigridLevelCpp> multigridLevels;
+
+    // Only used by the preconditioned conjugate gradient solver for the PPE.
+    ConjugateGradientDataCpp cgData;
+
+    // Only used by the Jacobi and SOR type solvers for the PPE.
+    PressureOperatorCpp pressureOperator;
+
+    // Only used by the direct DCT solver for the PPE.
+    DctSolverDataCpp dctData;
+
+    // The single precision work arrays of the Jacobi and SOR type solvers (only if useMixedPrecisionPpe is set).
+    bool useMixedPrecisionPpe;
+    MixedPrecisionDataCpp mixedPrecisionData;
+
+    // Only used by the Chebyshev solver for the PPE.
+    ChebyshevDataCpp chebyshevData;
+
+    // The pressure operator restricted to the fluid cells (only if the Jacobi or SOR solver is used in a domain with
+    // many obstacle cells).
+    CompressedPressureOperatorCpp compressedOperator;
+
+    // The online estimate of the over-relaxation factor of the SOR type solvers.
+    AdaptiveOmegaData adaptiveOmegaData;
+
+    // The last pressure solutions for computing the initial guess of the iterative solvers for the PPE.
+    PressureHistoryCpp pressureHistory;
 };
 
 
+}
+
 #endif //CFD3D_CFDSOLVERCPP_HPP
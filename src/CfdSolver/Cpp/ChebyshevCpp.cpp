@@ -0,0 +1,294 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "ChebyshevCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Returns the number of eigenvalues of the symmetric tridiagonal matrix (alpha, beta) smaller than x.
+ */
+static int countEigenvaluesBelow(const std::vector<double> &alpha, const std::vector<double> &beta, double x) {
+    int count = 0;
+    double q = 1.0;
+    for (size_t l = 0; l < alpha.size(); l++) {
+        q = alpha[l] - x - (l == 0 ? 0.0 : beta[l-1]*beta[l-1] / q);
+        if (q == 0.0) {
+            q = 1e-300;
+        }
+        if (q < 0.0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+double computeSmallestRitzValue(const std::vector<double> &alpha, const std::vector<double> &beta, double threshold) {
+    const int n = int(alpha.size());
+    const int index = countEigenvaluesBelow(alpha, beta, threshold);
+    if (index >= n) {
+        return -1.0;
+    }
+
+    // Gershgorin bound as the upper end of the bisection interval.
+    double upper = threshold;
+    for (int l = 0; l < n; l++) {
+        double radius = (l > 0 ? std::abs(beta[l-1]) : 0.0) + (l < n-1 ? std::abs(beta[l]) : 0.0);
+        upper = std::max(upper, alpha[l] + radius);
+    }
+    double lower = threshold;
+    for (int bisectionStep = 0; bisectionStep < 100; bisectionStep++) {
+        double middle = 0.5 * (lower + upper);
+        if (countEigenvaluesBelow(alpha, beta, middle) > index) {
+            upper = middle;
+        } else {
+            lower = middle;
+        }
+    }
+    return 0.5 * (lower + upper);
+}
+
+/**
+ * Computes the inner product x^T D y with the diagonal D of the pressure operator (fluid cells only).
+ */
+static double diagonalInnerProductCpp(
+        int imax, int jmax, int kmax, const Real *X, const Real *Y, const Real *diagonalInverse) {
+    double innerProduct = 0.0;
+    #pragma omp parallel for reduction(+: innerProduct)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    innerProduct += double(X[IDXP(i,j,k)]) * double(Y[IDXP(i,j,k)])
+                            / double(diagonalInverse[IDXP(i,j,k)]);
+                }
+            }
+        }
+    }
+    return innerProduct;
+}
+
+/**
+ * Removes the component of X in the null space of the operator (i.e., the constant vector on all fluid cells) with
+ * respect to the inner product weighted by the diagonal.
+ */
+static void removeNullSpaceComponentCpp(int imax, int jmax, int kmax, Real *X, const Real *diagonalInverse) {
+    double weightedSum = 0.0, weightSum = 0.0;
+    #pragma omp parallel for reduction(+: weightedSum, weightSum)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    weightedSum += double(X[IDXP(i,j,k)]) / double(diagonalInverse[IDXP(i,j,k)]);
+                    weightSum += 1.0 / double(diagonalInverse[IDXP(i,j,k)]);
+                }
+            }
+        }
+    }
+    if (weightSum <= 0.0) {
+        return;
+    }
+    const Real mean = Real(weightedSum / weightSum);
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    X[IDXP(i,j,k)] -= mean;
+                }
+            }
+        }
+    }
+}
+
+void createChebyshevDataCpp(
+        int imax, int jmax, int kmax, PressureOperatorCpp &pressureOperator, ChebyshevDataCpp &chebyshevData) {
+    const int size = (imax+2)*(jmax+2)*(kmax+2);
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+
+    chebyshevData.D = new Real[size];
+    memset(chebyshevData.D, 0, sizeof(Real)*size);
+
+    // Lanczos iteration for the operator D^-1 A, which is self-adjoint with respect to the inner product x^T D y.
+    Real *V = new Real[size];
+    Real *V_old = new Real[size];
+    Real *W = new Real[size];
+    memset(V, 0, sizeof(Real)*size);
+    memset(V_old, 0, sizeof(Real)*size);
+    memset(W, 0, sizeof(Real)*size);
+
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    V[IDXP(i,j,k)] = lanczosStartValue(i, j, k);
+                }
+            }
+        }
+    }
+    removeNullSpaceComponentCpp(imax, jmax, kmax, V, diagonalInverse);
+    double norm = std::sqrt(diagonalInnerProductCpp(imax, jmax, kmax, V, V, diagonalInverse));
+
+    std::vector<double> alpha, beta;
+    const int numSteps = std::min(CHEBYSHEV_LANCZOS_STEPS, pressureOperator.numFluidCells - 1);
+    for (int step = 0; step < numSteps && norm > 0.0; step++) {
+        const Real normInverse = Real(1.0 / norm);
+        #pragma omp parallel for
+        for (int idx = 0; idx < size; idx++) {
+            V[idx] *= normInverse;
+        }
+
+        // W = D^-1 A V and alpha = V^T A V. A is the negative Laplace operator.
+        double vav = 0.0;
+        #pragma omp parallel for reduction(+: vav)
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                    const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                    const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                    Real av = (cR + cL + cU + cD + cF + cB)*V[IDXP(i,j,k)]
+                            - cR*V[IDXP(i+1,j,k)] - cL*V[IDXP(i-1,j,k)]
+                            - cU*V[IDXP(i,j+1,k)] - cD*V[IDXP(i,j-1,k)]
+                            - cF*V[IDXP(i,j,k+1)] - cB*V[IDXP(i,j,k-1)];
+                    W[IDXP(i,j,k)] = diagonalInverse[IDXP(i,j,k)] * av;
+                    vav += double(V[IDXP(i,j,k)]) * double(av);
+                }
+            }
+        }
+        alpha.push_back(vav);
+        if (step == numSteps - 1) {
+            break;
+        }
+
+        const Real a = Real(vav), b = beta.empty() ? Real(0.0) : Real(beta.back());
+        #pragma omp parallel for
+        for (int idx = 0; idx < size; idx++) {
+            W[idx] -= a * V[idx] + b * V_old[idx];
+        }
+        // Rounding errors would otherwise let the null space reappear as a zero Ritz value.
+        removeNullSpaceComponentCpp(imax, jmax, kmax, W, diagonalInverse);
+        norm = std::sqrt(diagonalInnerProductCpp(imax, jmax, kmax, W, W, diagonalInverse));
+        if (norm <= 1e-10 * std::abs(vav)) {
+            break;
+        }
+        beta.push_back(norm);
+
+        Real *temp = V_old;
+        V_old = V;
+        V = W;
+        W = temp;
+    }
+
+    delete[] V;
+    delete[] V_old;
+    delete[] W;
+
+    // Ritz values below the threshold belong to the null spaces of further disconnected fluid regions.
+    chebyshevData.lambdaMax = Real(2.0);
+    double lambdaMin = alpha.empty() ? -1.0 : computeSmallestRitzValue(alpha, beta, 1e-7);
+    // Without a usable estimate (e.g., for tiny domains), the interval [1, 2] is used, which still contains the dominant
+    // high-frequency part of the spectrum.
+    if (lambdaMin <= 0.0 || lambdaMin >= 1.0) {
+        lambdaMin = 1.0;
+    }
+    chebyshevData.lambdaMin = Real(lambdaMin);
+}
+
+void destroyChebyshevDataCpp(ChebyshevDataCpp &chebyshevData) {
+    delete[] chebyshevData.D;
+    chebyshevData = ChebyshevDataCpp();
+}
+
+void chebyshevSolverCpp(
+        Real eps, int itermax, int residualCheckInterval, int imax, int jmax, int kmax, Real *P, Real *RS,
+        PressureOperatorCpp &pressureOperator, ChebyshevDataCpp &chebyshevData, Real &residual, int &it) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    Real *D = chebyshevData.D;
+
+    const Real theta = (chebyshevData.lambdaMax + chebyshevData.lambdaMin) / Real(2.0);
+    const Real delta = (chebyshevData.lambdaMax - chebyshevData.lambdaMin) / Real(2.0);
+    const Real sigma = theta / delta;
+    const int checkInterval = std::max(residualCheckInterval, CHEBYSHEV_RESIDUAL_CHECK_INTERVAL);
+    Real rho = Real(1.0) / sigma;
+
+    for (int chebyshevIt = 0; it < itermax && residual > eps; chebyshevIt++) {
+        // d_0 = z_0 / theta, d_k = rho_k rho_(k-1) d_(k-1) + 2 rho_k / delta z_k with z_k = D^-1 (b - A x_k).
+        Real directionFactor = Real(0.0), residualFactor = Real(1.0) / theta;
+        if (chebyshevIt > 0) {
+            Real rhoNew = Real(1.0) / (Real(2.0) * sigma - rho);
+            directionFactor = rhoNew * rho;
+            residualFactor = Real(2.0) * rhoNew / delta;
+            rho = rhoNew;
+        }
+
+        const bool checkResidual = (it + 1) % checkInterval == 0 || it + 1 == itermax;
+        Real residualSum = Real(0.0);
+        #pragma omp parallel for reduction(+: residualSum)
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    Real r = computeCellResidualPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P, P, RS, coeffR, coeffU, coeffF);
+                    if (checkResidual) {
+                        residualSum += r*r;
+                    }
+                    D[IDXP(i,j,k)] = directionFactor * D[IDXP(i,j,k)]
+                            + residualFactor * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+
+        #pragma omp parallel for
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    P[IDXP(i,j,k)] += D[IDXP(i,j,k)];
+                }
+            }
+        }
+        it++;
+
+        if (checkResidual) {
+            residual = pressureOperator.numFluidCells == 0 ?
+                    Real(0.0) : std::sqrt(residualSum/pressureOperator.numFluidCells);
+        }
+    }
+}
+
+}
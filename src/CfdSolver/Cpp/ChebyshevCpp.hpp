@@ -0,0 +1,110 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_CHEBYSHEVCPP_HPP
+#define CFD3D_CHEBYSHEVCPP_HPP
+
+#include <vector>
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The number of Lanczos steps used for estimating the smallest non-zero eigenvalue of the Jacobi preconditioned
+ * operator. The smallest Ritz value overestimates the eigenvalue. This is safe (the iteration never diverges) and in
+ * practice even favorable, as the few iterations per time step then focus on the high-frequency error components,
+ * which dominate the residual.
+ */
+const int CHEBYSHEV_LANCZOS_STEPS = 50;
+
+/**
+ * The minimum number of iterations after which the Chebyshev solver checks the convergence. The iterations themselves
+ * need no dot products, so the residual norm is the only global reduction.
+ */
+const int CHEBYSHEV_RESIDUAL_CHECK_INTERVAL = 10;
+
+/**
+ * Data of the Chebyshev semi-iterative solver, which accelerates the Jacobi iteration using the bounds of the spectrum
+ * of D^-1 A (A: negative discrete Laplace operator with folded boundary conditions, D: its diagonal).
+ * The eigenvalues of D^-1 A lie in [0, 2] (Gershgorin), and 2 is attained by the checkerboard mode of a Neumann
+ * problem on the (bipartite) grid. Thus, only the smallest non-zero eigenvalue needs to be estimated, which is done
+ * once with a few Lanczos steps when the solver is created (i.e., whenever the geometry changes).
+ */
+struct ChebyshevDataCpp {
+    // The bounds of the spectrum of D^-1 A without the null space of the operator.
+    Real lambdaMin = Real(0.0), lambdaMax = Real(0.0);
+    // The update direction of the last iteration (pressure array size).
+    Real *D = nullptr;
+};
+
+/**
+ * Returns a deterministic pseudo-random value in [-0.5, 0.5) for the global cell index (i,j,k). It is used as the
+ * start vector of the Lanczos iteration, such that the estimated bounds don't depend on the domain decomposition.
+ */
+inline Real lanczosStartValue(int i, int j, int k) {
+    unsigned int hash = unsigned(i)*73856093u ^ unsigned(j)*19349663u ^ unsigned(k)*83492791u;
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    hash ^= hash >> 15;
+    return Real(hash % 2048u) / Real(2048.0) - Real(0.5);
+}
+
+/**
+ * Computes the smallest eigenvalue larger than threshold of the symmetric tridiagonal Lanczos matrix with the diagonal
+ * alpha and the off-diagonal beta (beta[l] couples l and l+1) using bisection with Sturm sequences.
+ * @return The eigenvalue or a negative value if no eigenvalue is larger than threshold.
+ */
+double computeSmallestRitzValue(const std::vector<double> &alpha, const std::vector<double> &beta, double threshold);
+
+/**
+ * Allocates the work array of the Chebyshev solver and estimates the spectral bounds of the pressure operator.
+ */
+void createChebyshevDataCpp(
+        int imax, int jmax, int kmax, PressureOperatorCpp &pressureOperator, ChebyshevDataCpp &chebyshevData);
+
+/**
+ * Frees the memory allocated by createChebyshevDataCpp.
+ */
+void destroyChebyshevDataCpp(ChebyshevDataCpp &chebyshevData);
+
+/**
+ * Solves the PPE using the Chebyshev semi-iterative method with a Jacobi preconditioner. RS needs to be zero in all
+ * non-fluid cells (@see maskRsPressureOperatorCpp). The boundary values of P are not set.
+ * @param residualCheckInterval The number of iterations after which the convergence is checked (at least
+ * CHEBYSHEV_RESIDUAL_CHECK_INTERVAL).
+ * @param residual The residual at the last convergence check.
+ * @param it The number of iterations performed.
+ */
+void chebyshevSolverCpp(
+        Real eps, int itermax, int residualCheckInterval, int imax, int jmax, int kmax, Real *P, Real *RS,
+        PressureOperatorCpp &pressureOperator, ChebyshevDataCpp &chebyshevData, Real &residual, int &it);
+
+}
+
+#endif //CFD3D_CHEBYSHEVCPP_HPP
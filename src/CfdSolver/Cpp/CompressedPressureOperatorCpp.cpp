@@ -0,0 +1,265 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "../Flag.hpp"
+#include "SorSolverCpp.hpp"
+#include "CompressedPressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+bool isCompressedPressureOperatorApplicableCpp(
+        LinearSystemSolverType linearSystemSolverType, int imax, int jmax, int kmax, FlagType *Flag) {
+    if (linearSystemSolverType != LINEAR_SOLVER_JACOBI && linearSystemSolverType != LINEAR_SOLVER_SOR
+            && linearSystemSolverType != LINEAR_SOLVER_GAUSS_SEIDEL) {
+        return false;
+    }
+
+    int numFluidCells = 0;
+    #pragma omp parallel for reduction(+: numFluidCells)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    numFluidCells++;
+                }
+            }
+        }
+    }
+    return Real(numFluidCells) <= COMPRESSED_PRESSURE_OPERATOR_MAX_FLUID_FRACTION * Real(imax*jmax*kmax);
+}
+
+void createCompressedPressureOperatorCpp(
+        int imax, int jmax, int kmax, FlagType *Flag, const PressureOperatorCpp &pressureOperator, Real *P,
+        CompressedPressureOperatorCpp &compressedOperator) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+
+    // Number the fluid cells in lexicographic order, such that the SOR sweeps visit them in the same order as the sweeps
+    // over the whole domain.
+    std::vector<int> compactIndices((imax+2)*(jmax+2)*(kmax+2), -1);
+    std::vector<int> cellIndices, rsIndices;
+    std::vector<int> boundaryCellIndices, boundaryNeighborOffsets, boundaryNeighbors;
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                const FlagType flag = Flag[IDXFLAG(i,j,k)];
+                if (isFluid(flag)) {
+                    compactIndices[IDXP(i,j,k)] = int(cellIndices.size());
+                    cellIndices.push_back(IDXP(i,j,k));
+                    rsIndices.push_back(IDXRS(i,j,k));
+                    continue;
+                }
+
+                // The same neighbors in the same order as in setPressureBoundaryValuesCpp.
+                const int firstNeighbor = int(boundaryNeighbors.size());
+                if (B_R(flag)) {
+                    boundaryNeighbors.push_back(IDXP(i+1,j,k));
+                }
+                if (B_L(flag)) {
+                    boundaryNeighbors.push_back(IDXP(i-1,j,k));
+                }
+                if (B_U(flag)) {
+                    boundaryNeighbors.push_back(IDXP(i,j+1,k));
+                }
+                if (B_D(flag)) {
+                    boundaryNeighbors.push_back(IDXP(i,j-1,k));
+                }
+                if (B_B(flag)) {
+                    boundaryNeighbors.push_back(IDXP(i,j,k-1));
+                }
+                if (B_F(flag)) {
+                    boundaryNeighbors.push_back(IDXP(i,j,k+1));
+                }
+                if (int(boundaryNeighbors.size()) == firstNeighbor) {
+                    P[IDXP(i,j,k)] = Real(0.0);
+                } else {
+                    boundaryCellIndices.push_back(IDXP(i,j,k));
+                    boundaryNeighborOffsets.push_back(firstNeighbor);
+                }
+            }
+        }
+    }
+    boundaryNeighborOffsets.push_back(int(boundaryNeighbors.size()));
+
+    const int n = int(cellIndices.size());
+    compressedOperator.numFluidCells = n;
+    compressedOperator.cellIndices = new int[n];
+    compressedOperator.rsIndices = new int[n];
+    compressedOperator.neighbors = new int[6*n];
+    compressedOperator.coefficients = new Real[6*n];
+    compressedOperator.diagonal = new Real[n];
+    compressedOperator.diagonalInverse = new Real[n];
+    compressedOperator.X = new Real[n+1];
+    compressedOperator.X_temp = new Real[n+1];
+    compressedOperator.B = new Real[n];
+    compressedOperator.X[n] = Real(0.0);
+    compressedOperator.X_temp[n] = Real(0.0);
+
+    #pragma omp parallel for
+    for (int c = 0; c < n; c++) {
+        const int idx = cellIndices[c];
+        compressedOperator.cellIndices[c] = idx;
+        compressedOperator.rsIndices[c] = rsIndices[c];
+
+        const int neighborIndices[6] = {
+                idx + (jmax+2)*(kmax+2), idx - (jmax+2)*(kmax+2), idx + (kmax+2), idx - (kmax+2), idx + 1, idx - 1 };
+        const Real neighborCoefficients[6] = {
+                coeffR[idx], coeffR[neighborIndices[1]], coeffU[idx], coeffU[neighborIndices[3]],
+                coeffF[idx], coeffF[neighborIndices[5]] };
+        for (int d = 0; d < 6; d++) {
+            const int compactIndex = compactIndices[neighborIndices[d]];
+            compressedOperator.neighbors[6*c + d] = compactIndex >= 0 ? compactIndex : n;
+            compressedOperator.coefficients[6*c + d] = neighborCoefficients[d];
+        }
+
+        // Same summation order as in computeCellResidualPressureOperatorCpp.
+        const Real cR = neighborCoefficients[0], cL = neighborCoefficients[1];
+        const Real cU = neighborCoefficients[2], cD = neighborCoefficients[3];
+        const Real cF = neighborCoefficients[4], cB = neighborCoefficients[5];
+        compressedOperator.diagonal[c] = cR + cL + cU + cD + cF + cB;
+        compressedOperator.diagonalInverse[c] = pressureOperator.diagonalInverse[idx];
+    }
+
+    const int numBoundaryCells = int(boundaryCellIndices.size());
+    compressedOperator.numBoundaryCells = numBoundaryCells;
+    compressedOperator.boundaryCellIndices = new int[numBoundaryCells];
+    compressedOperator.boundaryNeighborOffsets = new int[numBoundaryCells+1];
+    compressedOperator.boundaryNeighbors = new int[boundaryNeighbors.size()];
+    std::copy(boundaryCellIndices.begin(), boundaryCellIndices.end(), compressedOperator.boundaryCellIndices);
+    std::copy(
+            boundaryNeighborOffsets.begin(), boundaryNeighborOffsets.end(),
+            compressedOperator.boundaryNeighborOffsets);
+    std::copy(boundaryNeighbors.begin(), boundaryNeighbors.end(), compressedOperator.boundaryNeighbors);
+}
+
+void destroyCompressedPressureOperatorCpp(CompressedPressureOperatorCpp &compressedOperator) {
+    delete[] compressedOperator.cellIndices;
+    delete[] compressedOperator.rsIndices;
+    delete[] compressedOperator.neighbors;
+    delete[] compressedOperator.coefficients;
+    delete[] compressedOperator.diagonal;
+    delete[] compressedOperator.diagonalInverse;
+    delete[] compressedOperator.X;
+    delete[] compressedOperator.X_temp;
+    delete[] compressedOperator.B;
+    delete[] compressedOperator.boundaryCellIndices;
+    delete[] compressedOperator.boundaryNeighborOffsets;
+    delete[] compressedOperator.boundaryNeighbors;
+    compressedOperator = CompressedPressureOperatorCpp();
+}
+
+void gatherCompressedPressureCpp(
+        const Real *P, const Real *RS, CompressedPressureOperatorCpp &compressedOperator) {
+    const int n = compressedOperator.numFluidCells;
+    #pragma omp parallel for
+    for (int c = 0; c < n; c++) {
+        compressedOperator.X[c] = P[compressedOperator.cellIndices[c]];
+        compressedOperator.B[c] = RS[compressedOperator.rsIndices[c]];
+    }
+}
+
+void scatterCompressedPressureCpp(Real *P, const CompressedPressureOperatorCpp &compressedOperator) {
+    const int n = compressedOperator.numFluidCells;
+    #pragma omp parallel for
+    for (int c = 0; c < n; c++) {
+        P[compressedOperator.cellIndices[c]] = compressedOperator.X[c];
+    }
+}
+
+/**
+ * Returns the residual of the fluid cell with the compact index c, where the neighbor values are read from X_neighbor
+ * and the value of the cell itself from X_center.
+ */
+inline Real computeCellResidualCompressedCpp(
+        int c, const Real *X_neighbor, const Real *X_center, const Real *B,
+        const int *neighbors, const Real *coefficients, const Real *diagonal) {
+    const int *nb = neighbors + 6*c;
+    const Real *coeff = coefficients + 6*c;
+    return coeff[0]*X_neighbor[nb[0]] + coeff[1]*X_neighbor[nb[1]]
+            + coeff[2]*X_neighbor[nb[2]] + coeff[3]*X_neighbor[nb[3]]
+            + coeff[4]*X_neighbor[nb[4]] + coeff[5]*X_neighbor[nb[5]]
+            - B[c] - diagonal[c]*X_center[c];
+}
+
+Real compressedPressureOperatorSweepCpp(
+        Real omg, LinearSystemSolverType linearSystemSolverType, CompressedPressureOperatorCpp &compressedOperator) {
+    const int n = compressedOperator.numFluidCells;
+    const int *neighbors = compressedOperator.neighbors;
+    const Real *coefficients = compressedOperator.coefficients;
+    const Real *diagonal = compressedOperator.diagonal;
+    const Real *diagonalInverse = compressedOperator.diagonalInverse;
+    const Real *B = compressedOperator.B;
+    Real *X = compressedOperator.X;
+    Real *X_temp = compressedOperator.X_temp;
+    Real residual = Real(0.0);
+
+    if (linearSystemSolverType == LINEAR_SOLVER_JACOBI) {
+        #pragma omp parallel for reduction(+: residual)
+        for (int c = 0; c < n; c++) {
+            Real r = computeCellResidualCompressedCpp(c, X, X, B, neighbors, coefficients, diagonal);
+            residual += r*r;
+            X_temp[c] = X[c] + omg * diagonalInverse[c] * r;
+        }
+        std::swap(compressedOperator.X, compressedOperator.X_temp);
+    } else {
+        for (int c = 0; c < n; c++) {
+            Real r = computeCellResidualCompressedCpp(c, X, X, B, neighbors, coefficients, diagonal);
+            residual += r*r;
+            X[c] += omg * diagonalInverse[c] * r;
+        }
+    }
+
+    // The residual is normalized by dividing by the total number of fluid cells.
+    if (n == 0) {
+        return Real(0.0);
+    }
+    return std::sqrt(residual/n);
+}
+
+void setPressureBoundaryValuesCompressedCpp(
+        int imax, int jmax, int kmax, Real *P, const CompressedPressureOperatorCpp &compressedOperator) {
+    setPressureDomainBoundaryValuesCpp(imax, jmax, kmax, P);
+
+    const int *offsets = compressedOperator.boundaryNeighborOffsets;
+    const int *boundaryNeighbors = compressedOperator.boundaryNeighbors;
+    #pragma omp parallel for
+    for (int b = 0; b < compressedOperator.numBoundaryCells; b++) {
+        Real P_temp = Real(0);
+        for (int l = offsets[b]; l < offsets[b+1]; l++) {
+            P_temp += P[boundaryNeighbors[l]];
+        }
+        P[compressedOperator.boundaryCellIndices[b]] = P_temp / Real(offsets[b+1] - offsets[b]);
+    }
+}
+
+}
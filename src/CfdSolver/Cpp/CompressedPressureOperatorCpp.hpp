@@ -0,0 +1,120 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_COMPRESSEDPRESSUREOPERATORCPP_HPP
+#define CFD3D_COMPRESSEDPRESSUREOPERATORCPP_HPP
+
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The compressed operator is used by the Jacobi and SOR solvers if at most this fraction of the interior cells are
+ * fluid cells. For (nearly) obstacle free domains, the indirect addressing costs more than skipping the obstacles saves.
+ */
+const Real COMPRESSED_PRESSURE_OPERATOR_MAX_FLUID_FRACTION = Real(0.75);
+
+/**
+ * The pressure operator restricted to the fluid cells. The unknowns of the PPE are stored in a compact vector with one
+ * entry per fluid cell (in lexicographic order) and one trailing entry that is always zero. Non-fluid neighbors of a
+ * cell refer to this entry, and their coefficient is zero. Thus, the relaxation sweeps only touch fluid cells, and their
+ * work scales with the fluid volume instead of the volume of the bounding box of the domain.
+ * The boundary values of the obstacle cells next to fluid cells are set using a list of these cells and their fluid
+ * neighbors. The remaining obstacle cells have no fluid neighbors, and their pressure value is always zero.
+ */
+struct CompressedPressureOperatorCpp {
+    int numFluidCells = 0;
+    // The index of each fluid cell in the pressure array (IDXP) and the right-hand side array (IDXRS).
+    int *cellIndices = nullptr, *rsIndices = nullptr;
+    // Six entries per fluid cell: The compact indices and coefficients of the neighbors (i+1,j,k), (i-1,j,k), (i,j+1,k),
+    // (i,j-1,k), (i,j,k+1) and (i,j,k-1).
+    int *neighbors = nullptr;
+    Real *coefficients = nullptr;
+    // The diagonal entry (i.e., the sum of the six neighbor coefficients) and its inverse (zero for isolated cells).
+    Real *diagonal = nullptr, *diagonalInverse = nullptr;
+    // The compact unknown vectors (numFluidCells + 1 entries, X_temp only used by the Jacobi solver) and the compact
+    // right-hand side.
+    Real *X = nullptr, *X_temp = nullptr, *B = nullptr;
+
+    // The obstacle cells next to fluid cells. The fluid neighbors of boundary cell b are the pressure array indices
+    // boundaryNeighbors[boundaryNeighborOffsets[b]] to boundaryNeighbors[boundaryNeighborOffsets[b+1]-1].
+    int numBoundaryCells = 0;
+    int *boundaryCellIndices = nullptr, *boundaryNeighborOffsets = nullptr, *boundaryNeighbors = nullptr;
+};
+
+/**
+ * Returns whether the compressed operator should be used for the passed solver type and geometry (i.e., whether the
+ * solver is a Jacobi or lexicographic SOR/Gauss-Seidel solver and the domain contains enough obstacle cells).
+ */
+bool isCompressedPressureOperatorApplicableCpp(
+        LinearSystemSolverType linearSystemSolverType, int imax, int jmax, int kmax, FlagType *Flag);
+
+/**
+ * Builds the compressed operator from the pressure operator, such that both yield bitwise identical residuals. The
+ * pressure values of all obstacle cells without fluid neighbors are set to zero in P once.
+ */
+void createCompressedPressureOperatorCpp(
+        int imax, int jmax, int kmax, FlagType *Flag, const PressureOperatorCpp &pressureOperator, Real *P,
+        CompressedPressureOperatorCpp &compressedOperator);
+
+/**
+ * Frees the memory allocated by createCompressedPressureOperatorCpp.
+ */
+void destroyCompressedPressureOperatorCpp(CompressedPressureOperatorCpp &compressedOperator);
+
+/**
+ * Copies the pressure values and the right-hand side of the fluid cells to the compact vectors X and B.
+ */
+void gatherCompressedPressureCpp(
+        const Real *P, const Real *RS, CompressedPressureOperatorCpp &compressedOperator);
+
+/**
+ * Copies the compact vector X back to the fluid cells of the pressure array.
+ */
+void scatterCompressedPressureCpp(Real *P, const CompressedPressureOperatorCpp &compressedOperator);
+
+/**
+ * Performs one Jacobi or lexicographic SOR sweep on the compact vector X. The updates and the residual are bitwise
+ * identical to pressureOperatorSweepCpp (up to the order of the parallel residual reduction of the Jacobi solver).
+ * The Jacobi solver swaps X and X_temp instead of copying the values.
+ * @return The residual normalized by the number of fluid cells.
+ */
+Real compressedPressureOperatorSweepCpp(
+        Real omg, LinearSystemSolverType linearSystemSolverType, CompressedPressureOperatorCpp &compressedOperator);
+
+/**
+ * Sets the pressure values in the ghost cells and in the obstacle cells next to fluid cells. The result is identical
+ * to setPressureBoundaryValuesCpp, but only the boundary cells in the list of the compressed operator are visited.
+ */
+void setPressureBoundaryValuesCompressedCpp(
+        int imax, int jmax, int kmax, Real *P, const CompressedPressureOperatorCpp &compressedOperator);
+
+}
+
+#endif //CFD3D_COMPRESSEDPRESSUREOPERATORCPP_HPP
@@ -0,0 +1,295 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include "../Flag.hpp"
+#include "SorSolverCpp.hpp"
+#include "ConjugateGradientCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createConjugateGradientDataCpp(int imax, int jmax, int kmax, ConjugateGradientDataCpp &cgData) {
+    const int size = (imax+2)*(jmax+2)*(kmax+2);
+    cgData.R = new Real[size];
+    cgData.Z = new Real[size];
+    cgData.S = new Real[size];
+    cgData.Q = new Real[size];
+    memset(cgData.R, 0, sizeof(Real)*size);
+    memset(cgData.Z, 0, sizeof(Real)*size);
+    memset(cgData.S, 0, sizeof(Real)*size);
+    memset(cgData.Q, 0, sizeof(Real)*size);
+}
+
+void destroyConjugateGradientDataCpp(ConjugateGradientDataCpp &cgData) {
+    delete[] cgData.R;
+    delete[] cgData.Z;
+    delete[] cgData.S;
+    delete[] cgData.Q;
+    cgData = ConjugateGradientDataCpp();
+}
+
+/**
+ * Computes Q = A*S for the negative Laplace operator A and returns the dot product S*Q. The boundary conditions are
+ * part of the operator coefficients, so no boundary values of S need to be set.
+ */
+Real applyPressureOperatorCpp(
+        int imax, int jmax, int kmax, Real *S, Real *Q, FlagType *Flag, PressureOperatorCpp &pressureOperator) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    Real sq = Real(0.0);
+    #pragma omp parallel for reduction(+: sq)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                    const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                    const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                    Real q = (cR + cL + cU + cD + cF + cB)*S[IDXP(i,j,k)]
+                            - cR*S[IDXP(i+1,j,k)] - cL*S[IDXP(i-1,j,k)]
+                            - cU*S[IDXP(i,j+1,k)] - cD*S[IDXP(i,j-1,k)]
+                            - cF*S[IDXP(i,j,k+1)] - cB*S[IDXP(i,j,k-1)];
+                    Q[IDXP(i,j,k)] = q;
+                    sq += S[IDXP(i,j,k)] * q;
+                }
+            }
+        }
+    }
+    return sq;
+}
+
+/**
+ * Performs a Gauss-Seidel sweep for solving A*Z = R over all fluid cells with (i+j+k) % 2 == color and returns the dot
+ * product R*Z over these cells. The operator doesn't couple to non-fluid cells, so the preconditioner stays symmetric.
+ */
+Real redBlackGaussSeidelSweepCpp(
+        int color, int imax, int jmax, int kmax, Real *R, Real *Z, FlagType *Flag,
+        PressureOperatorCpp &pressureOperator) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    Real rz = Real(0.0);
+    #pragma omp parallel for reduction(+: rz)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1 + (i + j + 1 + color) % 2; k <= kmax; k += 2) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    Real z = (R[IDXP(i,j,k)]
+                              + coeffR[IDXP(i,j,k)]*Z[IDXP(i+1,j,k)] + coeffR[IDXP(i-1,j,k)]*Z[IDXP(i-1,j,k)]
+                              + coeffU[IDXP(i,j,k)]*Z[IDXP(i,j+1,k)] + coeffU[IDXP(i,j-1,k)]*Z[IDXP(i,j-1,k)]
+                              + coeffF[IDXP(i,j,k)]*Z[IDXP(i,j,k+1)] + coeffF[IDXP(i,j,k-1)]*Z[IDXP(i,j,k-1)])
+                            * diagonalInverse[IDXP(i,j,k)];
+                    Z[IDXP(i,j,k)] = z;
+                    rz += R[IDXP(i,j,k)] * z;
+                }
+            }
+        }
+    }
+    return rz;
+}
+
+/**
+ * Applies the symmetric Gauss-Seidel preconditioner (Z = M^-1 R) and returns the dot product R*Z. Starting from Z = 0,
+ * a forward sweep (red, black) followed by a backward sweep (black, red) reduces to three half sweeps, as the second
+ * black sweep would reproduce the values of the first one.
+ */
+Real applySgsPreconditionerCpp(
+        int imax, int jmax, int kmax, Real *R, Real *Z, FlagType *Flag, PressureOperatorCpp &pressureOperator) {
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1 + (i + j + 1) % 2; k <= kmax; k += 2) {
+                Z[IDXP(i,j,k)] = R[IDXP(i,j,k)] * diagonalInverse[IDXP(i,j,k)];
+            }
+        }
+    }
+    Real rz = redBlackGaussSeidelSweepCpp(1, imax, jmax, kmax, R, Z, Flag, pressureOperator);
+    rz += redBlackGaussSeidelSweepCpp(0, imax, jmax, kmax, R, Z, Flag, pressureOperator);
+    return rz;
+}
+
+/**
+ * Computes the residual R = -RS - A*P of the fluid cells with the mean removed and returns the squared norm R*R.
+ * rz is set to the dot product of R with the Jacobi preconditioned residual.
+ *
+ * In exact arithmetic, the residual has a mean of zero. Due to rounding errors, a constant part builds up, which lies
+ * in the null space of the operator. CG can't reduce it and diverges (especially in float precision) if it is kept.
+ */
+static Real computeResidualConjugateGradientCpp(
+        int imax, int jmax, int kmax, Real *P, Real *RS, Real *R, FlagType *Flag,
+        PressureOperatorCpp &pressureOperator, Real &rz) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+
+    Real rSum = Real(0.0);
+    #pragma omp parallel for reduction(+: rSum)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    Real r = computeCellResidualPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P, P, RS, coeffR, coeffU, coeffF);
+                    R[IDXP(i,j,k)] = r;
+                    rSum += r;
+                }
+            }
+        }
+    }
+
+    const Real rMean = rSum / Real(pressureOperator.numFluidCells);
+    Real rr = Real(0.0);
+    rz = Real(0.0);
+    #pragma omp parallel for reduction(+: rr) reduction(+: rz)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    Real r = R[IDXP(i,j,k)] - rMean;
+                    R[IDXP(i,j,k)] = r;
+                    rr += r * r;
+                    rz += r * r * diagonalInverse[IDXP(i,j,k)];
+                }
+            }
+        }
+    }
+    return rr;
+}
+
+void conjugateGradientSolverCpp(
+        Real eps, int itermax, bool useSgsPreconditioner, int imax, int jmax, int kmax,
+        Real *P, Real *RS, FlagType *Flag, PressureOperatorCpp &pressureOperator, ConjugateGradientDataCpp &cgData,
+        Real &residual, int &it) {
+    Real *R = cgData.R, *Z = cgData.Z, *S = cgData.S, *Q = cgData.Q;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    const int numFluidCells = pressureOperator.numFluidCells;
+    if (numFluidCells == 0) {
+        residual = Real(0.0);
+        return;
+    }
+
+    // The system is solved in the form A*P = -RS with the positive semi-definite operator A = -Laplace.
+    subtractMeanRsCpp(imax, jmax, kmax, RS, Flag);
+
+    Real rz;
+    Real rr = computeResidualConjugateGradientCpp(imax, jmax, kmax, P, RS, R, Flag, pressureOperator, rz);
+    residual = std::sqrt(rr / numFluidCells);
+    if (useSgsPreconditioner && residual > eps) {
+        rz = applySgsPreconditionerCpp(imax, jmax, kmax, R, Z, Flag, pressureOperator);
+    }
+
+    // The mean of the updated residual is removed with a lag of one iteration (the initial residual has none).
+    Real rMean = Real(0.0);
+    Real beta = Real(0.0);
+    while (it < itermax && residual > eps) {
+        // Update the search direction. The Jacobi preconditioner is applied on the fly.
+        if (useSgsPreconditioner) {
+            #pragma omp parallel for
+            for (int i = 1; i <= imax; i++) {
+                for (int j = 1; j <= jmax; j++) {
+                    for (int k = 1; k <= kmax; k++) {
+                        if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                            S[IDXP(i,j,k)] = Z[IDXP(i,j,k)] + beta * S[IDXP(i,j,k)];
+                        }
+                    }
+                }
+            }
+        } else {
+            #pragma omp parallel for
+            for (int i = 1; i <= imax; i++) {
+                for (int j = 1; j <= jmax; j++) {
+                    for (int k = 1; k <= kmax; k++) {
+                        if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                            S[IDXP(i,j,k)] = R[IDXP(i,j,k)] * diagonalInverse[IDXP(i,j,k)] + beta * S[IDXP(i,j,k)];
+                        }
+                    }
+                }
+            }
+        }
+
+        Real sq = applyPressureOperatorCpp(imax, jmax, kmax, S, Q, Flag, pressureOperator);
+        if (!(sq > Real(0.0))) {
+            // The search direction lies in the null space of the operator (or contains NaN values).
+            if (std::isnan(sq)) {
+                residual = sq;
+            }
+            break;
+        }
+        const Real alpha = rz / sq;
+
+        // Update the pressure and the residual (and apply the Jacobi preconditioner to the new residual).
+        Real rzNew = Real(0.0);
+        rr = Real(0.0);
+        Real rSum = Real(0.0);
+        #pragma omp parallel for reduction(+: rr) reduction(+: rzNew) reduction(+: rSum)
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                        P[IDXP(i,j,k)] += alpha * S[IDXP(i,j,k)];
+                        Real r = R[IDXP(i,j,k)] - alpha * Q[IDXP(i,j,k)] - rMean;
+                        R[IDXP(i,j,k)] = r;
+                        rSum += r;
+                        rr += r * r;
+                        rzNew += r * r * diagonalInverse[IDXP(i,j,k)];
+                    }
+                }
+            }
+        }
+        rMean = rSum / Real(numFluidCells);
+        residual = std::sqrt(rr / numFluidCells);
+        it++;
+
+        // The updated residual drifts away from the true residual -RS - A*P due to rounding errors (especially in
+        // float precision). Thus, convergence is only accepted if the true residual is below the tolerance, too.
+        // Otherwise, the iteration is restarted from the true residual.
+        bool isRestart = false;
+        if (residual <= eps || it >= itermax) {
+            rr = computeResidualConjugateGradientCpp(imax, jmax, kmax, P, RS, R, Flag, pressureOperator, rzNew);
+            residual = std::sqrt(rr / numFluidCells);
+            rMean = Real(0.0);
+            isRestart = true;
+        }
+
+        if (useSgsPreconditioner && residual > eps) {
+            rzNew = applySgsPreconditionerCpp(imax, jmax, kmax, R, Z, Flag, pressureOperator);
+        }
+        beta = isRestart ? Real(0.0) : rzNew / rz;
+        rz = rzNew;
+    }
+
+    // The values in the ghost cells and obstacle cells are only needed for the velocity update and the output.
+    setPressureBoundaryValuesCpp(imax, jmax, kmax, P, Flag);
+}
+
+}
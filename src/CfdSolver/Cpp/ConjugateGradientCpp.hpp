@@ -0,0 +1,78 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_CONJUGATEGRADIENTCPP_HPP
+#define CFD3D_CONJUGATEGRADIENTCPP_HPP
+
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The work arrays of the preconditioned conjugate gradient (PCG) solver. All arrays have the size of the pressure array
+ * (i.e., they include the ghost cells), as the operator and the symmetric Gauss-Seidel preconditioner access the
+ * neighbors of the boundary cells.
+ */
+struct ConjugateGradientDataCpp {
+    // Residual, preconditioned residual, search direction and operator applied to the search direction.
+    Real *R = nullptr, *Z = nullptr, *S = nullptr, *Q = nullptr;
+};
+
+/**
+ * Allocates the work arrays of the PCG solver.
+ */
+void createConjugateGradientDataCpp(int imax, int jmax, int kmax, ConjugateGradientDataCpp &cgData);
+
+/**
+ * Frees the memory allocated by createConjugateGradientDataCpp.
+ */
+void destroyConjugateGradientDataCpp(ConjugateGradientDataCpp &cgData);
+
+/**
+ * Solves the Pressure Poisson Equation (PPE) using a preconditioned conjugate gradient method.
+ * The operator is the precomputed pressure operator of the Jacobi and SOR type solvers. In contrast to the boundary
+ * values set by setPressureBoundaryValuesCpp (obstacle cells take the mean value of their fluid neighbors), its Neumann
+ * coefficients are symmetric also at obstacle corners and on anisotropic grids, which CG relies on. The dot products
+ * are computed in the same loops that update the vectors.
+ * @param eps The residual value (epsilon) for which the solution is considered as converged.
+ * @param itermax The maximum number of iterations.
+ * @param useSgsPreconditioner Whether to use a symmetric Gauss-Seidel preconditioner (true) or a Jacobi preconditioner
+ * (false). The Gauss-Seidel sweeps use a red-black ordering, such that they can be parallelized.
+ * @param pressureOperator The operator with the boundary conditions folded into the coefficients.
+ * @param residual The residual after the last iteration.
+ * @param it The number of iterations performed.
+ */
+void conjugateGradientSolverCpp(
+        Real eps, int itermax, bool useSgsPreconditioner, int imax, int jmax, int kmax,
+        Real *P, Real *RS, FlagType *Flag, PressureOperatorCpp &pressureOperator, ConjugateGradientDataCpp &cgData,
+        Real &residual, int &it);
+
+}
+
+#endif //CFD3D_CONJUGATEGRADIENTCPP_HPP
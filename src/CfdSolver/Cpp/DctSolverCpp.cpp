@@ -0,0 +1,326 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "../Flag.hpp"
+#include "SorSolverCpp.hpp"
+#include "DctSolverCpp.hpp"
+
+/**
+ * For accessing the work array of the DCT solver (which has no ghost cells) with the indices of the pressure array.
+ */
+#define IDXWORK(i,j,k) (((i)-1)*jmax*kmax + ((j)-1)*kmax + ((k)-1))
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+bool isDctSolverApplicableCpp(int imax, int jmax, int kmax, FlagType *Flag) {
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (!isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Computes the eigenvalues of the negative second difference operator with Neumann boundary conditions for n cells.
+ */
+void computeNeumannEigenvaluesCpp(int n, Real h, std::vector<double> &eigenvalues) {
+    eigenvalues.resize(n);
+    for (int m = 0; m < n; m++) {
+        eigenvalues[m] = (2.0 - 2.0 * std::cos(M_PI * m / n)) / (double(h) * double(h));
+    }
+}
+
+#ifndef USE_FFTW
+void createDctPlanCpp(int n, DctPlanCpp &plan) {
+    plan.n = n;
+    plan.factors.clear();
+    int remaining = n;
+    for (int p = 2; p * p <= remaining; p++) {
+        while (remaining % p == 0) {
+            plan.factors.push_back(p);
+            remaining /= p;
+        }
+    }
+    if (remaining > 1) {
+        plan.factors.push_back(remaining);
+    }
+
+    plan.roots.resize(n);
+    plan.shift.resize(n);
+    for (int l = 0; l < n; l++) {
+        plan.roots[l] = std::polar(1.0, -2.0 * M_PI * l / n);
+        plan.shift[l] = std::polar(1.0, -M_PI * l / (2.0 * n));
+    }
+}
+
+/**
+ * Recursive mixed radix decimation-in-time FFT of length n. The input is read with the passed stride. rootStride is
+ * the ratio of the length of the full transform and n. scratch needs to hold as many values as the largest factor.
+ */
+void fftRecursiveCpp(
+        const std::complex<double> *in, std::complex<double> *out, int n, int stride, const int *factors,
+        const std::complex<double> *roots, int rootStride, std::complex<double> *scratch) {
+    if (n == 1) {
+        out[0] = in[0];
+        return;
+    }
+
+    const int p = factors[0];
+    const int m = n / p;
+    for (int q = 0; q < p; q++) {
+        fftRecursiveCpp(in + q*stride, out + q*m, m, stride*p, factors + 1, roots, rootStride*p, scratch);
+    }
+
+    // Combine the p transforms of length m. The outputs k + s*m only depend on the inputs k + q*m.
+    for (int k = 0; k < m; k++) {
+        for (int q = 0; q < p; q++) {
+            scratch[q] = out[q*m + k];
+        }
+        for (int s = 0; s < p; s++) {
+            const int l = k + s*m;
+            std::complex<double> sum = scratch[0];
+            for (int q = 1; q < p; q++) {
+                sum += scratch[q] * roots[((q*l) % n) * rootStride];
+            }
+            out[l] = sum;
+        }
+    }
+}
+
+/**
+ * Computes the DCT-II y_l = 2 * sum_n x_n cos(pi*l*(2n+1)/(2N)) of x in place (same convention as FFTW_REDFT10).
+ * The even entries of x followed by the odd entries in reversed order are transformed with a complex FFT (Makhoul).
+ * buffer needs to hold 2*n values, scratch as many values as the largest factor of n.
+ */
+void dctForwardCpp(
+        const DctPlanCpp &plan, double *x, std::complex<double> *buffer, std::complex<double> *scratch) {
+    const int n = plan.n;
+    std::complex<double> *v = buffer;
+    std::complex<double> *V = buffer + n;
+    for (int l = 0; 2*l < n; l++) {
+        v[l] = x[2*l];
+    }
+    for (int l = 0; 2*l + 1 < n; l++) {
+        v[n-1-l] = x[2*l + 1];
+    }
+    fftRecursiveCpp(v, V, n, 1, plan.factors.data(), plan.roots.data(), 1, scratch);
+    for (int l = 0; l < n; l++) {
+        x[l] = 2.0 * (plan.shift[l] * V[l]).real();
+    }
+}
+
+/**
+ * Computes the DCT-III y_n = x_0 + 2 * sum_{l>0} x_l cos(pi*l*(2n+1)/(2N)) of x in place (same convention as
+ * FFTW_REDFT01). This is the inverse of dctForwardCpp up to a factor of 2N.
+ */
+void dctInverseCpp(
+        const DctPlanCpp &plan, double *x, std::complex<double> *buffer, std::complex<double> *scratch) {
+    const int n = plan.n;
+    std::complex<double> *V = buffer;
+    std::complex<double> *v = buffer + n;
+    // Reconstruct the FFT of the permuted sequence (conjugated, so that the forward FFT computes the inverse one).
+    V[0] = std::conj(std::conj(plan.shift[0]) * x[0]);
+    for (int l = 1; l < n; l++) {
+        V[l] = std::conj(std::conj(plan.shift[l]) * std::complex<double>(x[l], -x[n-l]));
+    }
+    fftRecursiveCpp(V, v, n, 1, plan.factors.data(), plan.roots.data(), 1, scratch);
+    for (int l = 0; 2*l < n; l++) {
+        x[2*l] = v[l].real();
+    }
+    for (int l = 0; 2*l + 1 < n; l++) {
+        x[2*l + 1] = v[n-1-l].real();
+    }
+}
+
+/**
+ * Applies the forward or inverse DCT to all lines of the work array in one direction.
+ * @param stride The distance of two consecutive values of a line in the work array.
+ * @param lineStarts The index of the first value of each line.
+ */
+void dctTransformLinesCpp(
+        const DctPlanCpp &plan, bool inverse, double *work, int stride, const std::vector<int> &lineStarts) {
+    const int n = plan.n;
+    const int numLines = int(lineStarts.size());
+    int maxFactor = 1;
+    for (int p : plan.factors) {
+        maxFactor = std::max(maxFactor, p);
+    }
+
+    #pragma omp parallel
+    {
+        std::vector<double> line(n);
+        std::vector<std::complex<double>> buffer(2*n);
+        std::vector<std::complex<double>> scratch(maxFactor);
+
+        #pragma omp for
+        for (int lineIdx = 0; lineIdx < numLines; lineIdx++) {
+            double *lineStart = work + lineStarts[lineIdx];
+            for (int l = 0; l < n; l++) {
+                line[l] = lineStart[l*stride];
+            }
+            if (inverse) {
+                dctInverseCpp(plan, line.data(), buffer.data(), scratch.data());
+            } else {
+                dctForwardCpp(plan, line.data(), buffer.data(), scratch.data());
+            }
+            for (int l = 0; l < n; l++) {
+                lineStart[l*stride] = line[l];
+            }
+        }
+    }
+}
+
+/**
+ * Applies the 3D forward or inverse DCT to the work array (one pass in each direction).
+ */
+void dctTransform3DCpp(int imax, int jmax, int kmax, bool inverse, DctSolverDataCpp &dctData) {
+    std::vector<int> lineStarts;
+
+    // Lines in z direction.
+    lineStarts.clear();
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            lineStarts.push_back(IDXWORK(i,j,1));
+        }
+    }
+    dctTransformLinesCpp(dctData.planZ, inverse, dctData.work, 1, lineStarts);
+
+    // Lines in y direction.
+    lineStarts.clear();
+    for (int i = 1; i <= imax; i++) {
+        for (int k = 1; k <= kmax; k++) {
+            lineStarts.push_back(IDXWORK(i,1,k));
+        }
+    }
+    dctTransformLinesCpp(dctData.planY, inverse, dctData.work, kmax, lineStarts);
+
+    // Lines in x direction.
+    lineStarts.clear();
+    for (int j = 1; j <= jmax; j++) {
+        for (int k = 1; k <= kmax; k++) {
+            lineStarts.push_back(IDXWORK(1,j,k));
+        }
+    }
+    dctTransformLinesCpp(dctData.planX, inverse, dctData.work, jmax*kmax, lineStarts);
+}
+#endif
+
+void createDctSolverDataCpp(Real dx, Real dy, Real dz, int imax, int jmax, int kmax, DctSolverDataCpp &dctData) {
+    const int size = imax*jmax*kmax;
+    dctData.work = new double[size];
+    memset(dctData.work, 0, sizeof(double)*size);
+
+    computeNeumannEigenvaluesCpp(imax, dx, dctData.eigenvaluesX);
+    computeNeumannEigenvaluesCpp(jmax, dy, dctData.eigenvaluesY);
+    computeNeumannEigenvaluesCpp(kmax, dz, dctData.eigenvaluesZ);
+
+#ifdef USE_FFTW
+    // FFTW_MEASURE overwrites the work array, which is not a problem here, as it is only used as temporary storage.
+    dctData.forwardPlan = fftw_plan_r2r_3d(
+            imax, jmax, kmax, dctData.work, dctData.work, FFTW_REDFT10, FFTW_REDFT10, FFTW_REDFT10, FFTW_MEASURE);
+    dctData.inversePlan = fftw_plan_r2r_3d(
+            imax, jmax, kmax, dctData.work, dctData.work, FFTW_REDFT01, FFTW_REDFT01, FFTW_REDFT01, FFTW_MEASURE);
+#else
+    createDctPlanCpp(imax, dctData.planX);
+    createDctPlanCpp(jmax, dctData.planY);
+    createDctPlanCpp(kmax, dctData.planZ);
+#endif
+}
+
+void destroyDctSolverDataCpp(DctSolverDataCpp &dctData) {
+#ifdef USE_FFTW
+    if (dctData.forwardPlan) {
+        fftw_destroy_plan(dctData.forwardPlan);
+        fftw_destroy_plan(dctData.inversePlan);
+    }
+#endif
+    delete[] dctData.work;
+    dctData = DctSolverDataCpp();
+}
+
+void dctSolverCpp(int imax, int jmax, int kmax, Real *P, Real *RS, FlagType *Flag, DctSolverDataCpp &dctData) {
+    double *work = dctData.work;
+
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                work[IDXWORK(i,j,k)] = RS[IDXRS(i,j,k)];
+            }
+        }
+    }
+
+#ifdef USE_FFTW
+    fftw_execute(dctData.forwardPlan);
+#else
+    dctTransform3DCpp(imax, jmax, kmax, false, dctData);
+#endif
+
+    // Divide by the eigenvalues of the Laplace operator. The forward and the inverse transform together scale the values
+    // by 2*imax * 2*jmax * 2*kmax. The constant mode (eigenvalue zero) is the null space of the Neumann problem.
+    const double normalization = 1.0 / (8.0 * double(imax) * double(jmax) * double(kmax));
+    const double *eigenvaluesX = dctData.eigenvaluesX.data();
+    const double *eigenvaluesY = dctData.eigenvaluesY.data();
+    const double *eigenvaluesZ = dctData.eigenvaluesZ.data();
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                double eigenvalue = eigenvaluesX[i-1] + eigenvaluesY[j-1] + eigenvaluesZ[k-1];
+                work[IDXWORK(i,j,k)] = eigenvalue > 0.0 ? -work[IDXWORK(i,j,k)] * normalization / eigenvalue : 0.0;
+            }
+        }
+    }
+
+#ifdef USE_FFTW
+    fftw_execute(dctData.inversePlan);
+#else
+    dctTransform3DCpp(imax, jmax, kmax, true, dctData);
+#endif
+
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                P[IDXP(i,j,k)] = Real(work[IDXWORK(i,j,k)]);
+            }
+        }
+    }
+
+    setPressureBoundaryValuesCpp(imax, jmax, kmax, P, Flag);
+}
+
+}
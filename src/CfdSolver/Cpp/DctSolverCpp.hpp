@@ -0,0 +1,97 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_DCTSOLVERCPP_HPP
+#define CFD3D_DCTSOLVERCPP_HPP
+
+#include <vector>
+#include <complex>
+#include "Defines.hpp"
+#ifdef USE_FFTW
+#include <fftw3.h>
+#endif
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Precomputed data for a one-dimensional discrete cosine transform of length n (only used if FFTW is not available).
+ * The DCT is computed using a complex FFT of length n (mixed radix, so n doesn't need to be a power of two).
+ */
+struct DctPlanCpp {
+    int n = 0;
+    // Prime factors of n used by the mixed radix FFT.
+    std::vector<int> factors;
+    // roots[l] = exp(-2*pi*i*l/n).
+    std::vector<std::complex<double>> roots;
+    // shift[l] = exp(-pi*i*l/(2*n)).
+    std::vector<std::complex<double>> shift;
+};
+
+/**
+ * The data of the direct Poisson solver based on the discrete cosine transform (DCT). The eigenvectors of the discrete
+ * Laplace operator with homogeneous Neumann boundary conditions (i.e., the ghost cells copy the adjacent cell) are the
+ * basis functions of the DCT-II, so the PPE can be solved directly by a forward transform, a division by the
+ * eigenvalues and an inverse transform.
+ */
+struct DctSolverDataCpp {
+    // Work array of size imax*jmax*kmax (no ghost cells) for the transformed values.
+    double *work = nullptr;
+    // Eigenvalues of the negative second difference operator in x, y and z direction.
+    std::vector<double> eigenvaluesX, eigenvaluesY, eigenvaluesZ;
+#ifdef USE_FFTW
+    fftw_plan forwardPlan = nullptr, inversePlan = nullptr;
+#else
+    DctPlanCpp planX, planY, planZ;
+#endif
+};
+
+/**
+ * @return Whether the DCT solver can be used for the passed geometry (i.e., whether all interior cells are fluid cells).
+ */
+bool isDctSolverApplicableCpp(int imax, int jmax, int kmax, FlagType *Flag);
+
+/**
+ * Allocates the work array of the DCT solver and creates the transform plans.
+ */
+void createDctSolverDataCpp(Real dx, Real dy, Real dz, int imax, int jmax, int kmax, DctSolverDataCpp &dctData);
+
+/**
+ * Frees the memory allocated by createDctSolverDataCpp.
+ */
+void destroyDctSolverDataCpp(DctSolverDataCpp &dctData);
+
+/**
+ * Solves the Pressure Poisson Equation (PPE) directly using a 3D DCT in O(N log N). The mean value of RS is ignored
+ * (i.e., the compatible part of the Neumann problem is solved), and the mean value of the resulting pressure is zero.
+ * Afterwards, the pressure boundary values are set.
+ */
+void dctSolverCpp(int imax, int jmax, int kmax, Real *P, Real *RS, FlagType *Flag, DctSolverDataCpp &dctData);
+
+}
+
+#endif //CFD3D_DCTSOLVERCPP_HPP
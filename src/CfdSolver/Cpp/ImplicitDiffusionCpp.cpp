@@ -0,0 +1,214 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <utility>
+#include "../Flag.hpp"
+#include "ImplicitDiffusionCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createImplicitDiffusionDataCpp(
+        int imax, int jmax, int kmax, FlagType *Flag, ImplicitDiffusionDataCpp &implicitDiffusionData) {
+    implicitDiffusionData.X = new Real[(imax+2)*(jmax+2)*(kmax+2)];
+    implicitDiffusionData.X_temp = new Real[(imax+2)*(jmax+2)*(kmax+2)];
+    implicitDiffusionData.D = new Real[(imax+2)*(jmax+2)*(kmax+2)];
+    implicitDiffusionData.maskT = new uint8_t[(imax+2)*(jmax+2)*(kmax+2)];
+    uint8_t *maskT = implicitDiffusionData.maskT;
+
+    #pragma omp parallel for
+    for (int i = 0; i <= imax+1; i++) {
+        for (int j = 0; j <= jmax+1; j++) {
+            for (int k = 0; k <= kmax+1; k++) {
+                bool isInterior = i >= 1 && i <= imax && j >= 1 && j <= jmax && k >= 1 && k <= kmax;
+                maskT[IDXT(i,j,k)] = isInterior && isFluid(Flag[IDXFLAG(i,j,k)]) ? FGH_MASK_COMPUTE : FGH_MASK_KEEP;
+            }
+        }
+    }
+}
+
+void destroyImplicitDiffusionDataCpp(ImplicitDiffusionDataCpp &implicitDiffusionData) {
+    delete[] implicitDiffusionData.X;
+    delete[] implicitDiffusionData.X_temp;
+    delete[] implicitDiffusionData.D;
+    delete[] implicitDiffusionData.maskT;
+    implicitDiffusionData.X = nullptr;
+    implicitDiffusionData.X_temp = nullptr;
+    implicitDiffusionData.D = nullptr;
+    implicitDiffusionData.maskT = nullptr;
+}
+
+/**
+ * Solves (I - a*L) X = B for the points (i,j,k) in [1,ni]x[1,nj]x[1,nk] with mask == FGH_MASK_COMPUTE, where L is the
+ * seven-point Laplacian. The values of boundaryValues are used at all other points. On return, B holds the solution at
+ * the unknowns.
+ * boundaryValues and the work arrays are indexed with the strides strideXI and strideXJ (size: sizeX), B and mask with
+ * the strides strideBI and strideBJ. The stride in k direction is 1 for all arrays.
+ */
+static void solveDiffusionEquationCpp(
+        Real a, Real dx, Real dy, Real dz, int ni, int nj, int nk,
+        int strideXI, int strideXJ, int sizeX, int strideBI, int strideBJ,
+        const Real *boundaryValues, Real *B, const uint8_t *mask, ImplicitDiffusionDataCpp &implicitDiffusionData) {
+    const Real cx = a/(dx*dx), cy = a/(dy*dy), cz = a/(dz*dz);
+    const Real diagonal = 1 + 2*(cx + cy + cz);
+    const Real diagonalInverse = 1/diagonal;
+    // The eigenvalues of D^-1 A lie in [1 - delta, 1 + delta] (Gershgorin).
+    const Real delta = 1 - diagonalInverse;
+    Real *X = implicitDiffusionData.X;
+    Real *X_temp = implicitDiffusionData.X_temp;
+    Real *D = implicitDiffusionData.D;
+
+    // The explicit update of the diffusive terms is used as the initial guess, which is close to the solution if the
+    // values change slowly.
+    memcpy(X, boundaryValues, sizeof(Real)*sizeX);
+    memcpy(X_temp, boundaryValues, sizeof(Real)*sizeX);
+    Real rhsNormSquared = Real(0.0);
+    #pragma omp parallel for reduction(+: rhsNormSquared)
+    for (int i = 1; i <= ni; i++) {
+        for (int j = 1; j <= nj; j++) {
+            for (int k = 1; k <= nk; k++) {
+                const int idxX = i*strideXI + j*strideXJ + k, idxB = i*strideBI + j*strideBJ + k;
+                if (mask[idxB] == FGH_MASK_COMPUTE) {
+                    const Real *Y = boundaryValues;
+                    X[idxX] = B[idxB]
+                            + cx*(Y[idxX+strideXI] + Y[idxX-strideXI])
+                            + cy*(Y[idxX+strideXJ] + Y[idxX-strideXJ])
+                            + cz*(Y[idxX+1] + Y[idxX-1])
+                            - (diagonal - 1)*Y[idxX];
+                    rhsNormSquared += B[idxB]*B[idxB];
+                }
+            }
+        }
+    }
+
+    // Chebyshev acceleration of the Jacobi iteration (like in ChebyshevCpp.cpp, but with the analytical bounds of the
+    // spectrum). The new values are written to X_temp, and the buffers are swapped afterwards.
+    const Real toleranceSquared = IMPLICIT_DIFFUSION_TOLERANCE*IMPLICIT_DIFFUSION_TOLERANCE*rhsNormSquared;
+    Real rho = delta;
+    for (int iteration = 0; iteration < IMPLICIT_DIFFUSION_MAX_ITERATIONS; iteration++) {
+        Real directionFactor = Real(0.0), residualFactor = diagonalInverse;
+        if (iteration > 0) {
+            Real rhoNew = 1 / (2 / delta - rho);
+            directionFactor = rhoNew * rho;
+            residualFactor = 2 * rhoNew / delta * diagonalInverse;
+            rho = rhoNew;
+        }
+
+        Real residualSquared = Real(0.0);
+        #pragma omp parallel for reduction(+: residualSquared)
+        for (int i = 1; i <= ni; i++) {
+            for (int j = 1; j <= nj; j++) {
+                #pragma omp simd reduction(+: residualSquared)
+                for (int k = 1; k <= nk; k++) {
+                    const int idxX = i*strideXI + j*strideXJ + k, idxB = i*strideBI + j*strideBJ + k;
+                    const bool isUnknown = mask[idxB] == FGH_MASK_COMPUTE;
+                    Real r = B[idxB]
+                            + cx*(X[idxX+strideXI] + X[idxX-strideXI])
+                            + cy*(X[idxX+strideXJ] + X[idxX-strideXJ])
+                            + cz*(X[idxX+1] + X[idxX-1])
+                            - diagonal*X[idxX];
+                    Real direction = isUnknown ? directionFactor*D[idxX] + residualFactor*r : Real(0.0);
+                    D[idxX] = direction;
+                    X_temp[idxX] = X[idxX] + direction;
+                    residualSquared += isUnknown ? r*r : Real(0.0);
+                }
+            }
+        }
+        std::swap(X, X_temp);
+        if (residualSquared <= toleranceSquared) {
+            break;
+        }
+    }
+
+    #pragma omp parallel for
+    for (int i = 1; i <= ni; i++) {
+        for (int j = 1; j <= nj; j++) {
+            for (int k = 1; k <= nk; k++) {
+                const int idxX = i*strideXI + j*strideXJ + k, idxB = i*strideBI + j*strideBJ + k;
+                if (mask[idxB] == FGH_MASK_COMPUTE) {
+                    B[idxB] = X[idxX];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Adds dt times the body force (gravity g and buoyancy) to the values of B (indexed like RS) at the points (i,j,k) in
+ * [1,ni]x[1,nj]x[1,nk] with mask == FGH_MASK_COMPUTE. The temperature is interpolated from the cells (i,j,k) and
+ * (i,j,k) + offsetT.
+ */
+static void addBodyForceCpp(
+        Real g, Real beta, Real dt, int offsetT, int ni, int nj, int nk, int jmax, int kmax,
+        Real *B, const uint8_t *mask, const Real *T) {
+    #pragma omp parallel for
+    for (int i = 1; i <= ni; i++) {
+        for (int j = 1; j <= nj; j++) {
+            for (int k = 1; k <= nk; k++) {
+                if (mask[IDXRS(i,j,k)] == FGH_MASK_COMPUTE) {
+                    B[IDXRS(i,j,k)] += dt * (g - (beta/2)*(T[IDXT(i,j,k)] + T[IDXT(i,j,k) + offsetT])*g);
+                }
+            }
+        }
+    }
+}
+
+void solveImplicitMomentumDiffusionCpp(
+        Real Re, Real GX, Real GY, Real GZ, Real beta, Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W, Real *T, Real *F, Real *G, Real *H, const FghMasksCpp &fghMasks,
+        ImplicitDiffusionDataCpp &implicitDiffusionData) {
+    const Real a = dt/Re;
+    // F, G and H are indexed like RS (IDXF, IDXG and IDXH).
+    const int strideBI = (jmax+1)*(kmax+1), strideBJ = kmax+1;
+    solveDiffusionEquationCpp(
+            a, dx, dy, dz, imax-1, jmax, kmax, (jmax+2)*(kmax+2), kmax+2, (imax+1)*(jmax+2)*(kmax+2),
+            strideBI, strideBJ, U, F, fghMasks.maskF, implicitDiffusionData);
+    solveDiffusionEquationCpp(
+            a, dx, dy, dz, imax, jmax-1, kmax, (jmax+1)*(kmax+2), kmax+2, (imax+2)*(jmax+1)*(kmax+2),
+            strideBI, strideBJ, V, G, fghMasks.maskG, implicitDiffusionData);
+    solveDiffusionEquationCpp(
+            a, dx, dy, dz, imax, jmax, kmax-1, (jmax+2)*(kmax+1), kmax+1, (imax+2)*(jmax+2)*(kmax+1),
+            strideBI, strideBJ, W, H, fghMasks.maskH, implicitDiffusionData);
+
+    // The body forces are added after solving the diffusion equations. Forces balanced by the pressure (e.g., gravity)
+    // must not be diffused against the fixed boundary values, as this would make them rotational.
+    addBodyForceCpp(GX, beta, dt, (jmax+2)*(kmax+2), imax-1, jmax, kmax, jmax, kmax, F, fghMasks.maskF, T);
+    addBodyForceCpp(GY, beta, dt, kmax+2, imax, jmax-1, kmax, jmax, kmax, G, fghMasks.maskG, T);
+    addBodyForceCpp(GZ, beta, dt, 1, imax, jmax, kmax-1, jmax, kmax, H, fghMasks.maskH, T);
+}
+
+void solveImplicitTemperatureDiffusionCpp(
+        Real Re, Real Pr, Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *T, Real *T_temp, ImplicitDiffusionDataCpp &implicitDiffusionData) {
+    const int strideI = (jmax+2)*(kmax+2), strideJ = kmax+2;
+    solveDiffusionEquationCpp(
+            dt/(Re*Pr), dx, dy, dz, imax, jmax, kmax, strideI, strideJ, (imax+2)*(jmax+2)*(kmax+2),
+            strideI, strideJ, T_temp, T, implicitDiffusionData.maskT, implicitDiffusionData);
+}
+
+}
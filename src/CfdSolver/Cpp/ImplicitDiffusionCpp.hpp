@@ -0,0 +1,97 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_IMPLICITDIFFUSIONCPP_HPP
+#define CFD3D_IMPLICITDIFFUSIONCPP_HPP
+
+#include <cstdint>
+#include "Defines.hpp"
+#include "UvwCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The solution of the diffusion equations is considered as converged if the norm of the residual is at most this factor
+ * times the norm of the right-hand side.
+ */
+const Real IMPLICIT_DIFFUSION_TOLERANCE = Real(1e-4);
+
+/**
+ * The maximum number of iterations for one diffusion equation.
+ */
+const int IMPLICIT_DIFFUSION_MAX_ITERATIONS = 100;
+
+/**
+ * The data for treating the diffusive terms implicitly (backward Euler). For each velocity component and for the
+ * temperature, the matrix-free system (I - dt*nu*L) X = B is solved on the faces (cells) updated by calculateFghCpp
+ * (calculateTemperatureCpp), where L is the seven-point Laplacian and nu is 1/Re (1/(Re*Pr)). B is the result of the
+ * explicit kernel without the diffusive terms (and without the body forces). The values on all other faces (cells),
+ * i.e., the values set by the boundary conditions at the beginning of the time step, are fixed Dirichlet values.
+ * The eigenvalues of the Jacobi preconditioned system are known analytically, so the systems are solved with the
+ * Chebyshev accelerated Jacobi iteration.
+ */
+struct ImplicitDiffusionDataCpp {
+    // Work arrays with the size of the cell-centered arrays: The unknowns together with the fixed boundary values
+    // (X and X_temp are swapped in each iteration) and the update direction of the Chebyshev iteration.
+    Real *X = nullptr, *X_temp = nullptr, *D = nullptr;
+    // FGH_MASK_COMPUTE for the fluid cells (in the layout of T), i.e., the unknowns of the temperature equation.
+    uint8_t *maskT = nullptr;
+};
+
+/**
+ * Allocates the work arrays and computes the mask of the fluid cells from the flag array.
+ */
+void createImplicitDiffusionDataCpp(
+        int imax, int jmax, int kmax, FlagType *Flag, ImplicitDiffusionDataCpp &implicitDiffusionData);
+
+/**
+ * Frees the memory allocated by createImplicitDiffusionDataCpp.
+ */
+void destroyImplicitDiffusionDataCpp(ImplicitDiffusionDataCpp &implicitDiffusionData);
+
+/**
+ * Adds the viscous terms to F, G and H computed by calculateFghCpp with implicitDiffusion set to true by solving the
+ * backward Euler diffusion equations, and adds the body forces afterwards. The boundary values are taken from U, V
+ * and W.
+ */
+void solveImplicitMomentumDiffusionCpp(
+        Real Re, Real GX, Real GY, Real GZ, Real beta, Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W, Real *T, Real *F, Real *G, Real *H, const FghMasksCpp &fghMasks,
+        ImplicitDiffusionDataCpp &implicitDiffusionData);
+
+/**
+ * Adds the diffusive term to T computed by calculateTemperatureCpp with implicitDiffusion set to true by solving the
+ * backward Euler diffusion equation. The boundary values are taken from T_temp.
+ */
+void solveImplicitTemperatureDiffusionCpp(
+        Real Re, Real Pr, Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *T, Real *T_temp, ImplicitDiffusionDataCpp &implicitDiffusionData);
+
+}
+
+#endif //CFD3D_IMPLICITDIFFUSIONCPP_HPP
@@ -0,0 +1,127 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <vector>
+#include "LineRelaxationCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+int selectLineRelaxationAxisCpp(Real dx, Real dy, Real dz) {
+    // For equal cell sizes, the z axis is preferred, as the cells of a line are then contiguous in memory.
+    if (dz <= dx && dz <= dy) {
+        return 2;
+    }
+    return dy <= dx ? 1 : 0;
+}
+
+Real zebraLineRelaxationSweepCpp(
+        Real omg, int axis, int imax, int jmax, int kmax, Real *P, Real *RS, PressureOperatorCpp &pressureOperator) {
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+
+    // The lines run along the axis a, and the two other axes b and c enumerate the lines. The strides are the index
+    // offsets of the neighbors in the pressure array (IDXP) and the right-hand side array (IDXRS).
+    const int axisB = axis == 0 ? 1 : 0;
+    const int axisC = axis == 2 ? 1 : 2;
+    const int sizes[3] = { imax, jmax, kmax };
+    const int strides[3] = { (jmax+2)*(kmax+2), kmax+2, 1 };
+    const int stridesRs[3] = { (jmax+1)*(kmax+1), kmax+1, 1 };
+    const Real *coeffs[3] = { pressureOperator.coeffR, pressureOperator.coeffU, pressureOperator.coeffF };
+    const int lineLength = sizes[axis];
+    const int strideA = strides[axis], strideB = strides[axisB], strideC = strides[axisC];
+    const Real *coeffA = coeffs[axis], *coeffB = coeffs[axisB], *coeffC = coeffs[axisC];
+
+    Real residual = Real(0.0);
+    #pragma omp parallel
+    {
+        // Work arrays of the Thomas algorithm (modified upper diagonal and right-hand side of each row).
+        std::vector<Real> upperModified(lineLength + 2), rhsModified(lineLength + 2);
+
+        for (int color = 0; color < 2; color++) {
+            #pragma omp for reduction(+: residual)
+            for (int b = 1; b <= sizes[axisB]; b++) {
+                for (int c = 1 + (b + 1 + color) % 2; c <= sizes[axisC]; c += 2) {
+                    const int lineStart = b*strideB + c*strideC;
+                    const int lineStartRs = b*stridesRs[axisB] + c*stridesRs[axisC];
+
+                    // Forward elimination. Row l: -cPrev*P[l-1] + diagonal*P[l] - cNext*P[l+1] = rhs, where rhs
+                    // contains the contributions of the (fixed) neighboring lines.
+                    upperModified[0] = Real(0.0);
+                    rhsModified[0] = Real(0.0);
+                    for (int l = 1; l <= lineLength; l++) {
+                        const int idx = lineStart + l*strideA;
+                        if (diagonalInverse[idx] == Real(0.0)) {
+                            // Non-fluid cell (or a fluid cell without any fluid neighbor). It keeps its value.
+                            upperModified[l] = Real(0.0);
+                            rhsModified[l] = P[idx];
+                            continue;
+                        }
+
+                        const Real cPrev = coeffA[idx - strideA], cNext = coeffA[idx];
+                        const Real diagonal = Real(1.0) / diagonalInverse[idx];
+                        const Real rhs =
+                                coeffB[idx]*P[idx + strideB] + coeffB[idx - strideB]*P[idx - strideB]
+                                + coeffC[idx]*P[idx + strideC] + coeffC[idx - strideC]*P[idx - strideC]
+                                - RS[lineStartRs + l*stridesRs[axis]];
+                        const Real r = rhs + cPrev*P[idx - strideA] + cNext*P[idx + strideA] - diagonal*P[idx];
+                        residual += r*r;
+
+                        // If the line is not coupled to any neighboring line, the system of a line segment is
+                        // singular (pure Neumann problem). Its last row is then dropped, i.e., the last cell keeps its
+                        // value, which fixes the free constant.
+                        const Real denominator = diagonal - cPrev*upperModified[l-1];
+                        if (denominator <= Real(1e-6) * diagonal) {
+                            upperModified[l] = Real(0.0);
+                            rhsModified[l] = P[idx];
+                            continue;
+                        }
+                        upperModified[l] = cNext / denominator;
+                        rhsModified[l] = (rhs + cPrev*rhsModified[l-1]) / denominator;
+                    }
+
+                    // Back substitution and relaxation.
+                    Real solutionNext = Real(0.0);
+                    for (int l = lineLength; l >= 1; l--) {
+                        const int idx = lineStart + l*strideA;
+                        const Real solution = rhsModified[l] + upperModified[l]*solutionNext;
+                        P[idx] += omg * (solution - P[idx]);
+                        solutionNext = solution;
+                    }
+                }
+            }
+        }
+    }
+
+    // The residual is normalized by dividing by the total number of fluid cells.
+    if (pressureOperator.numFluidCells == 0) {
+        return Real(0.0);
+    }
+    return std::sqrt(residual/pressureOperator.numFluidCells);
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_LINERELAXATIONCPP_HPP
+#define CFD3D_LINERELAXATIONCPP_HPP
+
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Returns the axis (0: x, 1: y, 2: z) with the smallest cell size. The cells are most strongly coupled along this axis,
+ * so this is the axis along which the lines of the line relaxation solver are solved implicitly.
+ */
+int selectLineRelaxationAxisCpp(Real dx, Real dy, Real dz);
+
+/**
+ * Performs one zebra line relaxation sweep using the precomputed operator. All lines of cells along the passed axis
+ * are solved exactly with the Thomas algorithm, where the values of the neighboring lines are kept fixed. The lines are
+ * processed in two colors (like the cells in red-black SOR), so all lines of one color can be solved in parallel.
+ * Obstacle cells split a line into independent segments, as the operator has no coefficients between fluid and
+ * non-fluid cells. Non-fluid cells keep their value, so RS doesn't need to be masked.
+ * Point relaxation converges very slowly if the grid is strongly anisotropic. Line relaxation along the axis with the
+ * smallest cell size removes this dependency on the aspect ratio of the cells.
+ * @param omg The over-relaxation factor (1: line Gauss-Seidel).
+ * @param axis The axis of the lines (@see selectLineRelaxationAxisCpp).
+ * @return The residual normalized by the number of fluid cells. It is computed during the sweep using the values each
+ * line solve is based on.
+ */
+Real zebraLineRelaxationSweepCpp(
+        Real omg, int axis, int imax, int jmax, int kmax, Real *P, Real *RS, PressureOperatorCpp &pressureOperator);
+
+}
+
+#endif //CFD3D_LINERELAXATIONCPP_HPP
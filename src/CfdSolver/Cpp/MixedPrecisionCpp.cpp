@@ -0,0 +1,138 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include "MixedPrecisionCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The factor by which the single precision sweeps reduce the residual before the correction is added to the pressure.
+ * The relaxation sweeps are stationary iterations, so restarting them from a zero correction doesn't change the
+ * convergence rate. The factor only needs to stay well above the accuracy of single precision.
+ */
+const float INNER_RESIDUAL_REDUCTION = 1e-3f;
+
+void createMixedPrecisionDataCpp(
+        int imax, int jmax, int kmax, const PressureOperatorCpp &pressureOperator,
+        MixedPrecisionDataCpp &mixedPrecisionData) {
+    createPressureOperatorFloatCpp(imax, jmax, kmax, pressureOperator, mixedPrecisionData.pressureOperator);
+    mixedPrecisionData.E = new float[(imax+2)*(jmax+2)*(kmax+2)];
+    mixedPrecisionData.E_temp = new float[(imax+2)*(jmax+2)*(kmax+2)];
+    mixedPrecisionData.R = new float[(imax+1)*(jmax+1)*(kmax+1)];
+    memset(mixedPrecisionData.E, 0, sizeof(float)*(imax+2)*(jmax+2)*(kmax+2));
+    memset(mixedPrecisionData.E_temp, 0, sizeof(float)*(imax+2)*(jmax+2)*(kmax+2));
+    memset(mixedPrecisionData.R, 0, sizeof(float)*(imax+1)*(jmax+1)*(kmax+1));
+}
+
+void destroyMixedPrecisionDataCpp(MixedPrecisionDataCpp &mixedPrecisionData) {
+    destroyPressureOperatorCpp(mixedPrecisionData.pressureOperator);
+    delete[] mixedPrecisionData.E;
+    delete[] mixedPrecisionData.E_temp;
+    delete[] mixedPrecisionData.R;
+    mixedPrecisionData = MixedPrecisionDataCpp();
+}
+
+/**
+ * Computes the residual RS - A p in Real precision, stores it in single precision in R and returns its norm normalized
+ * by the number of fluid cells.
+ */
+Real computeOuterResidualCpp(
+        int imax, int jmax, int kmax, Real *P, Real *RS, PressureOperatorCpp &pressureOperator, float *R) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    double residual = 0.0;
+
+    #pragma omp parallel for reduction(+: residual)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                Real r = RS[IDXRS(i,j,k)] + (cR + cL + cU + cD + cF + cB)*P[IDXP(i,j,k)]
+                        - cR*P[IDXP(i+1,j,k)] - cL*P[IDXP(i-1,j,k)]
+                        - cU*P[IDXP(i,j+1,k)] - cD*P[IDXP(i,j-1,k)]
+                        - cF*P[IDXP(i,j,k+1)] - cB*P[IDXP(i,j,k-1)];
+                R[IDXRS(i,j,k)] = float(r);
+                residual += double(r)*double(r);
+            }
+        }
+    }
+
+    if (pressureOperator.numFluidCells == 0) {
+        return Real(0.0);
+    }
+    return Real(std::sqrt(residual/pressureOperator.numFluidCells));
+}
+
+void mixedPrecisionSolverCpp(
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        int imax, int jmax, int kmax, Real *P, Real *RS, PressureOperatorCpp &pressureOperator,
+        MixedPrecisionDataCpp &mixedPrecisionData, Real &residual, int &it) {
+    float *E = mixedPrecisionData.E;
+    float *E_temp = mixedPrecisionData.E_temp;
+    float *R = mixedPrecisionData.R;
+
+    residual = computeOuterResidualCpp(imax, jmax, kmax, P, RS, pressureOperator, R);
+    while (it < itermax && residual > eps) {
+        // Solve A e = R approximately in single precision. The residual computed by the sweeps is the one of the
+        // correction equation, which is the residual of p + e (up to rounding errors).
+        const float innerEps = std::max(float(eps), INNER_RESIDUAL_REDUCTION * float(residual));
+        float innerResidual = std::numeric_limits<float>::max();
+        memset(E, 0, sizeof(float)*(imax+2)*(jmax+2)*(kmax+2));
+        while (it < itermax && innerResidual > innerEps) {
+            float sweepResidual = pressureOperatorSweepCpp(
+                    float(omg), imax, jmax, kmax, linearSystemSolverType, E, E_temp, R,
+                    mixedPrecisionData.pressureOperator);
+            it++;
+
+            // Convergence is only checked every residualCheckInterval iterations.
+            if (it % residualCheckInterval == 0 || it == itermax) {
+                innerResidual = sweepResidual;
+            }
+        }
+
+        // Add the correction in Real precision and compute the new residual.
+        #pragma omp parallel for
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    P[IDXP(i,j,k)] += Real(E[IDXP(i,j,k)]);
+                }
+            }
+        }
+        residual = computeOuterResidualCpp(imax, jmax, kmax, P, RS, pressureOperator, R);
+    }
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_MIXEDPRECISIONCPP_HPP
+#define CFD3D_MIXEDPRECISIONCPP_HPP
+
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Data of the mixed precision solver for the Pressure Poisson Equation (PPE). The pressure and the residual are kept in
+ * Real precision, while the relaxation sweeps iterate in single precision on the correction equation A e = RS - A p
+ * (iterative refinement). If Real is double, this halves the memory traffic of the sweeps, which dominate the run time
+ * of the Jacobi and SOR type solvers, without limiting the achievable accuracy to single precision.
+ */
+struct MixedPrecisionDataCpp {
+    // The single precision copy of the pressure operator.
+    PressureOperatorFloatCpp pressureOperator;
+    // The correction e and its copy for the Jacobi solver (pressure array size).
+    float *E = nullptr, *E_temp = nullptr;
+    // The residual RS - A p of the outer iteration, i.e., the right-hand side of the correction equation.
+    float *R = nullptr;
+};
+
+/**
+ * Allocates the work arrays of the mixed precision solver and creates a single precision copy of the pressure operator.
+ */
+void createMixedPrecisionDataCpp(
+        int imax, int jmax, int kmax, const PressureOperatorCpp &pressureOperator,
+        MixedPrecisionDataCpp &mixedPrecisionData);
+
+/**
+ * Frees the memory allocated by createMixedPrecisionDataCpp.
+ */
+void destroyMixedPrecisionDataCpp(MixedPrecisionDataCpp &mixedPrecisionData);
+
+/**
+ * Solves the PPE with a Jacobi or SOR type solver using single precision sweeps and an outer iterative refinement in
+ * Real precision. RS needs to be zero in all non-fluid cells (@see maskRsPressureOperatorCpp). The boundary values of
+ * P are not set.
+ * @param residual The residual (computed in Real precision) after the last outer iteration.
+ * @param it The total number of relaxation sweeps.
+ */
+void mixedPrecisionSolverCpp(
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        int imax, int jmax, int kmax, Real *P, Real *RS, PressureOperatorCpp &pressureOperator,
+        MixedPrecisionDataCpp &mixedPrecisionData, Real &residual, int &it);
+
+}
+
+#endif //CFD3D_MIXEDPRECISIONCPP_HPP
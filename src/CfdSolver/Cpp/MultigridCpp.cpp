@@ -0,0 +1,385 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "../Flag.hpp"
+#include "SorSolverCpp.hpp"
+#include "LineRelaxationCpp.hpp"
+#include "MultigridCpp.hpp"
+
+/**
+ * For accessing the 1D-arrays of a multigrid level as 3D-arrays.
+ */
+#define IDXP_LEVEL(level,i,j,k) ((i)*((level).jmax+2)*((level).kmax+2) + (j)*((level).kmax+2) + (k))
+#define IDXRS_LEVEL(level,i,j,k) ((i)*((level).jmax+1)*((level).kmax+1) + (j)*((level).kmax+1) + (k))
+#define IDXFLAG_LEVEL(level,i,j,k) ((i)*((level).jmax+2)*((level).kmax+2) + (j)*((level).kmax+2) + (k))
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+// Number of smoothing sweeps before and after the coarse grid correction.
+const int NUM_PRE_SMOOTHING_SWEEPS = 2;
+const int NUM_POST_SMOOTHING_SWEEPS = 2;
+
+// Damping factor of the Jacobi smoother. 6/7 gives the best smoothing factor for the 7-point stencil in 3D.
+const Real JACOBI_SMOOTHER_OMEGA = Real(6.0 / 7.0);
+
+// The line smoother is used if the cell size along the line axis is at most 1/LINE_SMOOTHER_ANISOTROPY times the cell
+// size along the two other axes.
+const Real LINE_SMOOTHER_ANISOTROPY = Real(2.0);
+
+/**
+ * Selects the smoother of the passed level and creates the pressure operator if the line smoother is used.
+ */
+void createMultigridSmootherCpp(MultigridLevelCpp &level) {
+    level.lineRelaxationAxis = -1;
+    const int axis = selectLineRelaxationAxisCpp(level.dx, level.dy, level.dz);
+    const Real h[3] = { level.dx, level.dy, level.dz };
+    const int sizes[3] = { level.imax, level.jmax, level.kmax };
+    for (int otherAxis = 0; otherAxis < 3; otherAxis++) {
+        // Axes with only one cell don't couple any cells.
+        if (otherAxis != axis && sizes[otherAxis] > 1 && h[otherAxis] < LINE_SMOOTHER_ANISOTROPY * h[axis]) {
+            return;
+        }
+    }
+    if (sizes[axis] <= 1) {
+        return;
+    }
+    level.lineRelaxationAxis = axis;
+    createPressureOperatorCpp(
+            level.dx, level.dy, level.dz, level.imax, level.jmax, level.kmax, level.Flag, level.pressureOperator);
+}
+
+void createMultigridHierarchyCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *P, Real *P_temp, Real *RS, FlagType *Flag,
+        std::vector<MultigridLevelCpp> &multigridLevels) {
+    MultigridLevelCpp fineLevel;
+    fineLevel.imax = imax;
+    fineLevel.jmax = jmax;
+    fineLevel.kmax = kmax;
+    fineLevel.ci = fineLevel.cj = fineLevel.ck = 1;
+    fineLevel.dx = dx;
+    fineLevel.dy = dy;
+    fineLevel.dz = dz;
+    fineLevel.P = P;
+    fineLevel.P_temp = P_temp;
+    fineLevel.RS = RS;
+    fineLevel.Flag = Flag;
+    fineLevel.R = new Real[(imax+1)*(jmax+1)*(kmax+1)];
+    memset(fineLevel.R, 0, sizeof(Real)*(imax+1)*(jmax+1)*(kmax+1));
+    createMultigridSmootherCpp(fineLevel);
+    multigridLevels.push_back(fineLevel);
+
+    while (true) {
+        const MultigridLevelCpp fine = multigridLevels.back();
+        const Real hMin = std::min(std::min(fine.dx, fine.dy), fine.dz);
+
+        // Only coarsen directions with an even number of cells and at least four cells. Directions with a cell size
+        // much larger than the smallest cell size are not coarsened (semi-coarsening), as point smoothers can't smooth
+        // the error there. The hierarchy ends when no direction can be coarsened anymore, i.e., odd numbers of cells
+        // are not agglomerated. Thus, the coarsest level (solved with O(n) SOR sweeps) stays large if imax, jmax or
+        // kmax is odd or only divisible by a small power of two.
+        MultigridLevelCpp coarse;
+        coarse.ci = fine.imax % 2 == 0 && fine.imax >= 4 && fine.dx < 2*hMin ? 2 : 1;
+        coarse.cj = fine.jmax % 2 == 0 && fine.jmax >= 4 && fine.dy < 2*hMin ? 2 : 1;
+        coarse.ck = fine.kmax % 2 == 0 && fine.kmax >= 4 && fine.dz < 2*hMin ? 2 : 1;
+        if (coarse.ci == 1 && coarse.cj == 1 && coarse.ck == 1) {
+            break;
+        }
+
+        coarse.imax = fine.imax / coarse.ci;
+        coarse.jmax = fine.jmax / coarse.cj;
+        coarse.kmax = fine.kmax / coarse.ck;
+        coarse.dx = fine.dx * Real(coarse.ci);
+        coarse.dy = fine.dy * Real(coarse.cj);
+        coarse.dz = fine.dz * Real(coarse.ck);
+
+        const int sizeP = (coarse.imax+2)*(coarse.jmax+2)*(coarse.kmax+2);
+        const int sizeRS = (coarse.imax+1)*(coarse.jmax+1)*(coarse.kmax+1);
+        coarse.P = new Real[sizeP];
+        coarse.P_temp = new Real[sizeP];
+        coarse.RS = new Real[sizeRS];
+        coarse.R = new Real[sizeRS];
+        coarse.Flag = new FlagType[sizeP];
+        memset(coarse.P, 0, sizeof(Real)*sizeP);
+        memset(coarse.P_temp, 0, sizeof(Real)*sizeP);
+        memset(coarse.RS, 0, sizeof(Real)*sizeRS);
+        memset(coarse.R, 0, sizeof(Real)*sizeRS);
+
+        // Coarsen the Flag array. A coarse cell is fluid if any of its children is fluid, as otherwise thin channels
+        // in the geometry would be closed on the coarse levels.
+        for (int i = 0; i <= coarse.imax+1; i++) {
+            for (int j = 0; j <= coarse.jmax+1; j++) {
+                for (int k = 0; k <= coarse.kmax+1; k++) {
+                    bool isFluidCell = false;
+                    if (i >= 1 && j >= 1 && k >= 1 && i <= coarse.imax && j <= coarse.jmax && k <= coarse.kmax) {
+                        for (int fi = (i-1)*coarse.ci+1; fi <= i*coarse.ci; fi++) {
+                            for (int fj = (j-1)*coarse.cj+1; fj <= j*coarse.cj; fj++) {
+                                for (int fk = (k-1)*coarse.ck+1; fk <= k*coarse.ck; fk++) {
+                                    isFluidCell = isFluidCell || isFluid(fine.Flag[IDXFLAG_LEVEL(fine,fi,fj,fk)]);
+                                }
+                            }
+                        }
+                    }
+                    // Fluid or no-slip.
+                    coarse.Flag[IDXFLAG_LEVEL(coarse,i,j,k)] = isFluidCell ? FLAG_FLUID : FLAG_NO_SLIP;
+                }
+            }
+        }
+
+        // Set the neighbor bits of the obstacle cells in the interior (used for the pressure boundary values).
+        for (int i = 1; i <= coarse.imax; i++) {
+            for (int j = 1; j <= coarse.jmax; j++) {
+                for (int k = 1; k <= coarse.kmax; k++) {
+                    FlagType &flag = coarse.Flag[IDXFLAG_LEVEL(coarse,i,j,k)];
+                    if (isFluid(flag)) {
+                        continue;
+                    }
+                    if (isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,i-1,j,k)])) flag |= FLAG_B_L;
+                    if (isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,i+1,j,k)])) flag |= FLAG_B_R;
+                    if (isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,i,j-1,k)])) flag |= FLAG_B_D;
+                    if (isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,i,j+1,k)])) flag |= FLAG_B_U;
+                    if (isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,i,j,k-1)])) flag |= FLAG_B_B;
+                    if (isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,i,j,k+1)])) flag |= FLAG_B_F;
+                }
+            }
+        }
+
+        createMultigridSmootherCpp(coarse);
+        multigridLevels.push_back(coarse);
+    }
+}
+
+void destroyMultigridHierarchyCpp(std::vector<MultigridLevelCpp> &multigridLevels) {
+    for (size_t l = 0; l < multigridLevels.size(); l++) {
+        MultigridLevelCpp &level = multigridLevels.at(l);
+        if (l != 0) {
+            delete[] level.P;
+            delete[] level.P_temp;
+            delete[] level.RS;
+            delete[] level.Flag;
+        }
+        delete[] level.R;
+        destroyPressureOperatorCpp(level.pressureOperator);
+    }
+    multigridLevels.clear();
+}
+
+void smoothMultigridLevelCpp(MultigridLevelCpp &level, int numSweeps) {
+    if (level.lineRelaxationAxis >= 0) {
+        // Line Gauss-Seidel. The boundary conditions are part of the operator.
+        for (int sweep = 0; sweep < numSweeps; sweep++) {
+            zebraLineRelaxationSweepCpp(
+                    Real(1.0), level.lineRelaxationAxis, level.imax, level.jmax, level.kmax,
+                    level.P, level.RS, level.pressureOperator);
+        }
+        return;
+    }
+
+    const Real dx = level.dx, dy = level.dy, dz = level.dz;
+    const Real coeff = JACOBI_SMOOTHER_OMEGA
+            / (Real(2.0) * (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy) + Real(1.0) / (dz*dz)));
+    // The sweeps alternate between the two buffers. The arrays of the level itself must not be swapped, as P of the
+    // finest level belongs to the solver.
+    Real *P = level.P, *P_temp = level.P_temp;
+    for (int sweep = 0; sweep < numSweeps; sweep++) {
+        setPressureBoundaryValuesCpp(level.imax, level.jmax, level.kmax, P, level.Flag);
+        sorSolverSweepCpp(
+                JACOBI_SMOOTHER_OMEGA, dx, dy, dz, coeff, level.imax, level.jmax, level.kmax,
+                LINEAR_SOLVER_JACOBI, P, P_temp, level.RS, level.Flag);
+    }
+
+    // After an odd number of sweeps, the result is stored in P_temp. Only the fluid cells are read afterwards.
+    if (P != level.P) {
+        #pragma omp parallel for
+        for (int i = 1; i <= level.imax; i++) {
+            for (int j = 1; j <= level.jmax; j++) {
+                for (int k = 1; k <= level.kmax; k++) {
+                    level.P[IDXP_LEVEL(level,i,j,k)] = P[IDXP_LEVEL(level,i,j,k)];
+                }
+            }
+        }
+    }
+}
+
+void solveCoarsestLevelCpp(MultigridLevelCpp &level) {
+    const int imax = level.imax, jmax = level.jmax, kmax = level.kmax;
+    const Real dx = level.dx, dy = level.dy, dz = level.dz;
+
+    // The restricted residual is not necessarily compatible with the Neumann boundary conditions.
+    subtractMeanRsCpp(imax, jmax, kmax, level.RS, level.Flag);
+
+    // SOR with the optimal over-relaxation factor of the model problem needs O(n) sweeps.
+    const int nmax = std::max(std::max(std::max(imax, jmax), kmax), 2);
+    const Real omg = Real(2.0) / (Real(1.0) + Real(std::sin(M_PI / nmax)));
+    const Real coeff = omg / (Real(2.0) * (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy) + Real(1.0) / (dz*dz)));
+    for (int sweep = 0; sweep < 2*nmax; sweep++) {
+        setPressureBoundaryValuesCpp(imax, jmax, kmax, level.P, level.Flag);
+        sorSolverSweepCpp(
+                omg, dx, dy, dz, coeff, imax, jmax, kmax, LINEAR_SOLVER_SOR,
+                level.P, level.P_temp, level.RS, level.Flag);
+    }
+}
+
+void computeResidualMultigridCpp(MultigridLevelCpp &level) {
+    const int imax = level.imax, jmax = level.jmax, kmax = level.kmax;
+    const Real dx = level.dx, dy = level.dy, dz = level.dz;
+    Real *P = level.P, *RS = level.RS, *R = level.R;
+    FlagType *Flag = level.Flag;
+
+    setPressureBoundaryValuesCpp(imax, jmax, kmax, P, Flag);
+
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    R[IDXRS(i,j,k)] = RS[IDXRS(i,j,k)]
+                            - (P[IDXP(i+1,j,k)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i-1,j,k)])/(dx*dx)
+                            - (P[IDXP(i,j+1,k)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i,j-1,k)])/(dy*dy)
+                            - (P[IDXP(i,j,k+1)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i,j,k-1)])/(dz*dz);
+                } else {
+                    R[IDXRS(i,j,k)] = Real(0.0);
+                }
+            }
+        }
+    }
+}
+
+void restrictResidualCpp(const MultigridLevelCpp &fine, MultigridLevelCpp &coarse) {
+    // The residual of a coarse cell is the mean value over the volume of all of its children.
+    const Real normalizationFactor = Real(1.0) / Real(coarse.ci * coarse.cj * coarse.ck);
+
+    #pragma omp parallel for
+    for (int i = 1; i <= coarse.imax; i++) {
+        for (int j = 1; j <= coarse.jmax; j++) {
+            for (int k = 1; k <= coarse.kmax; k++) {
+                Real residualSum = Real(0.0);
+                for (int fi = (i-1)*coarse.ci+1; fi <= i*coarse.ci; fi++) {
+                    for (int fj = (j-1)*coarse.cj+1; fj <= j*coarse.cj; fj++) {
+                        for (int fk = (k-1)*coarse.ck+1; fk <= k*coarse.ck; fk++) {
+                            residualSum += fine.R[IDXRS_LEVEL(fine,fi,fj,fk)];
+                        }
+                    }
+                }
+                coarse.RS[IDXRS_LEVEL(coarse,i,j,k)] = residualSum * normalizationFactor;
+            }
+        }
+    }
+
+    // The coarse grid correction starts with an initial guess of zero.
+    memset(coarse.P, 0, sizeof(Real)*(coarse.imax+2)*(coarse.jmax+2)*(coarse.kmax+2));
+}
+
+void prolongateCorrectionCpp(const MultigridLevelCpp &coarse, MultigridLevelCpp &fine) {
+    // Trilinear interpolation of the correction. Each fine cell lies at a distance of a quarter coarse cell from the
+    // center of its parent cell, which gives the weights 3/4 (parent) and 1/4 (neighbor of the parent).
+    // Only fluid cells in the interior of the coarse domain contribute, and the weights are renormalized accordingly.
+    // This corresponds to the Neumann boundary conditions at the domain boundary and at obstacles.
+    #pragma omp parallel for
+    for (int i = 1; i <= fine.imax; i++) {
+        for (int j = 1; j <= fine.jmax; j++) {
+            for (int k = 1; k <= fine.kmax; k++) {
+                if (!isFluid(fine.Flag[IDXFLAG_LEVEL(fine,i,j,k)])) {
+                    continue;
+                }
+
+                const int ic = (i + coarse.ci - 1) / coarse.ci;
+                const int jc = (j + coarse.cj - 1) / coarse.cj;
+                const int kc = (k + coarse.ck - 1) / coarse.ck;
+                const int si = coarse.ci == 1 ? 0 : (i % 2 == 1 ? -1 : 1);
+                const int sj = coarse.cj == 1 ? 0 : (j % 2 == 1 ? -1 : 1);
+                const int sk = coarse.ck == 1 ? 0 : (k % 2 == 1 ? -1 : 1);
+
+                Real correction = Real(0.0);
+                Real weightSum = Real(0.0);
+                for (int a = 0; a <= std::abs(si); a++) {
+                    for (int b = 0; b <= std::abs(sj); b++) {
+                        for (int c = 0; c <= std::abs(sk); c++) {
+                            const int in = ic + a*si, jn = jc + b*sj, kn = kc + c*sk;
+                            if (in < 1 || jn < 1 || kn < 1 || in > coarse.imax || jn > coarse.jmax || kn > coarse.kmax
+                                    || !isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,in,jn,kn)])) {
+                                continue;
+                            }
+                            const Real weight = (si == 0 ? Real(1.0) : (a == 0 ? Real(0.75) : Real(0.25)))
+                                    * (sj == 0 ? Real(1.0) : (b == 0 ? Real(0.75) : Real(0.25)))
+                                    * (sk == 0 ? Real(1.0) : (c == 0 ? Real(0.75) : Real(0.25)));
+                            correction += weight * coarse.P[IDXP_LEVEL(coarse,in,jn,kn)];
+                            weightSum += weight;
+                        }
+                    }
+                }
+
+                // The parent cell is always a fluid cell, thus weightSum > 0.
+                fine.P[IDXP_LEVEL(fine,i,j,k)] += correction / weightSum;
+            }
+        }
+    }
+}
+
+void multigridCycleCpp(std::vector<MultigridLevelCpp> &multigridLevels, size_t l, int gamma) {
+    MultigridLevelCpp &level = multigridLevels.at(l);
+    if (l == multigridLevels.size() - 1) {
+        solveCoarsestLevelCpp(level);
+        return;
+    }
+
+    MultigridLevelCpp &coarseLevel = multigridLevels.at(l + 1);
+    smoothMultigridLevelCpp(level, NUM_PRE_SMOOTHING_SWEEPS);
+    computeResidualMultigridCpp(level);
+    restrictResidualCpp(level, coarseLevel);
+
+    // gamma = 1: V-cycle, gamma = 2: W-cycle.
+    for (int i = 0; i < gamma; i++) {
+        multigridCycleCpp(multigridLevels, l + 1, gamma);
+    }
+
+    prolongateCorrectionCpp(coarseLevel, level);
+    smoothMultigridLevelCpp(level, NUM_POST_SMOOTHING_SWEEPS);
+}
+
+void multigridSolverCpp(
+        Real eps, int itermax, bool useWCycle, std::vector<MultigridLevelCpp> &multigridLevels,
+        Real &residual, int &it) {
+    MultigridLevelCpp &fineLevel = multigridLevels.front();
+    subtractMeanRsCpp(fineLevel.imax, fineLevel.jmax, fineLevel.kmax, fineLevel.RS, fineLevel.Flag);
+
+    const int gamma = useWCycle ? 2 : 1;
+    while (it < itermax && residual > eps) {
+        multigridCycleCpp(multigridLevels, 0, gamma);
+        setPressureBoundaryValuesCpp(fineLevel.imax, fineLevel.jmax, fineLevel.kmax, fineLevel.P, fineLevel.Flag);
+        residual = computeResidualNormCpp(
+                fineLevel.dx, fineLevel.dy, fineLevel.dz, fineLevel.imax, fineLevel.jmax, fineLevel.kmax,
+                fineLevel.P, fineLevel.RS, fineLevel.Flag);
+        it++;
+    }
+}
+
+}
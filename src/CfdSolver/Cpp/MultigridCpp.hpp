@@ -0,0 +1,92 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_MULTIGRIDCPP_HPP
+#define CFD3D_MULTIGRIDCPP_HPP
+
+#include <vector>
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * One level of the geometric multigrid hierarchy. Level 0 is the simulation grid itself, and every following level is
+ * coarsened by a factor of two in all directions where this is possible (semi-coarsening is used for directions with an
+ * odd number of cells or with a cell size much larger than the cell size in the other directions). Coarsening stops
+ * when all directions have an odd number of cells, less than four cells or a too large cell size.
+ * On the coarse levels, P stores the correction of the pressure and RS the restricted residual of the finer level.
+ */
+struct MultigridLevelCpp {
+    int imax, jmax, kmax;
+    // Coarsening factor (1 or 2) in x, y and z direction with respect to the next finer level.
+    int ci, cj, ck;
+    Real dx, dy, dz;
+    // Arrays of the level. For level 0, P, P_temp, RS and Flag belong to the solver and are not freed.
+    Real *P, *P_temp, *RS, *R;
+    FlagType *Flag;
+    // Axis of the zebra line relaxation smoother (@see LineRelaxationCpp.hpp) or -1 if the damped Jacobi smoother is
+    // used. The pressure operator is only created for the line smoother.
+    int lineRelaxationAxis;
+    PressureOperatorCpp pressureOperator;
+};
+
+/**
+ * Creates the multigrid hierarchy for the passed grid. The Flag array is coarsened together with the grid. A coarse
+ * cell is a fluid cell if at least one of the fine cells it consists of is a fluid cell.
+ * @param multigridLevels The list of levels to fill (level 0 is the passed fine grid).
+ */
+void createMultigridHierarchyCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *P, Real *P_temp, Real *RS, FlagType *Flag,
+        std::vector<MultigridLevelCpp> &multigridLevels);
+
+/**
+ * Frees the memory of the coarse levels created by createMultigridHierarchyCpp.
+ */
+void destroyMultigridHierarchyCpp(std::vector<MultigridLevelCpp> &multigridLevels);
+
+/**
+ * Solves the Pressure Poisson Equation (PPE) on level 0 of the passed hierarchy using geometric multigrid cycles.
+ * Damped Jacobi sweeps are used as the smoother on levels with (almost) isotropic cells. On levels where the cells are
+ * much smaller along one axis than along the two other axes, zebra line relaxation along this axis is used instead.
+ * The coarsest level is solved approximately with SOR.
+ * @param eps The residual value (epsilon) for which the solution is considered as converged.
+ * @param itermax The maximum number of multigrid cycles.
+ * @param useWCycle Whether to use W-cycles (true) or V-cycles (false).
+ * @param multigridLevels The multigrid hierarchy.
+ * @param residual The residual after the last cycle.
+ * @param it The number of cycles performed.
+ */
+void multigridSolverCpp(
+        Real eps, int itermax, bool useWCycle, std::vector<MultigridLevelCpp> &multigridLevels,
+        Real &residual, int &it);
+
+}
+
+#endif //CFD3D_MULTIGRIDCPP_HPP
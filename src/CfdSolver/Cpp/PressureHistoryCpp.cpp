@@ -0,0 +1,220 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include "../Flag.hpp"
+#include "PressureHistoryCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createPressureHistoryCpp(int maxSize, int imax, int jmax, int kmax, PressureHistoryCpp &pressureHistory) {
+    pressureHistory.maxSize = maxSize;
+    pressureHistory.numStored = 0;
+    pressureHistory.nextSlot = 0;
+    pressureHistory.gramMatrix.resize(maxSize*maxSize, 0.0);
+    for (int slot = 0; slot < maxSize; slot++) {
+        Real *solution = new Real[(imax+2)*(jmax+2)*(kmax+2)];
+        Real *operatorSolution = new Real[(imax+1)*(jmax+1)*(kmax+1)];
+        memset(solution, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
+        memset(operatorSolution, 0, sizeof(Real)*(imax+1)*(jmax+1)*(kmax+1));
+        pressureHistory.solutions.push_back(solution);
+        pressureHistory.operatorSolutions.push_back(operatorSolution);
+    }
+}
+
+void destroyPressureHistoryCpp(PressureHistoryCpp &pressureHistory) {
+    for (Real *solution : pressureHistory.solutions) {
+        delete[] solution;
+    }
+    for (Real *operatorSolution : pressureHistory.operatorSolutions) {
+        delete[] operatorSolution;
+    }
+    pressureHistory = PressureHistoryCpp();
+}
+
+/**
+ * Computes the dot product of two arrays with the size of the RS array (in double precision).
+ */
+double dotProductRsCpp(int imax, int jmax, int kmax, const Real *A, const Real *B) {
+    double dotProduct = 0.0;
+    #pragma omp parallel for reduction(+: dotProduct)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                dotProduct += double(A[IDXRS(i,j,k)]) * double(B[IDXRS(i,j,k)]);
+            }
+        }
+    }
+    return dotProduct;
+}
+
+bool solvePressureHistoryNormalEquations(
+        int maxSize, const std::vector<double> &gramMatrix, const std::vector<int> &slots,
+        const std::vector<double> &b, std::vector<double> &c) {
+    const int n = int(slots.size());
+    const std::vector<double> &G = gramMatrix;
+
+    // Solve the normal equations G c = b using a Cholesky decomposition. Solutions that are (numerically) linearly
+    // dependent on the newer solutions are skipped, as they would only amplify rounding errors.
+    const double threshold = 100.0 * std::numeric_limits<Real>::epsilon();
+    std::vector<double> L(n*n, 0.0), y(n, 0.0);
+    std::vector<bool> active(n, false);
+    c.assign(n, 0.0);
+    for (int a = 0; a < n; a++) {
+        const double Gaa = G[slots[a]*maxSize + slots[a]];
+        double pivot = Gaa;
+        for (int e = 0; e < a; e++) {
+            if (!active[e]) {
+                continue;
+            }
+            double value = G[slots[a]*maxSize + slots[e]];
+            for (int f = 0; f < e; f++) {
+                value -= L[a*n + f] * L[e*n + f];
+            }
+            L[a*n + e] = value / L[e*n + e];
+            pivot -= L[a*n + e] * L[a*n + e];
+        }
+        if (Gaa <= 0.0 || pivot <= threshold * Gaa) {
+            for (int e = 0; e < a; e++) {
+                L[a*n + e] = 0.0;
+            }
+            continue;
+        }
+        L[a*n + a] = std::sqrt(pivot);
+        active[a] = true;
+
+        y[a] = b[a];
+        for (int e = 0; e < a; e++) {
+            y[a] -= L[a*n + e] * y[e];
+        }
+        y[a] /= L[a*n + a];
+    }
+    for (int a = n - 1; a >= 0; a--) {
+        if (!active[a]) {
+            continue;
+        }
+        c[a] = y[a];
+        for (int e = a + 1; e < n; e++) {
+            c[a] -= L[e*n + a] * c[e];
+        }
+        c[a] /= L[a*n + a];
+    }
+    return n > 0 && active[0];
+}
+
+void computePressureInitialGuessCpp(
+        int imax, int jmax, int kmax, Real *P, Real *RS, PressureHistoryCpp &pressureHistory) {
+    const int n = pressureHistory.numStored;
+    const int maxSize = pressureHistory.maxSize;
+    if (n == 0) {
+        return;
+    }
+
+    // The newest solution comes first, such that it is never dropped as linearly dependent.
+    std::vector<int> slots(n);
+    std::vector<double> b(n), c;
+    for (int l = 0; l < n; l++) {
+        slots[l] = (pressureHistory.nextSlot - 1 - l + maxSize) % maxSize;
+        // A x_i is zero in all non-fluid cells, so RS doesn't need to be masked.
+        b[l] = dotProductRsCpp(imax, jmax, kmax, pressureHistory.operatorSolutions[slots[l]], RS);
+    }
+    if (!solvePressureHistoryNormalEquations(maxSize, pressureHistory.gramMatrix, slots, b, c)) {
+        // All stored solutions are zero.
+        return;
+    }
+
+    // The boundary values of the stored solutions are combined as well, so P satisfies the boundary conditions.
+    std::vector<Real> coefficients(n);
+    for (int a = 0; a < n; a++) {
+        coefficients[a] = Real(c[a]);
+    }
+    #pragma omp parallel for
+    for (int i = 0; i <= imax+1; i++) {
+        for (int j = 0; j <= jmax+1; j++) {
+            for (int k = 0; k <= kmax+1; k++) {
+                Real value = Real(0.0);
+                for (int a = 0; a < n; a++) {
+                    value += coefficients[a] * pressureHistory.solutions[slots[a]][IDXP(i,j,k)];
+                }
+                P[IDXP(i,j,k)] = value;
+            }
+        }
+    }
+}
+
+void addPressureSolutionCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, Real *P, FlagType *Flag,
+        PressureOperatorCpp &pressureOperator, PressureHistoryCpp &pressureHistory) {
+    const int maxSize = pressureHistory.maxSize;
+    const int slot = pressureHistory.nextSlot;
+    Real *solution = pressureHistory.solutions[slot];
+    Real *operatorSolution = pressureHistory.operatorSolutions[slot];
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+
+    memcpy(solution, P, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (coeffR != nullptr) {
+                    // The least-squares fit needs to minimize the residual of the operator that is actually solved.
+                    // Its coefficients are zero for all faces not coupling two fluid cells, so A x is zero in all
+                    // non-fluid cells.
+                    operatorSolution[IDXRS(i,j,k)] = applyCellPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P, coeffR, coeffU, coeffF);
+                } else if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    operatorSolution[IDXRS(i,j,k)] =
+                            (P[IDXP(i+1,j,k)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i-1,j,k)])/(dx*dx)
+                            + (P[IDXP(i,j+1,k)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i,j-1,k)])/(dy*dy)
+                            + (P[IDXP(i,j,k+1)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i,j,k-1)])/(dz*dz);
+                } else {
+                    operatorSolution[IDXRS(i,j,k)] = Real(0.0);
+                }
+            }
+        }
+    }
+
+    pressureHistory.numStored = std::min(pressureHistory.numStored + 1, maxSize);
+    pressureHistory.nextSlot = (slot + 1) % maxSize;
+
+    // Update the row and column of the Gram matrix belonging to the new solution.
+    for (int l = 0; l < pressureHistory.numStored; l++) {
+        int otherSlot = (slot - l + maxSize) % maxSize;
+        double dotProduct = dotProductRsCpp(
+                imax, jmax, kmax, operatorSolution, pressureHistory.operatorSolutions[otherSlot]);
+        pressureHistory.gramMatrix[slot*maxSize + otherSlot] = dotProduct;
+        pressureHistory.gramMatrix[otherSlot*maxSize + slot] = dotProduct;
+    }
+}
+
+}
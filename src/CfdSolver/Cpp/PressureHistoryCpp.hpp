@@ -0,0 +1,98 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_PRESSUREHISTORYCPP_HPP
+#define CFD3D_PRESSUREHISTORYCPP_HPP
+
+#include <vector>
+#include "Defines.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The pressure solutions of the last time steps, which are used for computing the initial guess of the next solve of
+ * the Pressure Poisson Equation (PPE). The initial guess is the linear combination of the stored solutions x_i whose
+ * image under the discrete Laplace operator A is closest to the right-hand side in the least-squares sense
+ * (i.e., min ||RS - sum_i c_i A x_i||). As the span contains the last solution, the initial residual is never larger
+ * than when simply starting from the last solution.
+ */
+struct PressureHistoryCpp {
+    // The maximum number of stored solutions (0 disables the projection).
+    int maxSize = 0;
+    // Ring buffer of the stored solutions (pressure array size) and of A applied to the solutions (RS array size).
+    std::vector<Real*> solutions, operatorSolutions;
+    // Number of stored solutions and index of the slot the next solution is stored in.
+    int numStored = 0, nextSlot = 0;
+    // Gram matrix (A x_i) * (A x_j) of the stored solutions (maxSize x maxSize, row-major).
+    std::vector<double> gramMatrix;
+};
+
+/**
+ * Allocates the memory for storing up to maxSize pressure solutions.
+ */
+void createPressureHistoryCpp(int maxSize, int imax, int jmax, int kmax, PressureHistoryCpp &pressureHistory);
+
+/**
+ * Frees the memory allocated by createPressureHistoryCpp.
+ */
+void destroyPressureHistoryCpp(PressureHistoryCpp &pressureHistory);
+
+/**
+ * Solves the normal equations G c = b of the least-squares problem min ||RS - sum_i c_i A x_i||.
+ * @param maxSize The maximum number of stored solutions (i.e., the row length of the Gram matrix).
+ * @param gramMatrix The Gram matrix (A x_i) * (A x_j) of the stored solutions.
+ * @param slots The slots of the stored solutions to use, ordered from the newest to the oldest solution.
+ * @param b The dot products (A x_i) * RS in the order of slots.
+ * @param c The coefficients of the solutions in the order of slots (zero for linearly dependent solutions).
+ * @return False if the newest solution is zero (i.e., no initial guess can be computed).
+ */
+bool solvePressureHistoryNormalEquations(
+        int maxSize, const std::vector<double> &gramMatrix, const std::vector<int> &slots,
+        const std::vector<double> &b, std::vector<double> &c);
+
+/**
+ * Overwrites P with the least-squares initial guess for the right-hand side RS. If no solution is stored yet, P is not
+ * changed.
+ */
+void computePressureInitialGuessCpp(
+        int imax, int jmax, int kmax, Real *P, Real *RS, PressureHistoryCpp &pressureHistory);
+
+/**
+ * Adds the solution P (including its boundary values) to the history. If the history is full, the oldest solution is
+ * replaced.
+ * @param pressureOperator The operator the linear solver iterates with. If it was not created (i.e., for the multigrid
+ * solver), the 7-point stencil together with the boundary values of P is used instead.
+ */
+void addPressureSolutionCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, Real *P, FlagType *Flag,
+        PressureOperatorCpp &pressureOperator, PressureHistoryCpp &pressureHistory);
+
+}
+
+#endif //CFD3D_PRESSUREHISTORYCPP_HPP
@@ -0,0 +1,236 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include "../Flag.hpp"
+#include "PressureOperatorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createPressureOperatorCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, FlagType *Flag,
+        PressureOperatorCpp &pressureOperator) {
+    const int size = (imax+2)*(jmax+2)*(kmax+2);
+    pressureOperator.coeffR = new Real[size];
+    pressureOperator.coeffU = new Real[size];
+    pressureOperator.coeffF = new Real[size];
+    pressureOperator.diagonalInverse = new Real[size];
+    memset(pressureOperator.coeffR, 0, sizeof(Real)*size);
+    memset(pressureOperator.coeffU, 0, sizeof(Real)*size);
+    memset(pressureOperator.coeffF, 0, sizeof(Real)*size);
+    memset(pressureOperator.diagonalInverse, 0, sizeof(Real)*size);
+
+    Real *coeffR = pressureOperator.coeffR;
+    Real *coeffU = pressureOperator.coeffU;
+    Real *coeffF = pressureOperator.coeffF;
+    Real *diagonalInverse = pressureOperator.diagonalInverse;
+
+    // A face only couples two cells if both of them are fluid cells. The ghost cells are never fluid cells.
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    if (i < imax && isFluid(Flag[IDXFLAG(i+1,j,k)])) {
+                        coeffR[IDXP(i,j,k)] = Real(1.0) / (dx*dx);
+                    }
+                    if (j < jmax && isFluid(Flag[IDXFLAG(i,j+1,k)])) {
+                        coeffU[IDXP(i,j,k)] = Real(1.0) / (dy*dy);
+                    }
+                    if (k < kmax && isFluid(Flag[IDXFLAG(i,j,k+1)])) {
+                        coeffF[IDXP(i,j,k)] = Real(1.0) / (dz*dz);
+                    }
+                }
+            }
+        }
+    }
+
+    int numFluidCells = 0;
+    #pragma omp parallel for reduction(+: numFluidCells)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                Real diagonal =
+                        coeffR[IDXP(i,j,k)] + coeffR[IDXP(i-1,j,k)]
+                        + coeffU[IDXP(i,j,k)] + coeffU[IDXP(i,j-1,k)]
+                        + coeffF[IDXP(i,j,k)] + coeffF[IDXP(i,j,k-1)];
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    diagonalInverse[IDXP(i,j,k)] = diagonal > Real(0.0) ? Real(1.0) / diagonal : Real(0.0);
+                    numFluidCells++;
+                }
+            }
+        }
+    }
+    pressureOperator.numFluidCells = numFluidCells;
+}
+
+void createPressureOperatorFloatCpp(
+        int imax, int jmax, int kmax, const PressureOperatorCpp &pressureOperator,
+        PressureOperatorFloatCpp &pressureOperatorFloat) {
+    const int size = (imax+2)*(jmax+2)*(kmax+2);
+    pressureOperatorFloat.coeffR = new float[size];
+    pressureOperatorFloat.coeffU = new float[size];
+    pressureOperatorFloat.coeffF = new float[size];
+    pressureOperatorFloat.diagonalInverse = new float[size];
+    pressureOperatorFloat.numFluidCells = pressureOperator.numFluidCells;
+
+    #pragma omp parallel for
+    for (int idx = 0; idx < size; idx++) {
+        pressureOperatorFloat.coeffR[idx] = float(pressureOperator.coeffR[idx]);
+        pressureOperatorFloat.coeffU[idx] = float(pressureOperator.coeffU[idx]);
+        pressureOperatorFloat.coeffF[idx] = float(pressureOperator.coeffF[idx]);
+        pressureOperatorFloat.diagonalInverse[idx] = float(pressureOperator.diagonalInverse[idx]);
+    }
+}
+
+template<typename T>
+void destroyPressureOperatorCpp(PressureOperatorTemplateCpp<T> &pressureOperator) {
+    delete[] pressureOperator.coeffR;
+    delete[] pressureOperator.coeffU;
+    delete[] pressureOperator.coeffF;
+    delete[] pressureOperator.diagonalInverse;
+    pressureOperator = PressureOperatorTemplateCpp<T>();
+}
+template void destroyPressureOperatorCpp<float>(PressureOperatorTemplateCpp<float> &pressureOperator);
+template void destroyPressureOperatorCpp<double>(PressureOperatorTemplateCpp<double> &pressureOperator);
+
+void maskRsPressureOperatorCpp(int imax, int jmax, int kmax, Real *RS, FlagType *Flag) {
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (!isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    RS[IDXRS(i,j,k)] = Real(0.0);
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+T pressureOperatorSweepCpp(
+        T omg, int imax, int jmax, int kmax, LinearSystemSolverType linearSystemSolverType,
+        T *&P, T *&P_temp, T *RS, PressureOperatorTemplateCpp<T> &pressureOperator) {
+    const T *coeffR = pressureOperator.coeffR;
+    const T *coeffU = pressureOperator.coeffU;
+    const T *coeffF = pressureOperator.coeffF;
+    const T *diagonalInverse = pressureOperator.diagonalInverse;
+    T residual = T(0.0);
+
+    if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL) {
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    T r = computeCellResidualPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P, P, RS, coeffR, coeffU, coeffF);
+                    residual += r*r;
+                    P[IDXP(i,j,k)] += omg * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+    } else if (linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL
+            || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL_PARALLEL) {
+        // The first pass stores the part of the residual depending on the cell itself and the right, upper and front
+        // neighbors in P_temp. The second pass adds the contribution of the already updated left, lower and back
+        // neighbors.
+        #pragma omp parallel for
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    const T cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                    const T cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                    const T cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                    P_temp[IDXP(i,j,k)] =
+                            cR*P[IDXP(i+1,j,k)] + cU*P[IDXP(i,j+1,k)] + cF*P[IDXP(i,j,k+1)]
+                            - RS[IDXRS(i,j,k)] - (cR + cL + cU + cD + cF + cB)*P[IDXP(i,j,k)];
+                }
+            }
+        }
+
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    T r = P_temp[IDXP(i,j,k)]
+                            + coeffR[IDXP(i-1,j,k)]*P[IDXP(i-1,j,k)]
+                            + coeffU[IDXP(i,j-1,k)]*P[IDXP(i,j-1,k)]
+                            + coeffF[IDXP(i,j,k-1)]*P[IDXP(i,j,k-1)];
+                    residual += r*r;
+                    P[IDXP(i,j,k)] += omg * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+    } else if (linearSystemSolverType == LINEAR_SOLVER_SOR_RED_BLACK
+            || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL_RED_BLACK) {
+        for (int color = 0; color < 2; color++) {
+            #pragma omp parallel for reduction(+: residual)
+            for (int i = 1; i <= imax; i++) {
+                for (int j = 1; j <= jmax; j++) {
+                    for (int k = 1 + (i + j + 1 + color) % 2; k <= kmax; k += 2) {
+                        T r = computeCellResidualPressureOperatorCpp(
+                                i, j, k, jmax, kmax, P, P, RS, coeffR, coeffU, coeffF);
+                        residual += r*r;
+                        P[IDXP(i,j,k)] += omg * diagonalInverse[IDXP(i,j,k)] * r;
+                    }
+                }
+            }
+        }
+    } else if (linearSystemSolverType == LINEAR_SOLVER_JACOBI
+            || linearSystemSolverType == LINEAR_SOLVER_JACOBI_TEMPORAL_BLOCKING) {
+        // The new values are written to P_temp and the buffers are swapped afterwards instead of copying P. All
+        // interior cells are written (non-fluid cells keep their value, as their inverse diagonal is zero), and the
+        // coefficients coupling to the ghost cells are zero, so both buffers stay consistent.
+        #pragma omp parallel for reduction(+: residual)
+        for (int i = 1; i <= imax; i++) {
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    T r = computeCellResidualPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P, P, RS, coeffR, coeffU, coeffF);
+                    residual += r*r;
+                    P_temp[IDXP(i,j,k)] = P[IDXP(i,j,k)] + omg * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+        std::swap(P, P_temp);
+    }
+
+    // The residual is normalized by dividing by the total number of fluid cells.
+    if (pressureOperator.numFluidCells == 0) {
+        return T(0.0);
+    }
+    return std::sqrt(residual/pressureOperator.numFluidCells);
+}
+template float pressureOperatorSweepCpp<float>(
+        float omg, int imax, int jmax, int kmax, LinearSystemSolverType linearSystemSolverType,
+        float *&P, float *&P_temp, float *RS, PressureOperatorTemplateCpp<float> &pressureOperator);
+template double pressureOperatorSweepCpp<double>(
+        double omg, int imax, int jmax, int kmax, LinearSystemSolverType linearSystemSolverType,
+        double *&P, double *&P_temp, double *RS, PressureOperatorTemplateCpp<double> &pressureOperator);
+
+}
@@ -0,0 +1,131 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_PRESSUREOPERATORCPP_HPP
+#define CFD3D_PRESSUREOPERATORCPP_HPP
+
+#include "Defines.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The discrete Laplace operator of the Pressure Poisson Equation (PPE) with the homogeneous Neumann boundary conditions
+ * at the domain boundary and at obstacles folded into per-cell coefficients. The coefficient of a cell face is
+ * 1/h^2 if both adjacent cells are fluid cells and 0 otherwise (i.e., dp/dn = 0 on the face). Thus, the relaxation
+ * sweeps neither need to set the pressure boundary values nor check the Flag array in every iteration.
+ * All arrays have the size of the pressure array. The operator is symmetric, so the coefficient of the left (lower,
+ * back) neighbor of cell (i,j,k) is the coefficient of the right (upper, front) neighbor of cell (i-1,j,k)
+ * ((i,j-1,k), (i,j,k-1)).
+ * The operator is templated on the floating point type, as the mixed precision solver (@see MixedPrecisionCpp.hpp)
+ * iterates on a single precision copy of the operator.
+ */
+template<typename T>
+struct PressureOperatorTemplateCpp {
+    // Coefficients of the neighbors (i+1,j,k), (i,j+1,k) and (i,j,k+1).
+    T *coeffR = nullptr, *coeffU = nullptr, *coeffF = nullptr;
+    // Inverse of the diagonal entry (i.e., the sum of the six neighbor coefficients). Zero for all non-fluid cells.
+    T *diagonalInverse = nullptr;
+    int numFluidCells = 0;
+};
+typedef PressureOperatorTemplateCpp<Real> PressureOperatorCpp;
+typedef PressureOperatorTemplateCpp<float> PressureOperatorFloatCpp;
+
+/**
+ * Allocates the arrays of the pressure operator and computes the coefficients from the Flag array.
+ */
+void createPressureOperatorCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, FlagType *Flag,
+        PressureOperatorCpp &pressureOperator);
+
+/**
+ * Creates a single precision copy of the passed pressure operator.
+ */
+void createPressureOperatorFloatCpp(
+        int imax, int jmax, int kmax, const PressureOperatorCpp &pressureOperator,
+        PressureOperatorFloatCpp &pressureOperatorFloat);
+
+/**
+ * Frees the memory allocated by createPressureOperatorCpp or createPressureOperatorFloatCpp.
+ */
+template<typename T>
+void destroyPressureOperatorCpp(PressureOperatorTemplateCpp<T> &pressureOperator);
+
+/**
+ * Sets the right-hand side to zero in all non-fluid cells. Non-fluid cells have no neighbor coefficients, so this way,
+ * they neither change their pressure value nor contribute to the residual in pressureOperatorSweepCpp.
+ */
+void maskRsPressureOperatorCpp(int imax, int jmax, int kmax, Real *RS, FlagType *Flag);
+
+/**
+ * Returns the residual of cell (i,j,k), where the neighbor values are read from P_neighbor and the value of the cell
+ * itself from P_center.
+ */
+template<typename T>
+inline T computeCellResidualPressureOperatorCpp(
+        int i, int j, int k, int jmax, int kmax, const T *P_neighbor, const T *P_center, const T *RS,
+        const T *coeffR, const T *coeffU, const T *coeffF) {
+    const T cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+    const T cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+    const T cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+    return cR*P_neighbor[IDXP(i+1,j,k)] + cL*P_neighbor[IDXP(i-1,j,k)]
+            + cU*P_neighbor[IDXP(i,j+1,k)] + cD*P_neighbor[IDXP(i,j-1,k)]
+            + cF*P_neighbor[IDXP(i,j,k+1)] + cB*P_neighbor[IDXP(i,j,k-1)]
+            - RS[IDXRS(i,j,k)] - (cR + cL + cU + cD + cF + cB)*P_center[IDXP(i,j,k)];
+}
+
+/**
+ * Returns the operator applied to P in cell (i,j,k) (i.e., the residual of cell (i,j,k) for a zero right-hand side).
+ */
+template<typename T>
+inline T applyCellPressureOperatorCpp(
+        int i, int j, int k, int jmax, int kmax, const T *P, const T *coeffR, const T *coeffU, const T *coeffF) {
+    const T cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+    const T cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+    const T cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+    return cR*P[IDXP(i+1,j,k)] + cL*P[IDXP(i-1,j,k)]
+            + cU*P[IDXP(i,j+1,k)] + cD*P[IDXP(i,j-1,k)]
+            + cF*P[IDXP(i,j,k+1)] + cB*P[IDXP(i,j,k-1)]
+            - (cR + cL + cU + cD + cF + cB)*P[IDXP(i,j,k)];
+}
+
+/**
+ * Performs one Jacobi or SOR relaxation sweep using the precomputed operator. The loops contain no branches and no
+ * boundary value passes. The Jacobi solver writes the new values to P_temp and swaps the two pointers afterwards, so P
+ * always points to the current values after the call. RS needs to be zero in all non-fluid cells
+ * (@see maskRsPressureOperatorCpp).
+ * @return The residual normalized by the number of fluid cells. It is computed during the sweep using the neighbor
+ * values the update of each cell is based on.
+ */
+template<typename T>
+T pressureOperatorSweepCpp(
+        T omg, int imax, int jmax, int kmax, LinearSystemSolverType linearSystemSolverType,
+        T *&P, T *&P_temp, T *RS, PressureOperatorTemplateCpp<T> &pressureOperator);
+
+}
+
+#endif //CFD3D_PRESSUREOPERATORCPP_HPP
@@ -29,13 +29,16 @@
 #include <iostream>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <omp.h>
 #include "../Flag.hpp"
 #include "SorSolverCpp.hpp"
 
-void sorSolverIterationCpp(
-        Real omg, Real dx, Real dy, Real dz, Real coeff, int imax, int jmax, int kmax,
-        LinearSystemSolverType linearSystemSolverType,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag, Real &residual) {
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void setPressureDomainBoundaryValuesCpp(int imax, int jmax, int kmax, Real *P) {
     // Set the boundary values for the pressure on the x-y-planes.
     #pragma omp parallel for
     for (int i = 1; i <= imax; i++) {
@@ -62,6 +65,10 @@ void sorSolverIterationCpp(
             P[IDXP(imax+1,j,k)] = P[IDXP(imax,j,k)];
         }
     }
+}
+
+void setPressureBoundaryValuesCpp(int imax, int jmax, int kmax, Real *P, FlagType *Flag) {
+    setPressureDomainBoundaryValuesCpp(imax, jmax, kmax, P);
 
     // Boundary values for arbitrary geometries.
     #pragma omp parallel for
@@ -111,86 +118,69 @@ void sorSolverIterationCpp(
             }     
         }
     }
+}
 
-
-
-    if (linearSystemSolverType == LINEAR_SOLVER_JACOBI) {
-        // Create a copy of the current state of the pressure array.
-        // A parallel loop is potentially faster than 'memcpy' for large domains.
-        #pragma omp parallel for
-        for (int i = 0; i <= imax+1; i++) {
-            for (int j = 0; j <= jmax+1; j++) {
-                for (int k = 0; k <= kmax+1; k++) {
-                    P_temp[IDXP(i, j, k)] = P[IDXP(i, j, k)];
-                }
-            }
-        }
-    }
-
+Real sorSolverSweepCpp(
+        Real omg, Real dx, Real dy, Real dz, Real coeff, int imax, int jmax, int kmax,
+        LinearSystemSolverType linearSystemSolverType,
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag) {
+    // The residual of each cell is computed from the same neighbor sum as the update. For the Jacobi solver, this is
+    // the residual of the pressure values before the sweep. For Gauss-Seidel type solvers, the already updated
+    // neighbors are used (i.e., the residual is the correction of the cell divided by coeff).
+    const Real diagonal = Real(2.0) * (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy) + Real(1.0) / (dz*dz));
+    Real residual = Real(0.0);
+    int numFluidCells = 0;
 
     if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL) {
         for (int i = 1; i <= imax; i++) {
             for (int j = 1; j <= jmax; j++) {
                 for (int k = 1; k <= kmax; k++) {
                     if (isFluid(Flag[IDXFLAG(i,j,k)])){
-                        P[IDXP(i,j,k)] = (Real(1.0) - omg)*P[IDXP(i,j,k)] + coeff *
-                                ((P[IDXP(i+1,j,k)]+P[IDXP(i-1,j,k)])/(dx*dx)
+                        Real neighborSum =
+                                (P[IDXP(i+1,j,k)]+P[IDXP(i-1,j,k)])/(dx*dx)
                                 + (P[IDXP(i,j+1,k)]+P[IDXP(i,j-1,k)])/(dy*dy)
                                 + (P[IDXP(i,j,k+1)]+P[IDXP(i,j,k-1)])/(dz*dz)
-                                - RS[IDXRS(i,j,k)]);
-                    }
-                }
-            }
-        }
-    } else if (linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL
-            || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL_PARALLEL) {
-        #pragma omp parallel for
-        for (int i = 1; i <= imax; i++) {
-            for (int j = 1; j <= jmax; j++) {
-                for (int k = 1; k <= kmax; k++) {
-                    if (isFluid(Flag[IDXFLAG(i,j,k)])){
-                        P_temp[IDXP(i,j,k)] = (Real(1.0) - omg)*P[IDXP(i,j,k)] + coeff *
-                                ((P[IDXP(i+1,j,k)])/(dx*dx)
-                                + (P[IDXP(i,j+1,k)])/(dy*dy)
-                                + (P[IDXP(i,j,k+1)])/(dz*dz)
-                                - RS[IDXRS(i,j,k)]);
-                    }
-                }
-            }
-        }
-
-        for (int i = 1; i <= imax; i++) {
-            for (int j = 1; j <= jmax; j++) {
-                for (int k = 1; k <= kmax; k++) {
-                    if (isFluid(Flag[IDXFLAG(i,j,k)])){
-                        P[IDXP(i,j,k)] = P_temp[IDXP(i,j,k)] + coeff *
-                                ((P[IDXP(i-1,j,k)])/(dx*dx)
-                                 + (P[IDXP(i,j-1,k)])/(dy*dy)
-                                 + (P[IDXP(i,j,k-1)])/(dz*dz));
+                                - RS[IDXRS(i,j,k)];
+                        residual += SQR(neighborSum - diagonal*P[IDXP(i,j,k)]);
+                        numFluidCells++;
+                        P[IDXP(i,j,k)] = (Real(1.0) - omg)*P[IDXP(i,j,k)] + coeff * neighborSum;
                     }
                 }
             }
         }
     } else if (linearSystemSolverType == LINEAR_SOLVER_JACOBI) {
-        #pragma omp parallel for
+        #pragma omp parallel for reduction(+: residual) reduction(+: numFluidCells)
         for (int i = 1; i <= imax; i++) {
             for (int j = 1; j <= jmax; j++) {
                 for (int k = 1; k <= kmax; k++) {
                     if (isFluid(Flag[IDXFLAG(i,j,k)])) {
-                        P[IDXP(i,j,k)] = (Real(1.0) - omg)*P_temp[IDXP(i,j,k)] + coeff *
-                                ((P_temp[IDXP(i+1,j,k)]+P_temp[IDXP(i-1,j,k)])/(dx*dx)
-                                 + (P_temp[IDXP(i,j+1,k)]+P_temp[IDXP(i,j-1,k)])/(dy*dy)
-                                 + (P_temp[IDXP(i,j,k+1)]+P_temp[IDXP(i,j,k-1)])/(dz*dz)
-                                 - RS[IDXRS(i,j,k)]);
+                        Real neighborSum =
+                                (P[IDXP(i+1,j,k)]+P[IDXP(i-1,j,k)])/(dx*dx)
+                                + (P[IDXP(i,j+1,k)]+P[IDXP(i,j-1,k)])/(dy*dy)
+                                + (P[IDXP(i,j,k+1)]+P[IDXP(i,j,k-1)])/(dz*dz)
+                                - RS[IDXRS(i,j,k)];
+                        residual += SQR(neighborSum - diagonal*P[IDXP(i,j,k)]);
+                        numFluidCells++;
+                        P_temp[IDXP(i,j,k)] = (Real(1.0) - omg)*P[IDXP(i,j,k)] + coeff * neighborSum;
                     }
                 }
             }
         }
+        // Swapping the buffers replaces copying the whole pressure array before each sweep.
+        std::swap(P, P_temp);
     }
 
+    // The residual is normalized by dividing by the total number of fluid cells.
+    if (numFluidCells == 0) {
+        return Real(0.0);
+    }
+    return std::sqrt(residual/numFluidCells);
+}
 
+Real computeResidualNormCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, Real *P, Real *RS, FlagType *Flag) {
     // Compute the residual.
-    residual = Real(0.0);
+    Real residual = Real(0.0);
     int numFluidCells = 0;
     #pragma omp parallel for reduction(+: residual) reduction(+: numFluidCells)
     for (int i = 1; i <= imax; i++) {
@@ -210,31 +200,300 @@ void sorSolverIterationCpp(
     }
 
     // The residual is normalized by dividing by the total number of fluid cells.
-    residual = std::sqrt(residual/numFluidCells);
+    return std::sqrt(residual/numFluidCells);
 }
 
-void sorSolverCpp(
-        Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag) {
-    if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL) {
-        // Successive over-relaxation based on Gauss-Seidl. A factor of 1.2 proved to give the best results here.
-        omg = 1.2;
-    } else {
-        // A method named JOR (Jacobi over-relaxation) with omega != 1 exists, but doesn't converge for this problem.
-        omg = 1.0;
+Real computeRsNormCpp(int imax, int jmax, int kmax, Real *RS, FlagType *Flag) {
+    Real rsSum = Real(0.0);
+    int numFluidCells = 0;
+    #pragma omp parallel for reduction(+: rsSum) reduction(+: numFluidCells)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    rsSum += SQR(RS[IDXRS(i,j,k)]);
+                    numFluidCells++;
+                }
+            }
+        }
+    }
+    return numFluidCells == 0 ? Real(0.0) : std::sqrt(rsSum/numFluidCells);
+}
+
+void subtractMeanRsCpp(int imax, int jmax, int kmax, Real *RS, FlagType *Flag) {
+    Real rsSum = Real(0.0);
+    int numFluidCells = 0;
+    #pragma omp parallel for reduction(+: rsSum) reduction(+: numFluidCells)
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    rsSum += RS[IDXRS(i,j,k)];
+                    numFluidCells++;
+                }
+            }
+        }
+    }
+    if (numFluidCells == 0) {
+        return;
+    }
+
+    const Real rsMean = rsSum / Real(numFluidCells);
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    RS[IDXRS(i,j,k)] -= rsMean;
+                }
+            }
+        }
+    }
+}
+
+Real jacobiTemporalBlockingCpp(
+        Real omg, int numIterations, int imax, int jmax, int kmax, Real *&P, Real *&P_temp, Real *RS,
+        PressureOperatorCpp &pressureOperator) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    Real *buffers[2] = { P, P_temp };
+    Real residual = Real(0.0);
+
+    // Iteration t reads buffers[t%2] and writes buffers[(t+1)%2]. In wavefront step w, iteration t updates the x-plane
+    // i = w - t. All planes it depends on (i-1, i, i+1 of iteration t-1) were computed either in an earlier wavefront
+    // step or earlier in the same step, and the values it overwrites (iteration t-2 of plane i) are no longer needed.
+    // Thus, only the numIterations+2 most recent planes are accessed in each step, and they stay in the cache.
+    // The planes at the start and end of the domain are handled by skipping the iterations outside of the domain.
+    #pragma omp parallel
+    for (int wave = 1; wave <= imax + numIterations - 1; wave++) {
+        for (int t = 0; t < numIterations; t++) {
+            const int i = wave - t;
+            if (i < 1 || i > imax) {
+                continue;
+            }
+            const Real *P_src = buffers[t % 2];
+            Real *P_dst = buffers[(t + 1) % 2];
+            const bool isLastIteration = t == numIterations - 1;
+
+            #pragma omp for reduction(+: residual)
+            for (int j = 1; j <= jmax; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    Real r = computeCellResidualPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P_src, P_src, RS, coeffR, coeffU, coeffF);
+                    if (isLastIteration) {
+                        residual += r*r;
+                    }
+                    P_dst[IDXP(i,j,k)] = P_src[IDXP(i,j,k)] + omg * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+    }
+
+    // After an odd number of iterations, the result is stored in P_temp.
+    if (numIterations % 2 == 1) {
+        std::swap(P, P_temp);
+    }
+
+    // The residual is normalized by dividing by the total number of fluid cells.
+    if (pressureOperator.numFluidCells == 0) {
+        return Real(0.0);
+    }
+    return std::sqrt(residual/pressureOperator.numFluidCells);
+}
+
+/**
+ * The number of the last x-plane a thread of sorWavefrontSweepCpp has finished. The padding places the counters of
+ * different threads in different cache lines.
+ */
+struct WavefrontProgressCpp {
+    std::atomic<int> plane;
+    char padding[64 - sizeof(std::atomic<int>)];
+};
+
+Real sorWavefrontSweepCpp(
+        Real omg, int imax, int jmax, int kmax, Real *P, Real *P_temp, Real *RS,
+        PressureOperatorCpp &pressureOperator, bool computeResidual) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+
+    const int maxNumThreads = std::min(omp_get_max_threads(), jmax);
+    std::vector<WavefrontProgressCpp> progress(maxNumThreads);
+    for (int t = 0; t < maxNumThreads; t++) {
+        progress[t].plane.store(0, std::memory_order_relaxed);
+    }
+
+    #pragma omp parallel num_threads(maxNumThreads)
+    {
+        const int threadIdx = omp_get_thread_num();
+        const int numThreads = omp_get_num_threads();
+        const int jl = 1 + threadIdx * jmax / numThreads;
+        const int ju = (threadIdx + 1) * jmax / numThreads;
+
+        for (int i = 1; i <= imax; i++) {
+            // The lower neighbors of the first line of the block need to be updated already. The upper neighbors of the
+            // last line are not updated yet, as the next thread waits for this thread before updating plane i.
+            if (threadIdx > 0) {
+                while (progress[threadIdx - 1].plane.load(std::memory_order_acquire) < i) {
+                    std::this_thread::yield();
+                }
+            }
+            for (int j = jl; j <= ju; j++) {
+                for (int k = 1; k <= kmax; k++) {
+                    Real r = computeCellResidualPressureOperatorCpp(
+                            i, j, k, jmax, kmax, P, P, RS, coeffR, coeffU, coeffF);
+                    if (computeResidual) {
+                        P_temp[IDXP(i,j,k)] = r;
+                    }
+                    P[IDXP(i,j,k)] += omg * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+            progress[threadIdx].plane.store(i, std::memory_order_release);
+        }
     }
 
-    const Real coeff = omg / (Real(2.0) * (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy) + Real(1.0) / (dz*dz)));
+    if (!computeResidual || pressureOperator.numFluidCells == 0) {
+        return Real(0.0);
+    }
 
+    // A parallel reduction would sum up the residuals in a different order than the serial sweep.
+    Real residual = Real(0.0);
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                Real r = P_temp[IDXP(i,j,k)];
+                residual += r*r;
+            }
+        }
+    }
+    return std::sqrt(residual/pressureOperator.numFluidCells);
+}
+
+void sorSolverCpp(
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag,
+        std::vector<MultigridLevelCpp> &multigridLevels, ConjugateGradientDataCpp &cgData,
+        PressureOperatorCpp &pressureOperator, DctSolverDataCpp &dctData, MixedPrecisionDataCpp &mixedPrecisionData,
+        ChebyshevDataCpp &chebyshevData, CompressedPressureOperatorCpp &compressedOperator,
+        AdaptiveOmegaData &adaptiveOmegaData) {
     Real residual = Real(1e9);
     int it = 0;
 
-    while (it < itermax && residual > eps) {
-        sorSolverIterationCpp(
-                omg, dx, dy, dz, coeff, imax, jmax, kmax, linearSystemSolverType,
-                P, P_temp, RS, Flag, residual);
-        it++;
+    if (linearSystemSolverType == LINEAR_SOLVER_MULTIGRID
+            || linearSystemSolverType == LINEAR_SOLVER_MULTIGRID_W_CYCLE) {
+        multigridSolverCpp(
+                eps, itermax, linearSystemSolverType == LINEAR_SOLVER_MULTIGRID_W_CYCLE, multigridLevels,
+                residual, it);
+    } else if (linearSystemSolverType == LINEAR_SOLVER_PCG_JACOBI
+            || linearSystemSolverType == LINEAR_SOLVER_PCG_SGS) {
+        conjugateGradientSolverCpp(
+                eps, itermax, linearSystemSolverType == LINEAR_SOLVER_PCG_SGS, imax, jmax, kmax,
+                P, RS, Flag, pressureOperator, cgData, residual, it);
+    } else if (linearSystemSolverType == LINEAR_SOLVER_DCT) {
+        // Direct solver, so the result is exact up to rounding errors.
+        dctSolverCpp(imax, jmax, kmax, P, RS, Flag, dctData);
+        residual = Real(0.0);
+        it = 1;
+    } else {
+        const bool isSor = linearSystemSolverType == LINEAR_SOLVER_SOR
+                || linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL
+                || linearSystemSolverType == LINEAR_SOLVER_SOR_RED_BLACK
+                || linearSystemSolverType == LINEAR_SOLVER_SOR_WAVEFRONT
+                || linearSystemSolverType == LINEAR_SOLVER_ZEBRA_LINE;
+        const bool isWavefront = linearSystemSolverType == LINEAR_SOLVER_SOR_WAVEFRONT
+                || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL_WAVEFRONT;
+        const bool useCompressedOperator = compressedOperator.cellIndices != nullptr;
+        const bool estimateOmega = isSor && adaptiveOmegaData.isEnabled;
+        if (estimateOmega) {
+            // The factor estimated in the last solves (or 1, i.e., Gauss-Seidel, in the first solve).
+            omg = adaptiveOmegaData.omg;
+        } else if (isSor) {
+            // Successive over-relaxation based on Gauss-Seidl. A factor of 1.2 proved to give the best results here.
+            omg = 1.2;
+        } else {
+            // A method named JOR (Jacobi over-relaxation) with omega != 1 exists, but doesn't converge for this problem.
+            omg = 1.0;
+        }
+
+        // The boundary conditions are part of the precomputed operator, so no boundary values need to be set in the
+        // iterations. Only the right-hand side in the non-fluid cells needs to be cleared once (the compressed operator
+        // only reads the right-hand side of the fluid cells).
+        if (!useCompressedOperator) {
+            maskRsPressureOperatorCpp(imax, jmax, kmax, RS, Flag);
+        }
+
+        if (linearSystemSolverType == LINEAR_SOLVER_CHEBYSHEV) {
+            chebyshevSolverCpp(
+                    eps, itermax, residualCheckInterval, imax, jmax, kmax, P, RS, pressureOperator, chebyshevData,
+                    residual, it);
+        } else if (mixedPrecisionData.E != nullptr && linearSystemSolverType != LINEAR_SOLVER_ZEBRA_LINE
+                && !isWavefront) {
+            mixedPrecisionSolverCpp(
+                    omg, eps, itermax, residualCheckInterval, linearSystemSolverType, imax, jmax, kmax, P, RS,
+                    pressureOperator, mixedPrecisionData, residual, it);
+        } else if (linearSystemSolverType == LINEAR_SOLVER_JACOBI_TEMPORAL_BLOCKING) {
+            // The convergence can only be checked after a whole block of iterations.
+            const int blockSize = std::max(residualCheckInterval, JACOBI_TEMPORAL_BLOCK_SIZE);
+            while (it < itermax && residual > eps) {
+                int numIterations = std::min(blockSize, itermax - it);
+                residual = jacobiTemporalBlockingCpp(
+                        omg, numIterations, imax, jmax, kmax, P, P_temp, RS, pressureOperator);
+                it += numIterations;
+            }
+        } else {
+            Real residualEstimationStart = Real(0.0);
+            const int lineRelaxationAxis = selectLineRelaxationAxisCpp(dx, dy, dz);
+            if (useCompressedOperator) {
+                gatherCompressedPressureCpp(P, RS, compressedOperator);
+            }
+            while (it < itermax && residual > eps) {
+                Real sweepResidual;
+                if (linearSystemSolverType == LINEAR_SOLVER_ZEBRA_LINE) {
+                    sweepResidual = zebraLineRelaxationSweepCpp(
+                            omg, lineRelaxationAxis, imax, jmax, kmax, P, RS, pressureOperator);
+                } else if (isWavefront) {
+                    // Computing the residual needs an additional serial pass, so it is only done when it is used.
+                    const bool computeResidual = (it + 1) % residualCheckInterval == 0 || it + 1 == itermax
+                            || (estimateOmega && (it + 1 == ADAPTIVE_OMEGA_ESTIMATION_START
+                                    || it + 1 == ADAPTIVE_OMEGA_ESTIMATION_END));
+                    sweepResidual = sorWavefrontSweepCpp(
+                            omg, imax, jmax, kmax, P, P_temp, RS, pressureOperator, computeResidual);
+                } else if (useCompressedOperator) {
+                    sweepResidual = compressedPressureOperatorSweepCpp(omg, linearSystemSolverType, compressedOperator);
+                } else {
+                    sweepResidual = pressureOperatorSweepCpp(
+                            omg, imax, jmax, kmax, linearSystemSolverType, P, P_temp, RS, pressureOperator);
+                }
+                it++;
+
+                // The residual of each sweep is available anyway, so estimating the convergence factor is free.
+                if (estimateOmega && it == ADAPTIVE_OMEGA_ESTIMATION_START) {
+                    residualEstimationStart = sweepResidual;
+                } else if (estimateOmega && it == ADAPTIVE_OMEGA_ESTIMATION_END) {
+                    updateAdaptiveOmega(residualEstimationStart, sweepResidual, adaptiveOmegaData);
+                    omg = adaptiveOmegaData.omg;
+                }
+
+                // Convergence is only checked every residualCheckInterval iterations.
+                if (it % residualCheckInterval == 0 || it == itermax) {
+                    residual = sweepResidual;
+                }
+            }
+            if (useCompressedOperator) {
+                scatterCompressedPressureCpp(P, compressedOperator);
+            }
+        }
+
+        // The values in the ghost cells and obstacle cells are only needed for the velocity update and the output.
+        if (useCompressedOperator) {
+            setPressureBoundaryValuesCompressedCpp(imax, jmax, kmax, P, compressedOperator);
+        } else {
+            setPressureBoundaryValuesCpp(imax, jmax, kmax, P, Flag);
+        }
     }
 
     if (((residual > eps && it == itermax) || std::isnan(residual)) && shallWriteOutput) {
@@ -246,3 +505,5 @@ void sorSolverCpp(
         exit(1);
     }
 }
+
+}
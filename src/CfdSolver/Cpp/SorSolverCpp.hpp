@@ -29,14 +29,124 @@
 #ifndef CFD3D_SORSOLVERCPP_HPP
 #define CFD3D_SORSOLVERCPP_HPP
 
+#include <vector>
 #include "Defines.hpp"
+#include "MultigridCpp.hpp"
+#include "ConjugateGradientCpp.hpp"
+#include "PressureOperatorCpp.hpp"
+#include "DctSolverCpp.hpp"
+#include "MixedPrecisionCpp.hpp"
+#include "ChebyshevCpp.hpp"
+#include "LineRelaxationCpp.hpp"
+#include "CompressedPressureOperatorCpp.hpp"
+#include "CfdSolver/AdaptiveOmega.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Sets the pressure values in the ghost cells at the domain boundary (but not in the obstacle cells), such that the
+ * homogeneous Neumann boundary condition dp/dn = 0 holds.
+ */
+void setPressureDomainBoundaryValuesCpp(int imax, int jmax, int kmax, Real *P);
+
+/**
+ * Sets the pressure values in the ghost cells at the domain boundary and in obstacle cells next to fluid cells, such
+ * that the homogeneous Neumann boundary condition dp/dn = 0 holds.
+ */
+void setPressureBoundaryValuesCpp(int imax, int jmax, int kmax, Real *P, FlagType *Flag);
+
+/**
+ * Performs one Jacobi or lexicographic SOR/Gauss-Seidel relaxation sweep over all fluid cells (without updating the
+ * boundary values first). It is used by the multigrid smoother and the coarsest-level solve. The Jacobi solver writes the new values of the fluid cells to P_temp and swaps the two pointers afterwards. The
+ * values in the non-fluid cells of the new P are stale and need to be set before they are read.
+ * @return The residual normalized by the number of fluid cells. It is computed during the sweep using the neighbor
+ * values the update of each cell is based on.
+ */
+Real sorSolverSweepCpp(
+        Real omg, Real dx, Real dy, Real dz, Real coeff, int imax, int jmax, int kmax,
+        LinearSystemSolverType linearSystemSolverType,
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag);
+
+/**
+ * Computes the residual of the PPE normalized by the number of fluid cells.
+ */
+Real computeResidualNormCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, Real *P, Real *RS, FlagType *Flag);
+
+/**
+ * Computes the norm of the right-hand side of the PPE normalized by the number of fluid cells.
+ */
+Real computeRsNormCpp(int imax, int jmax, int kmax, Real *RS, FlagType *Flag);
+
+/**
+ * The PPE with Neumann boundary conditions only has a solution if the right-hand side sums up to zero over all fluid
+ * cells. With in- and outflow boundaries, this is not the case while the flow is still developing. This function
+ * subtracts the mean value of RS over all fluid cells, such that iterative solvers can converge to a residual of zero.
+ */
+void subtractMeanRsCpp(int imax, int jmax, int kmax, Real *RS, FlagType *Flag);
+
+/**
+ * The default number of Jacobi iterations performed per pass over the domain by jacobiTemporalBlockingCpp.
+ */
+const int JACOBI_TEMPORAL_BLOCK_SIZE = 8;
+
+/**
+ * Performs numIterations Jacobi iterations in one pass over the domain using wavefront temporal blocking along the
+ * x axis. The results are identical to numIterations calls of pressureOperatorSweepCpp with LINEAR_SOLVER_JACOBI, but
+ * P and P_temp are streamed through the memory only once instead of once per iteration. As for the single sweeps, the
+ * pointers are swapped after an odd number of iterations, such that P points to the current values.
+ * RS needs to be zero in all non-fluid cells (@see maskRsPressureOperatorCpp).
+ * @return The residual of the last iteration normalized by the number of fluid cells.
+ */
+Real jacobiTemporalBlockingCpp(
+        Real omg, int numIterations, int imax, int jmax, int kmax, Real *&P, Real *&P_temp, Real *RS,
+        PressureOperatorCpp &pressureOperator);
+
+/**
+ * Performs one lexicographic SOR sweep (Gauss-Seidel for omg = 1) in parallel. The y range is split into one block per
+ * thread, and the threads are pipelined along the x axis: a thread only starts updating its block of an x-plane after
+ * the thread with the preceding block has finished that plane. Thus, every cell sees exactly the same (already updated
+ * or not yet updated) neighbor values as in the serial sweep of pressureOperatorSweepCpp with LINEAR_SOLVER_SOR, and
+ * the results are bitwise identical to it.
+ * RS needs to be zero in all non-fluid cells (@see maskRsPressureOperatorCpp).
+ * @param P_temp Used for storing the residual of each cell if computeResidual is true.
+ * @param computeResidual Whether to compute the residual. The residuals of the cells are summed up serially in
+ * lexicographic order afterwards, so that the sum is identical to the one of the serial sweep.
+ * @return The residual normalized by the number of fluid cells (or zero if computeResidual is false).
+ */
+Real sorWavefrontSweepCpp(
+        Real omg, int imax, int jmax, int kmax, Real *P, Real *P_temp, Real *RS,
+        PressureOperatorCpp &pressureOperator, bool computeResidual);
 
 /**
  * Uses an SOR solver to compute the updated pressure values using the pressure poisson equation (PPE).
+ * @param P The pressure values. The Jacobi type solvers alternate between P and P_temp instead of copying the values in
+ * each iteration, so the two pointers may be swapped after the call.
+ * @param residualCheckInterval The number of iterations after which the convergence is checked (Jacobi and SOR type
+ * solvers only).
+ * @param multigridLevels The multigrid hierarchy (only used if linearSystemSolverType is a multigrid solver).
+ * @param cgData The work arrays of the PCG solver (only used if linearSystemSolverType is a PCG solver).
+ * @param pressureOperator The operator with the boundary conditions folded into the coefficients (only used by the
+ * Jacobi, SOR type and PCG solvers).
+ * @param dctData The data of the direct DCT solver (only used if linearSystemSolverType is LINEAR_SOLVER_DCT).
+ * @param mixedPrecisionData The data of the mixed precision solver. If it was created, the Jacobi and SOR type solvers
+ * iterate in single precision (@see MixedPrecisionCpp.hpp).
+ * @param chebyshevData The data of the Chebyshev solver (only used if linearSystemSolverType is
+ * LINEAR_SOLVER_CHEBYSHEV).
+ * @param compressedOperator The pressure operator restricted to the fluid cells. If it was created, the Jacobi and
+ * lexicographic SOR solvers iterate on the compact unknown vector instead of the whole domain.
+ * @param adaptiveOmegaData The online estimate of the over-relaxation factor. If it is enabled, it is used by the SOR
+ * type solvers instead of the fixed factor and updated during the solve.
  */
 void sorSolverCpp(
-        Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag);
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag,
+        std::vector<MultigridLevelCpp> &multigridLevels, ConjugateGradientDataCpp &cgData,
+        PressureOperatorCpp &pressureOperator, DctSolverDataCpp &dctData, MixedPrecisionDataCpp &mixedPrecisionData,
+        ChebyshevDataCpp &chebyshevData, CompressedPressureOperatorCpp &compressedOperator,
+        AdaptiveOmegaData &adaptiveOmegaData);
+
+}
 
 #endif //CFD3D_SORSOLVERCPP_HPP
@@ -0,0 +1,171 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include "../Flag.hpp"
+#include "TimeIntegratorCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createTimeIntegratorDataCpp(
+        TimeIntegratorType timeIntegrator, int imax, int jmax, int kmax, TimeIntegratorDataCpp &timeIntegratorData) {
+    timeIntegratorData.timeIntegrator = timeIntegrator;
+    if (timeIntegrator == TIME_INTEGRATOR_ADAMS_BASHFORTH_2) {
+        timeIntegratorData.rhsU = new Real[(imax+1)*(jmax+1)*(kmax+1)];
+        timeIntegratorData.rhsV = new Real[(imax+1)*(jmax+1)*(kmax+1)];
+        timeIntegratorData.rhsW = new Real[(imax+1)*(jmax+1)*(kmax+1)];
+        timeIntegratorData.rhsT = new Real[(imax+2)*(jmax+2)*(kmax+2)];
+        timeIntegratorData.dtOldMomentum = Real(0.0);
+        timeIntegratorData.dtOldTemperature = Real(0.0);
+    } else if (timeIntegrator == TIME_INTEGRATOR_RUNGE_KUTTA_3) {
+        timeIntegratorData.U_old = new Real[(imax+1)*(jmax+2)*(kmax+2)];
+        timeIntegratorData.V_old = new Real[(imax+2)*(jmax+1)*(kmax+2)];
+        timeIntegratorData.W_old = new Real[(imax+2)*(jmax+2)*(kmax+1)];
+        timeIntegratorData.T_old = new Real[(imax+2)*(jmax+2)*(kmax+2)];
+    }
+}
+
+void destroyTimeIntegratorDataCpp(TimeIntegratorDataCpp &timeIntegratorData) {
+    delete[] timeIntegratorData.rhsU;
+    delete[] timeIntegratorData.rhsV;
+    delete[] timeIntegratorData.rhsW;
+    delete[] timeIntegratorData.rhsT;
+    delete[] timeIntegratorData.U_old;
+    delete[] timeIntegratorData.V_old;
+    delete[] timeIntegratorData.W_old;
+    delete[] timeIntegratorData.T_old;
+    timeIntegratorData.rhsU = nullptr;
+    timeIntegratorData.rhsV = nullptr;
+    timeIntegratorData.rhsW = nullptr;
+    timeIntegratorData.rhsT = nullptr;
+    timeIntegratorData.U_old = nullptr;
+    timeIntegratorData.V_old = nullptr;
+    timeIntegratorData.W_old = nullptr;
+    timeIntegratorData.T_old = nullptr;
+}
+
+/**
+ * Applies the Adams-Bashforth 2 correction to one velocity component. The points (i,j,k) in [1,ni]x[1,nj]x[1,nk] with
+ * mask == FGH_MASK_COMPUTE are updated. U is indexed with the strides strideUI and strideUJ, F, rhsOld and mask with
+ * the strides strideFI and strideFJ. The stride in k direction is 1 for all arrays.
+ */
+static void applyAdamsBashforthComponentCpp(
+        Real dt, Real dtOld, int ni, int nj, int nk, int strideUI, int strideUJ, int strideFI, int strideFJ,
+        const Real *U, Real *F, const uint8_t *mask, Real *rhsOld) {
+    // For dtOld == 0, only the right-hand side is stored, i.e., the first time step uses forward Euler.
+    const Real extrapolationFactor = dtOld > Real(0.0) ? dt * dt / (2 * dtOld) : Real(0.0);
+
+    #pragma omp parallel for
+    for (int i = 1; i <= ni; i++) {
+        for (int j = 1; j <= nj; j++) {
+            for (int k = 1; k <= nk; k++) {
+                const int idxU = i*strideUI + j*strideUJ + k, idxF = i*strideFI + j*strideFJ + k;
+                if (mask[idxF] == FGH_MASK_COMPUTE) {
+                    Real rhs = (F[idxF] - U[idxU]) / dt;
+                    F[idxF] += extrapolationFactor * (rhs - rhsOld[idxF]);
+                    rhsOld[idxF] = rhs;
+                }
+            }
+        }
+    }
+}
+
+void applyAdamsBashforthMomentumCpp(
+        Real dt, int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real *F, Real *G, Real *H,
+        const FghMasksCpp &fghMasks, TimeIntegratorDataCpp &timeIntegratorData) {
+    const Real dtOld = timeIntegratorData.dtOldMomentum;
+    // F, G and H are indexed like RS (IDXF, IDXG and IDXH).
+    const int strideFI = (jmax+1)*(kmax+1), strideFJ = kmax+1;
+    applyAdamsBashforthComponentCpp(
+            dt, dtOld, imax-1, jmax, kmax, (jmax+2)*(kmax+2), kmax+2, strideFI, strideFJ,
+            U, F, fghMasks.maskF, timeIntegratorData.rhsU);
+    applyAdamsBashforthComponentCpp(
+            dt, dtOld, imax, jmax-1, kmax, (jmax+1)*(kmax+2), kmax+2, strideFI, strideFJ,
+            V, G, fghMasks.maskG, timeIntegratorData.rhsV);
+    applyAdamsBashforthComponentCpp(
+            dt, dtOld, imax, jmax, kmax-1, (jmax+2)*(kmax+1), kmax+1, strideFI, strideFJ,
+            W, H, fghMasks.maskH, timeIntegratorData.rhsW);
+    timeIntegratorData.dtOldMomentum = dt;
+}
+
+void applyAdamsBashforthTemperatureCpp(
+        Real dt, int imax, int jmax, int kmax, Real *T, Real *T_temp, FlagType *Flag,
+        TimeIntegratorDataCpp &timeIntegratorData) {
+    const Real dtOld = timeIntegratorData.dtOldTemperature;
+    const Real extrapolationFactor = dtOld > Real(0.0) ? dt * dt / (2 * dtOld) : Real(0.0);
+    Real *rhsOld = timeIntegratorData.rhsT;
+
+    #pragma omp parallel for
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    Real rhs = (T[IDXT(i,j,k)] - T_temp[IDXT(i,j,k)]) / dt;
+                    T[IDXT(i,j,k)] += extrapolationFactor * (rhs - rhsOld[IDXT(i,j,k)]);
+                    rhsOld[IDXT(i,j,k)] = rhs;
+                }
+            }
+        }
+    }
+    timeIntegratorData.dtOldTemperature = dt;
+}
+
+void saveRungeKuttaStateCpp(
+        int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real *T, bool useTemperature,
+        TimeIntegratorDataCpp &timeIntegratorData) {
+    memcpy(timeIntegratorData.U_old, U, sizeof(Real)*(imax+1)*(jmax+2)*(kmax+2));
+    memcpy(timeIntegratorData.V_old, V, sizeof(Real)*(imax+2)*(jmax+1)*(kmax+2));
+    memcpy(timeIntegratorData.W_old, W, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+1));
+    if (useTemperature) {
+        memcpy(timeIntegratorData.T_old, T, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
+    }
+}
+
+/**
+ * Sets X = weightOld * X_old + (1 - weightOld) * X for all n entries.
+ */
+static void blendArraysCpp(Real weightOld, int n, Real *X, const Real *X_old) {
+    const Real weightNew = Real(1.0) - weightOld;
+    #pragma omp parallel for
+    for (int idx = 0; idx < n; idx++) {
+        X[idx] = weightOld * X_old[idx] + weightNew * X[idx];
+    }
+}
+
+void blendRungeKuttaStageCpp(
+        Real weightOld, int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real *T, bool useTemperature,
+        TimeIntegratorDataCpp &timeIntegratorData) {
+    blendArraysCpp(weightOld, (imax+1)*(jmax+2)*(kmax+2), U, timeIntegratorData.U_old);
+    blendArraysCpp(weightOld, (imax+2)*(jmax+1)*(kmax+2), V, timeIntegratorData.V_old);
+    blendArraysCpp(weightOld, (imax+2)*(jmax+2)*(kmax+1), W, timeIntegratorData.W_old);
+    if (useTemperature) {
+        blendArraysCpp(weightOld, (imax+2)*(jmax+2)*(kmax+2), T, timeIntegratorData.T_old);
+    }
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_TIMEINTEGRATORCPP_HPP
+#define CFD3D_TIMEINTEGRATORCPP_HPP
+
+#include "Defines.hpp"
+#include "UvwCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The data of the higher-order explicit time integrators. The kernels of the forward Euler method stay unchanged:
+ * - Adams-Bashforth 2: calculateFghCpp (calculateTemperatureCpp) computes the forward Euler update. It is corrected by
+ *   dt * dt/(2*dtOld) * (rhs - rhsOld), where rhs = (F - U)/dt is the right-hand side of the momentum equation (without
+ *   the pressure gradient), and rhsOld is the one of the last time step (variable step size formulation).
+ * - Runge-Kutta 3 (strong stability preserving, Shu-Osher form): Each of the three stages is a forward Euler step with
+ *   a pressure projection. The results of the second and third stage are blended with the state at the beginning of
+ *   the time step, so only one copy of U, V, W and T is needed in addition to the forward Euler arrays.
+ */
+struct TimeIntegratorDataCpp {
+    TimeIntegratorType timeIntegrator = TIME_INTEGRATOR_EULER;
+
+    // Adams-Bashforth 2: The right-hand sides of the last time step in the layout of F, G, H and T, and the time step
+    // sizes they were computed with (0 if there is no previous time step, in which case forward Euler is used).
+    Real *rhsU = nullptr, *rhsV = nullptr, *rhsW = nullptr, *rhsT = nullptr;
+    Real dtOldMomentum = Real(0.0), dtOldTemperature = Real(0.0);
+
+    // Runge-Kutta 3: U, V, W and T at the beginning of the time step.
+    Real *U_old = nullptr, *V_old = nullptr, *W_old = nullptr, *T_old = nullptr;
+};
+
+/**
+ * The weights of the state at the beginning of the time step in the second and third stage of the Runge-Kutta method.
+ */
+const Real RUNGE_KUTTA_3_STAGE_2_WEIGHT_OLD = Real(3.0) / Real(4.0);
+const Real RUNGE_KUTTA_3_STAGE_3_WEIGHT_OLD = Real(1.0) / Real(3.0);
+
+/**
+ * Allocates the history or stage arrays needed by the passed time integrator.
+ */
+void createTimeIntegratorDataCpp(
+        TimeIntegratorType timeIntegrator, int imax, int jmax, int kmax, TimeIntegratorDataCpp &timeIntegratorData);
+
+/**
+ * Frees the memory allocated by createTimeIntegratorDataCpp.
+ */
+void destroyTimeIntegratorDataCpp(TimeIntegratorDataCpp &timeIntegratorData);
+
+/**
+ * Turns the forward Euler values of F, G and H computed by calculateFghCpp into the Adams-Bashforth 2 values and stores
+ * the right-hand side of this time step for the next one.
+ */
+void applyAdamsBashforthMomentumCpp(
+        Real dt, int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real *F, Real *G, Real *H,
+        const FghMasksCpp &fghMasks, TimeIntegratorDataCpp &timeIntegratorData);
+
+/**
+ * Turns the forward Euler values of T computed by calculateTemperatureCpp (from T_temp) into the Adams-Bashforth 2
+ * values and stores the right-hand side of this time step for the next one.
+ */
+void applyAdamsBashforthTemperatureCpp(
+        Real dt, int imax, int jmax, int kmax, Real *T, Real *T_temp, FlagType *Flag,
+        TimeIntegratorDataCpp &timeIntegratorData);
+
+/**
+ * Copies U, V, W and T (if useTemperature is true) at the beginning of a Runge-Kutta time step.
+ */
+void saveRungeKuttaStateCpp(
+        int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real *T, bool useTemperature,
+        TimeIntegratorDataCpp &timeIntegratorData);
+
+/**
+ * Sets U = weightOld * U_old + (1 - weightOld) * U (and the same for V, W and T) after a Runge-Kutta stage.
+ * As both states are divergence free, the blended velocities are divergence free, too.
+ */
+void blendRungeKuttaStageCpp(
+        Real weightOld, int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real *T, bool useTemperature,
+        TimeIntegratorDataCpp &timeIntegratorData);
+
+}
+
+#endif //CFD3D_TIMEINTEGRATORCPP_HPP
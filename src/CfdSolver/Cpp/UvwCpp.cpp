@@ -27,199 +27,379 @@
  */
 
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
+#include <utility>
+#include <vector>
+#include <omp.h>
 #include "Defines.hpp"
 #include "UvwCpp.hpp"
 #include "../Flag.hpp"
 
-void calculateFghCpp(
-        Real Re, Real GX, Real GY, Real GZ, Real alpha, Real beta,
-        Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W, Real *T, Real *F, Real *G, Real *H, FlagType *Flag) {
-    Real d2u_dx2,d2u_dy2,d2u_dz2,
-         d2v_dx2,d2v_dy2,d2v_dz2,
-         d2w_dx2,d2w_dy2,d2w_dz2;
-    
-    Real du2_dx,duv_dy,duw_dz,
-         duv_dx,dv2_dy,dvw_dz,
-         duw_dx,dvw_dy,dw2_dz;
-    
-    Real Dx = 1/dx, Dy = 1/dy, Dz = 1/dz;
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createFghMasksCpp(int imax, int jmax, int kmax, FlagType *Flag, FghMasksCpp &fghMasks) {
+    const int size = (imax+1)*(jmax+1)*(kmax+1);
+    fghMasks.maskF = new uint8_t[size];
+    fghMasks.maskG = new uint8_t[size];
+    fghMasks.maskH = new uint8_t[size];
+    std::fill(fghMasks.maskF, fghMasks.maskF + size, FGH_MASK_KEEP);
+    std::fill(fghMasks.maskG, fghMasks.maskG + size, FGH_MASK_KEEP);
+    std::fill(fghMasks.maskH, fghMasks.maskH + size, FGH_MASK_KEEP);
 
-    #pragma omp parallel for private(d2u_dx2, d2u_dy2, d2u_dz2, du2_dx, duv_dy, duw_dz)
-    for (int i = 1; i <= imax-1; i++) {
+    // Replays the branches of the cell loops of the original kernel. Copies to the faces at the domain boundary (i.e.,
+    // i-1 = 0 for B_L) are skipped, as these faces are set to the same values afterwards anyway.
+    for (int i = 1; i <= imax; i++) {
         for (int j = 1; j <= jmax; j++) {
             for (int k = 1; k <= kmax; k++) {
-                if(isFluid(Flag[IDXFLAG(i,j,k)]) && isFluid(Flag[IDXFLAG(i+1,j,k)])){
-                    d2u_dx2 = (U[IDXU(i+1,j,k)] - 2*U[IDXU(i,j,k)] + U[IDXU(i-1,j,k)])/(dx*dx);
-                    d2u_dy2 = (U[IDXU(i,j+1,k)] - 2*U[IDXU(i,j,k)] + U[IDXU(i,j-1,k)])/(dy*dy);
-                    d2u_dz2 = (U[IDXU(i,j,k+1)] - 2*U[IDXU(i,j,k)] + U[IDXU(i,j,k-1)])/(dz*dz);
-
-                    du2_dx = Real(0.25)*Dx*(
-                            (U[IDXU(i,j,k)]+U[IDXU(i+1,j,k)])*(U[IDXU(i,j,k)]+U[IDXU(i+1,j,k)]) -
-                            (U[IDXU(i-1,j,k)]+U[IDXU(i,j,k)])*(U[IDXU(i-1,j,k)]+U[IDXU(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(U[IDXU(i,j,k)]+U[IDXU(i+1,j,k)])*(U[IDXU(i,j,k)]-U[IDXU(i+1,j,k)]))-
-                                    (std::abs(U[IDXU(i-1,j,k)]+U[IDXU(i,j,k)])*(U[IDXU(i-1,j,k)]-U[IDXU(i,j,k)]))
-                            )
-                    );
-
-                    duv_dy = Real(0.25)*Dy*(
-                            (V[IDXV(i,j,k)]+V[IDXV(i+1,j,k)])*(U[IDXU(i,j,k)]+U[IDXU(i,j+1,k)]) -
-                            (V[IDXV(i,j-1,k)]+V[IDXV(i+1,j-1,k)])*(U[IDXU(i,j-1,k)]+U[IDXU(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(V[IDXV(i,j,k)]+V[IDXV(i+1,j,k)])*(U[IDXU(i,j,k)]-U[IDXU(i,j+1,k)]))-
-                                    (std::abs(V[IDXV(i,j-1,k)]+V[IDXV(i+1,j-1,k)])*(U[IDXU(i,j-1,k)]-U[IDXU(i,j,k)]))
-                            )
-                    );
-
-                    duw_dz = Real(0.25)*Dz*(
-                            (W[IDXW(i,j,k)]+W[IDXW(i+1,j,k)])*(U[IDXU(i,j,k)]+U[IDXU(i,j,k+1)]) -
-                            (W[IDXW(i,j,k-1)]+W[IDXW(i+1,j,k-1)])*(U[IDXU(i,j,k-1)]+U[IDXU(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(W[IDXW(i,j,k)]+W[IDXW(i+1,j,k)])*(U[IDXU(i,j,k)]-U[IDXU(i,j,k+1)]))-
-                                    (std::abs(W[IDXW(i,j,k-1)]+W[IDXW(i+1,j,k-1)])*(U[IDXU(i,j,k-1)]-U[IDXU(i,j,k)]))
-                            )
-                    );
-
-                    F[IDXF(i,j,k)] = U[IDXU(i,j,k)] + dt * (
-                            (1/Re)*(d2u_dx2+d2u_dy2+d2u_dz2)-
-                            du2_dx-duv_dy-duw_dz+
-                            GX-(beta/2)*(T[IDXT(i,j,k)]+T[IDXT(i+1,j,k)])*GX
-                    );
-                } else if (B_L(Flag[IDXFLAG(i,j,k)])) {
-                    F[IDXF(i-1,j,k)] = U[IDXU(i-1,j,k)];
-                } else if (B_R(Flag[IDXFLAG(i,j,k)])) {
-                    F[IDXF(i,j,k)] = U[IDXU(i,j,k)];
+                const FlagType flag = Flag[IDXFLAG(i,j,k)];
+                if (i <= imax-1) {
+                    if (isFluid(flag) && isFluid(Flag[IDXFLAG(i+1,j,k)])) {
+                        fghMasks.maskF[IDXF(i,j,k)] = FGH_MASK_COMPUTE;
+                    } else if (B_L(flag)) {
+                        if (i > 1) {
+                            fghMasks.maskF[IDXF(i-1,j,k)] = FGH_MASK_COPY;
+                        }
+                    } else if (B_R(flag)) {
+                        fghMasks.maskF[IDXF(i,j,k)] = FGH_MASK_COPY;
+                    }
+                }
+                if (j <= jmax-1) {
+                    if (isFluid(flag) && isFluid(Flag[IDXFLAG(i,j+1,k)])) {
+                        fghMasks.maskG[IDXG(i,j,k)] = FGH_MASK_COMPUTE;
+                    } else if (B_D(flag)) {
+                        if (j > 1) {
+                            fghMasks.maskG[IDXG(i,j-1,k)] = FGH_MASK_COPY;
+                        }
+                    } else if (B_U(flag)) {
+                        fghMasks.maskG[IDXG(i,j,k)] = FGH_MASK_COPY;
+                    }
+                }
+                if (k <= kmax-1) {
+                    if (isFluid(flag) && isFluid(Flag[IDXFLAG(i,j,k+1)])) {
+                        fghMasks.maskH[IDXH(i,j,k)] = FGH_MASK_COMPUTE;
+                    } else if (B_B(flag)) {
+                        if (k > 1) {
+                            fghMasks.maskH[IDXH(i,j,k-1)] = FGH_MASK_COPY;
+                        }
+                    } else if (B_F(flag)) {
+                        fghMasks.maskH[IDXH(i,j,k)] = FGH_MASK_COPY;
+                    }
                 }
             }
         }
     }
+}
 
-    #pragma omp parallel for private(d2v_dx2, d2v_dy2, d2v_dz2, duv_dx, dv2_dy, dvw_dz)
-    for (int i = 1; i <= imax; i++) {
-        for (int j = 1; j <= jmax-1; j++) {
-            for (int k = 1; k <= kmax; k++) {
-                if(isFluid(Flag[IDXFLAG(i,j,k)]) && isFluid(Flag[IDXFLAG(i,j+1,k)])){
-                    d2v_dx2 = (V[IDXV(i+1,j,k)] - 2*V[IDXV(i,j,k)] + V[IDXV(i-1,j,k)])/(dx*dx);
-                    d2v_dy2 = (V[IDXV(i,j+1,k)] - 2*V[IDXV(i,j,k)] + V[IDXV(i,j-1,k)])/(dy*dy);
-                    d2v_dz2 = (V[IDXV(i,j,k+1)] - 2*V[IDXV(i,j,k)] + V[IDXV(i,j,k-1)])/(dz*dz);
-
-                    duv_dx = Real(0.25)*Dx*(
-                            (U[IDXU(i,j,k)]+U[IDXU(i,j+1,k)])*(V[IDXV(i,j,k)]+V[IDXV(i+1,j,k)]) -
-                            (U[IDXU(i-1,j,k)]+U[IDXU(i-1,j+1,k)])*(V[IDXV(i-1,j,k)]+V[IDXV(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(U[IDXU(i,j,k)]+U[IDXU(i,j+1,k)])*(V[IDXV(i,j,k)]-V[IDXV(i+1,j,k)]))-
-                                    (std::abs(U[IDXU(i-1,j,k)]+U[IDXU(i-1,j+1,k)])*(V[IDXV(i-1,j,k)]-V[IDXV(i,j,k)]))
-                            )
-                    );
-
-                    dv2_dy = Real(0.25)*Dy*(
-                            (V[IDXV(i,j,k)]+V[IDXV(i,j+1,k)])*(V[IDXV(i,j,k)]+V[IDXV(i,j+1,k)]) -
-                            (V[IDXV(i,j-1,k)]+V[IDXV(i,j,k)])*(V[IDXV(i,j-1,k)]+V[IDXV(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(V[IDXV(i,j,k)]+V[IDXV(i,j+1,k)])*(V[IDXV(i,j,k)]-V[IDXV(i,j+1,k)]))-
-                                    (std::abs(V[IDXV(i,j-1,k)]+V[IDXV(i,j,k)])*(V[IDXV(i,j-1,k)]-V[IDXV(i,j,k)]))
-                            )
-                    );
-
-                    dvw_dz = Real(0.25)*Dz*(
-                            (W[IDXW(i,j,k)]+W[IDXW(i,j+1,k)])*(V[IDXV(i,j,k)]+V[IDXV(i,j,k+1)]) -
-                            (W[IDXW(i,j,k-1)]+W[IDXW(i,j+1,k-1)])*(V[IDXV(i,j,k-1)]+V[IDXV(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(W[IDXW(i,j,k)]+W[IDXW(i,j+1,k)])*(V[IDXV(i,j,k)]-V[IDXV(i,j,k+1)]))-
-                                    (std::abs(W[IDXW(i,j,k-1)]+W[IDXW(i,j+1,k-1)])*(V[IDXV(i,j,k-1)]-V[IDXV(i,j,k)]))
-                            )
-                    );
+void destroyFghMasksCpp(FghMasksCpp &fghMasks) {
+    delete[] fghMasks.maskF;
+    delete[] fghMasks.maskG;
+    delete[] fghMasks.maskH;
+    fghMasks = FghMasksCpp();
+}
 
-                    G[IDXG(i,j,k)] = V[IDXV(i,j,k)] + dt * (
-                            (1/Re)*(d2v_dx2+d2v_dy2+d2v_dz2)-
-                            duv_dx-dv2_dy-dvw_dz+
-                            GY-(beta/2)*(T[IDXT(i,j,k)]+T[IDXT(i,j+1,k)])*GY
-                    );
-                } else if (B_D(Flag[IDXFLAG(i,j,k)])) {
-                    G[IDXG(i,j-1,k)] = V[IDXV(i,j-1,k)];
-                } else if (B_U(Flag[IDXFLAG(i,j,k)])) {
-                    G[IDXG(i,j,k)] = V[IDXV(i,j,k)];
-                }                
-            }
-        }
+/**
+ * The rolling buffers of the face fluxes of one thread. The fluxes in x direction are stored for a whole y-z-plane, the
+ * fluxes in y direction for one z line (of the current and the previous y-z-plane, respectively y line), and the fluxes
+ * in z direction for one z line. The central and the upwind part of the donor-cell fluxes are stored separately, such
+ * that the differences of the fluxes are evaluated in the same order as in the cell-wise formulation.
+ */
+struct FaceFluxBuffersCpp {
+    FaceFluxBuffersCpp(int jmax, int kmax) : storage(4*(jmax+2)*(kmax+2) + 6*(kmax+2)) {
+        const int planeSize = (jmax+2)*(kmax+2);
+        Real *buffer = storage.data();
+        xLowerCentral = buffer; buffer += planeSize;
+        xLowerUpwind = buffer; buffer += planeSize;
+        xUpperCentral = buffer; buffer += planeSize;
+        xUpperUpwind = buffer; buffer += planeSize;
+        yLowerCentral = buffer; buffer += kmax+2;
+        yLowerUpwind = buffer; buffer += kmax+2;
+        yUpperCentral = buffer; buffer += kmax+2;
+        yUpperUpwind = buffer; buffer += kmax+2;
+        zCentral = buffer; buffer += kmax+2;
+        zUpwind = buffer;
+    }
+    // The upper fluxes of the current plane (line) are the lower fluxes of the next plane (line).
+    void swapX() {
+        std::swap(xLowerCentral, xUpperCentral);
+        std::swap(xLowerUpwind, xUpperUpwind);
+    }
+    void swapY() {
+        std::swap(yLowerCentral, yUpperCentral);
+        std::swap(yLowerUpwind, yUpperUpwind);
     }
 
-    #pragma omp parallel for private(d2w_dx2, d2w_dy2, d2w_dz2, duw_dx, dvw_dy, dw2_dz)
-    for (int i = 1; i <= imax; i++) {
-        for (int j = 1; j <= jmax; j++) {
-            for (int k = 1; k <= kmax-1; k++) {
-                if(isFluid(Flag[IDXFLAG(i,j,k)]) && isFluid(Flag[IDXFLAG(i,j,k+1)])){
-                    d2w_dx2 = (W[IDXW(i+1,j,k)] - 2*W[IDXW(i,j,k)] + W[IDXW(i-1,j,k)])/(dx*dx);
-                    d2w_dy2 = (W[IDXW(i,j+1,k)] - 2*W[IDXW(i,j,k)] + W[IDXW(i,j-1,k)])/(dy*dy);
-                    d2w_dz2 = (W[IDXW(i,j,k+1)] - 2*W[IDXW(i,j,k)] + W[IDXW(i,j,k-1)])/(dz*dz);
-
-                    duw_dx = Real(0.25)*Dx*(
-                            (U[IDXU(i,j,k)]+U[IDXU(i,j,k+1)])*(W[IDXW(i,j,k)]+W[IDXW(i+1,j,k)]) -
-                            (U[IDXU(i-1,j,k)]+U[IDXU(i-1,j,k+1)])*(W[IDXW(i-1,j,k)]+W[IDXW(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(U[IDXU(i,j,k)]+U[IDXU(i,j,k+1)])*(W[IDXW(i,j,k)]-W[IDXW(i+1,j,k)]))-
-                                    (std::abs(U[IDXU(i-1,j,k)]+U[IDXU(i-1,j,k+1)])*(W[IDXW(i-1,j,k)]-W[IDXW(i,j,k)]))
-                            )
-                    );
+    std::vector<Real> storage;
+    Real *xLowerCentral, *xLowerUpwind, *xUpperCentral, *xUpperUpwind;
+    Real *yLowerCentral, *yLowerUpwind, *yUpperCentral, *yUpperUpwind;
+    Real *zCentral, *zUpwind;
+};
 
-                    dvw_dy = Real(0.25)*Dy*(
-                            (V[IDXV(i,j,k)]+V[IDXV(i,j,k+1)])*(W[IDXW(i,j,k)]+W[IDXW(i,j+1,k)]) -
-                            (V[IDXV(i,j-1,k)]+V[IDXV(i,j-1,k+1)])*(W[IDXW(i,j-1,k)]+W[IDXW(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(V[IDXV(i,j,k)]+V[IDXV(i,j,k+1)])*(W[IDXW(i,j,k)]-W[IDXW(i,j+1,k)]))-
-                                    (std::abs(V[IDXV(i,j-1,k)]+V[IDXV(i,j-1,k+1)])*(W[IDXW(i,j-1,k)]-W[IDXW(i,j,k)]))
-                            )
-                    );
-
-                    dw2_dz = Real(0.25)*Dz*(
-                            (W[IDXW(i,j,k)]+W[IDXW(i,j,k+1)])*(W[IDXW(i,j,k)]+W[IDXW(i,j,k+1)]) -
-                            (W[IDXW(i,j,k-1)]+W[IDXW(i,j,k)])*(W[IDXW(i,j,k-1)]+W[IDXW(i,j,k)]) +
-                            alpha*(
-                                    (std::abs(W[IDXW(i,j,k)]+W[IDXW(i,j,k+1)])*(W[IDXW(i,j,k)]-W[IDXW(i,j,k+1)]))-
-                                    (std::abs(W[IDXW(i,j,k-1)]+W[IDXW(i,j,k)])*(W[IDXW(i,j,k-1)]-W[IDXW(i,j,k)]))
-                            )
-                    );
+/**
+ * Computes the donor-cell fluxes of a momentum component on n consecutive faces in z direction. The transport velocity
+ * on a face is (transport0 + transport1) / 2, and the transported velocity is interpolated from left and right.
+ * The factor 1/4 is applied when taking the differences of the fluxes.
+ */
+inline void computeMomentumFluxLineCpp(
+        int n, const Real *transport0, const Real *transport1, const Real *left, const Real *right,
+        Real *fluxCentral, Real *fluxUpwind) {
+    #pragma omp simd
+    for (int k = 0; k < n; k++) {
+        Real transportSum = transport0[k] + transport1[k];
+        fluxCentral[k] = transportSum * (left[k] + right[k]);
+        fluxUpwind[k] = std::abs(transportSum) * (left[k] - right[k]);
+    }
+}
 
-                    H[IDXH(i,j,k)] = W[IDXW(i,j,k)] +  dt * (
-                            (1/Re)*(d2w_dx2+d2w_dy2+d2w_dz2)-
-                            duw_dx-dvw_dy-dw2_dz+
-                            GZ-(beta/2)*(T[IDXT(i,j,k)]+T[IDXT(i,j,k+1)])*GZ
-                    );
-                } else if (B_B(Flag[IDXFLAG(i,j,k)])) {
-                    H[IDXH(i,j,k-1)] = W[IDXW(i,j,k-1)];
-                } else if (B_F(Flag[IDXFLAG(i,j,k)])) {
-                    H[IDXH(i,j,k)] = W[IDXW(i,j,k)];
-                }    
-            }
-        }
+/**
+ * Computes the donor-cell fluxes of the temperature on n consecutive faces in z direction, where velocity is the
+ * velocity on the faces and the temperature is interpolated from left and right.
+ */
+inline void computeTemperatureFluxLineCpp(
+        int n, const Real *velocity, const Real *left, const Real *right, Real *fluxCentral, Real *fluxUpwind) {
+    #pragma omp simd
+    for (int k = 0; k < n; k++) {
+        fluxCentral[k] = velocity[k] * ((left[k] + right[k]) / 2);
+        fluxUpwind[k] = std::abs(velocity[k]) * ((left[k] - right[k]) / 2);
     }
+}
 
+void calculateFghCpp(
+        Real Re, Real GX, Real GY, Real GZ, Real alpha, Real beta,
+        Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W, Real *T, Real *F, Real *G, Real *H, const FghMasksCpp &fghMasks,
+        bool implicitDiffusion, Real *RS) {
+    const uint8_t *maskF = fghMasks.maskF;
+    const uint8_t *maskG = fghMasks.maskG;
+    const uint8_t *maskH = fghMasks.maskH;
+    Real Dx = 1/dx, Dy = 1/dy, Dz = 1/dz;
+    // With implicit diffusion, the viscous terms and the body forces are added by solveImplicitMomentumDiffusionCpp.
+    const Real viscosity = implicitDiffusion ? Real(0.0) : 1/Re;
+    const Real gravityX = implicitDiffusion ? Real(0.0) : GX;
+    const Real gravityY = implicitDiffusion ? Real(0.0) : GY;
+    const Real gravityZ = implicitDiffusion ? Real(0.0) : GZ;
+    const int planeStride = kmax+2;
+
+    // The values on the domain boundary only depend on U, V and W, so they are set first. This way, the right-hand side
+    // of the PPE can already be computed in the sweep over H below.
     #pragma omp parallel for
     for (int j = 1; j <= jmax; j++) {
         for (int k = 1; k <= kmax; k++) {
-            F[IDXF(0,j,k)] = U[IDXU(0,j,k)];         
-            F[IDXF(imax,j,k)] = U[IDXU(imax,j,k)];   
+            F[IDXF(0,j,k)] = U[IDXU(0,j,k)];
+            F[IDXF(imax,j,k)] = U[IDXU(imax,j,k)];
         }
     }
 
     #pragma omp parallel for
     for (int i = 1; i <= imax; i++) {
         for (int k = 1; k <= kmax; k++) {
-            G[IDXG(i,0,k)] = V[IDXV(i,0,k)];         
-            G[IDXG(i,jmax,k)] = V[IDXV(i,jmax,k)];               
+            G[IDXG(i,0,k)] = V[IDXV(i,0,k)];
+            G[IDXG(i,jmax,k)] = V[IDXV(i,jmax,k)];
         }
     }
 
     #pragma omp parallel for
     for (int i = 1; i <= imax; i++) {
         for (int j = 1; j <= jmax; j++) {
-            H[IDXH(i,j,0)] = W[IDXW(i,j,0)];         
-            H[IDXH(i,j,kmax)] = W[IDXW(i,j,kmax)];               
+            H[IDXH(i,j,0)] = W[IDXW(i,j,0)];
+            H[IDXH(i,j,kmax)] = W[IDXW(i,j,kmax)];
+        }
+    }
+
+    // The convective terms are computed in flux form: Each face flux is computed once and stored in rolling buffers, and
+    // the terms are the differences of the fluxes of the two faces of a cell. Each thread processes a contiguous block
+    // of x-planes, so that the lower x fluxes of a plane are the upper x fluxes of the previous plane.
+    // The values are computed for all faces and then blended with the masks, so that the k loops have no branches and
+    // can be vectorized.
+    #pragma omp parallel
+    {
+        const int threadIdx = omp_get_thread_num();
+        const int numThreads = omp_get_num_threads();
+        FaceFluxBuffersCpp fluxes(jmax, kmax);
+
+        int il = 1 + threadIdx * (imax-1) / numThreads;
+        int iu = (threadIdx + 1) * (imax-1) / numThreads;
+        for (int j = 1; j <= jmax && il <= iu; j++) {
+            computeMomentumFluxLineCpp(
+                    kmax, &U[IDXU(il-1,j,1)], &U[IDXU(il,j,1)], &U[IDXU(il-1,j,1)], &U[IDXU(il,j,1)],
+                    fluxes.xLowerCentral + j*planeStride + 1, fluxes.xLowerUpwind + j*planeStride + 1);
+        }
+        for (int i = il; i <= iu; i++) {
+            computeMomentumFluxLineCpp(
+                    kmax, &V[IDXV(i,0,1)], &V[IDXV(i+1,0,1)], &U[IDXU(i,0,1)], &U[IDXU(i,1,1)],
+                    fluxes.yLowerCentral + 1, fluxes.yLowerUpwind + 1);
+            for (int j = 1; j <= jmax; j++) {
+                const Real *xLowerCentral = fluxes.xLowerCentral + j*planeStride;
+                const Real *xLowerUpwind = fluxes.xLowerUpwind + j*planeStride;
+                Real *xUpperCentral = fluxes.xUpperCentral + j*planeStride;
+                Real *xUpperUpwind = fluxes.xUpperUpwind + j*planeStride;
+                const Real *yLowerCentral = fluxes.yLowerCentral, *yLowerUpwind = fluxes.yLowerUpwind;
+                Real *yUpperCentral = fluxes.yUpperCentral, *yUpperUpwind = fluxes.yUpperUpwind;
+                Real *zCentral = fluxes.zCentral, *zUpwind = fluxes.zUpwind;
+                computeMomentumFluxLineCpp(
+                        kmax, &U[IDXU(i,j,1)], &U[IDXU(i+1,j,1)], &U[IDXU(i,j,1)], &U[IDXU(i+1,j,1)],
+                        xUpperCentral + 1, xUpperUpwind + 1);
+                computeMomentumFluxLineCpp(
+                        kmax, &V[IDXV(i,j,1)], &V[IDXV(i+1,j,1)], &U[IDXU(i,j,1)], &U[IDXU(i,j+1,1)],
+                        yUpperCentral + 1, yUpperUpwind + 1);
+                computeMomentumFluxLineCpp(
+                        kmax+1, &W[IDXW(i,j,0)], &W[IDXW(i+1,j,0)], &U[IDXU(i,j,0)], &U[IDXU(i,j,1)],
+                        zCentral, zUpwind);
+
+                #pragma omp simd
+                for (int k = 1; k <= kmax; k++) {
+                    Real d2u_dx2 = (U[IDXU(i+1,j,k)] - 2*U[IDXU(i,j,k)] + U[IDXU(i-1,j,k)])/(dx*dx);
+                    Real d2u_dy2 = (U[IDXU(i,j+1,k)] - 2*U[IDXU(i,j,k)] + U[IDXU(i,j-1,k)])/(dy*dy);
+                    Real d2u_dz2 = (U[IDXU(i,j,k+1)] - 2*U[IDXU(i,j,k)] + U[IDXU(i,j,k-1)])/(dz*dz);
+
+                    Real du2_dx = Real(0.25)*Dx*(
+                            xUpperCentral[k] - xLowerCentral[k] + alpha*(xUpperUpwind[k] - xLowerUpwind[k]));
+                    Real duv_dy = Real(0.25)*Dy*(
+                            yUpperCentral[k] - yLowerCentral[k] + alpha*(yUpperUpwind[k] - yLowerUpwind[k]));
+                    Real duw_dz = Real(0.25)*Dz*(
+                            zCentral[k] - zCentral[k-1] + alpha*(zUpwind[k] - zUpwind[k-1]));
+
+                    Real F_fluid = U[IDXU(i,j,k)] + dt * (
+                            viscosity*(d2u_dx2+d2u_dy2+d2u_dz2)-
+                            du2_dx-duv_dy-duw_dz+
+                            gravityX-(beta/2)*(T[IDXT(i,j,k)]+T[IDXT(i+1,j,k)])*gravityX
+                    );
+
+                    const uint8_t mask = maskF[IDXF(i,j,k)];
+                    F[IDXF(i,j,k)] = mask == FGH_MASK_COMPUTE ? F_fluid
+                            : (mask == FGH_MASK_COPY ? U[IDXU(i,j,k)] : F[IDXF(i,j,k)]);
+                }
+                fluxes.swapY();
+            }
+            fluxes.swapX();
         }
-    }            
 
+        il = 1 + threadIdx * imax / numThreads;
+        iu = (threadIdx + 1) * imax / numThreads;
+        for (int j = 1; j <= jmax-1 && il <= iu; j++) {
+            computeMomentumFluxLineCpp(
+                    kmax, &U[IDXU(il-1,j,1)], &U[IDXU(il-1,j+1,1)], &V[IDXV(il-1,j,1)], &V[IDXV(il,j,1)],
+                    fluxes.xLowerCentral + j*planeStride + 1, fluxes.xLowerUpwind + j*planeStride + 1);
+        }
+        for (int i = il; i <= iu; i++) {
+            computeMomentumFluxLineCpp(
+                    kmax, &V[IDXV(i,0,1)], &V[IDXV(i,1,1)], &V[IDXV(i,0,1)], &V[IDXV(i,1,1)],
+                    fluxes.yLowerCentral + 1, fluxes.yLowerUpwind + 1);
+            for (int j = 1; j <= jmax-1; j++) {
+                const Real *xLowerCentral = fluxes.xLowerCentral + j*planeStride;
+                const Real *xLowerUpwind = fluxes.xLowerUpwind + j*planeStride;
+                Real *xUpperCentral = fluxes.xUpperCentral + j*planeStride;
+                Real *xUpperUpwind = fluxes.xUpperUpwind + j*planeStride;
+                const Real *yLowerCentral = fluxes.yLowerCentral, *yLowerUpwind = fluxes.yLowerUpwind;
+                Real *yUpperCentral = fluxes.yUpperCentral, *yUpperUpwind = fluxes.yUpperUpwind;
+                Real *zCentral = fluxes.zCentral, *zUpwind = fluxes.zUpwind;
+                computeMomentumFluxLineCpp(
+                        kmax, &U[IDXU(i,j,1)], &U[IDXU(i,j+1,1)], &V[IDXV(i,j,1)], &V[IDXV(i+1,j,1)],
+                        xUpperCentral + 1, xUpperUpwind + 1);
+                computeMomentumFluxLineCpp(
+                        kmax, &V[IDXV(i,j,1)], &V[IDXV(i,j+1,1)], &V[IDXV(i,j,1)], &V[IDXV(i,j+1,1)],
+                        yUpperCentral + 1, yUpperUpwind + 1);
+                computeMomentumFluxLineCpp(
+                        kmax+1, &W[IDXW(i,j,0)], &W[IDXW(i,j+1,0)], &V[IDXV(i,j,0)], &V[IDXV(i,j,1)],
+                        zCentral, zUpwind);
+
+                #pragma omp simd
+                for (int k = 1; k <= kmax; k++) {
+                    Real d2v_dx2 = (V[IDXV(i+1,j,k)] - 2*V[IDXV(i,j,k)] + V[IDXV(i-1,j,k)])/(dx*dx);
+                    Real d2v_dy2 = (V[IDXV(i,j+1,k)] - 2*V[IDXV(i,j,k)] + V[IDXV(i,j-1,k)])/(dy*dy);
+                    Real d2v_dz2 = (V[IDXV(i,j,k+1)] - 2*V[IDXV(i,j,k)] + V[IDXV(i,j,k-1)])/(dz*dz);
+
+                    Real duv_dx = Real(0.25)*Dx*(
+                            xUpperCentral[k] - xLowerCentral[k] + alpha*(xUpperUpwind[k] - xLowerUpwind[k]));
+                    Real dv2_dy = Real(0.25)*Dy*(
+                            yUpperCentral[k] - yLowerCentral[k] + alpha*(yUpperUpwind[k] - yLowerUpwind[k]));
+                    Real dvw_dz = Real(0.25)*Dz*(
+                            zCentral[k] - zCentral[k-1] + alpha*(zUpwind[k] - zUpwind[k-1]));
+
+                    Real G_fluid = V[IDXV(i,j,k)] + dt * (
+                            viscosity*(d2v_dx2+d2v_dy2+d2v_dz2)-
+                            duv_dx-dv2_dy-dvw_dz+
+                            gravityY-(beta/2)*(T[IDXT(i,j,k)]+T[IDXT(i,j+1,k)])*gravityY
+                    );
+
+                    const uint8_t mask = maskG[IDXG(i,j,k)];
+                    G[IDXG(i,j,k)] = mask == FGH_MASK_COMPUTE ? G_fluid
+                            : (mask == FGH_MASK_COPY ? V[IDXV(i,j,k)] : G[IDXG(i,j,k)]);
+                }
+                fluxes.swapY();
+            }
+            fluxes.swapX();
+        }
+
+        // The right-hand side of the PPE needs the values of F in the x-planes of the neighboring threads.
+        #pragma omp barrier
+
+        for (int j = 1; j <= jmax && il <= iu; j++) {
+            computeMomentumFluxLineCpp(
+                    kmax-1, &U[IDXU(il-1,j,1)], &U[IDXU(il-1,j,2)], &W[IDXW(il-1,j,1)], &W[IDXW(il,j,1)],
+                    fluxes.xLowerCentral + j*planeStride + 1, fluxes.xLowerUpwind + j*planeStride + 1);
+        }
+        for (int i = il; i <= iu; i++) {
+            computeMomentumFluxLineCpp(
+                    kmax-1, &V[IDXV(i,0,1)], &V[IDXV(i,0,2)], &W[IDXW(i,0,1)], &W[IDXW(i,1,1)],
+                    fluxes.yLowerCentral + 1, fluxes.yLowerUpwind + 1);
+            for (int j = 1; j <= jmax; j++) {
+                const Real *xLowerCentral = fluxes.xLowerCentral + j*planeStride;
+                const Real *xLowerUpwind = fluxes.xLowerUpwind + j*planeStride;
+                Real *xUpperCentral = fluxes.xUpperCentral + j*planeStride;
+                Real *xUpperUpwind = fluxes.xUpperUpwind + j*planeStride;
+                const Real *yLowerCentral = fluxes.yLowerCentral, *yLowerUpwind = fluxes.yLowerUpwind;
+                Real *yUpperCentral = fluxes.yUpperCentral, *yUpperUpwind = fluxes.yUpperUpwind;
+                Real *zCentral = fluxes.zCentral, *zUpwind = fluxes.zUpwind;
+                computeMomentumFluxLineCpp(
+                        kmax-1, &U[IDXU(i,j,1)], &U[IDXU(i,j,2)], &W[IDXW(i,j,1)], &W[IDXW(i+1,j,1)],
+                        xUpperCentral + 1, xUpperUpwind + 1);
+                computeMomentumFluxLineCpp(
+                        kmax-1, &V[IDXV(i,j,1)], &V[IDXV(i,j,2)], &W[IDXW(i,j,1)], &W[IDXW(i,j+1,1)],
+                        yUpperCentral + 1, yUpperUpwind + 1);
+                computeMomentumFluxLineCpp(
+                        kmax, &W[IDXW(i,j,0)], &W[IDXW(i,j,1)], &W[IDXW(i,j,0)], &W[IDXW(i,j,1)],
+                        zCentral, zUpwind);
+
+                #pragma omp simd
+                for (int k = 1; k <= kmax-1; k++) {
+                    Real d2w_dx2 = (W[IDXW(i+1,j,k)] - 2*W[IDXW(i,j,k)] + W[IDXW(i-1,j,k)])/(dx*dx);
+                    Real d2w_dy2 = (W[IDXW(i,j+1,k)] - 2*W[IDXW(i,j,k)] + W[IDXW(i,j-1,k)])/(dy*dy);
+                    Real d2w_dz2 = (W[IDXW(i,j,k+1)] - 2*W[IDXW(i,j,k)] + W[IDXW(i,j,k-1)])/(dz*dz);
+
+                    Real duw_dx = Real(0.25)*Dx*(
+                            xUpperCentral[k] - xLowerCentral[k] + alpha*(xUpperUpwind[k] - xLowerUpwind[k]));
+                    Real dvw_dy = Real(0.25)*Dy*(
+                            yUpperCentral[k] - yLowerCentral[k] + alpha*(yUpperUpwind[k] - yLowerUpwind[k]));
+                    Real dw2_dz = Real(0.25)*Dz*(
+                            zCentral[k] - zCentral[k-1] + alpha*(zUpwind[k] - zUpwind[k-1]));
+
+                    Real H_fluid = W[IDXW(i,j,k)] +  dt * (
+                            viscosity*(d2w_dx2+d2w_dy2+d2w_dz2)-
+                            duw_dx-dvw_dy-dw2_dz+
+                            gravityZ-(beta/2)*(T[IDXT(i,j,k)]+T[IDXT(i,j,k+1)])*gravityZ
+                    );
+
+                    const uint8_t mask = maskH[IDXH(i,j,k)];
+                    H[IDXH(i,j,k)] = mask == FGH_MASK_COMPUTE ? H_fluid
+                            : (mask == FGH_MASK_COPY ? W[IDXW(i,j,k)] : H[IDXH(i,j,k)]);
+                }
+
+                // All faces of the cells of this z line are known now, so the right-hand side of the PPE (as in
+                // calculateRsCpp) is computed while F, G and H are still in the cache.
+                if (RS != nullptr) {
+                    #pragma omp simd
+                    for (int k = 1; k <= kmax; k++) {
+                        RS[IDXRS(i, j, k)] = ((F[IDXF(i, j, k)] - F[IDXF(i - 1, j, k)]) / dx +
+                                (G[IDXG(i, j, k)] - G[IDXG(i, j - 1, k)]) / dy +
+                                (H[IDXH(i, j, k)] - H[IDXH(i, j, k - 1)]) / dz) / dt;
+                    }
+                }
+                fluxes.swapY();
+            }
+            fluxes.swapX();
+        }
+    }
 }
 
 void calculateRsCpp(
@@ -237,157 +417,337 @@ void calculateRsCpp(
     }
 }
 
-void calculateDtCpp(
-        Real Re, Real Pr, Real tau,
-        Real &dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W,
-        bool useTemperature) {
-    Real uMaxAbs = Real(0.0), vMaxAbs = Real(0.0), wMaxAbs = Real(0.0);
+void computeMaxVelocitiesCpp(
+        int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real &uMaxAbs, Real &vMaxAbs, Real &wMaxAbs) {
+    Real uMax = Real(0.0), vMax = Real(0.0), wMax = Real(0.0);
 
-    // First, compute the maximum absolute velocities in x, y and z direction.
-    #pragma omp parallel for reduction(max: uMaxAbs)
+    #pragma omp parallel for reduction(max: uMax)
     for (int i = 0; i <= imax; i++) {
         for (int j = 0; j <= jmax+1; j++) {
             for (int k = 0; k <= kmax+1; k++) {
-                uMaxAbs = std::max(uMaxAbs, std::abs(U[IDXU(i,j,k)]));
+                uMax = std::max(uMax, std::abs(U[IDXU(i,j,k)]));
             }
         }
     }
-    #pragma omp parallel for reduction(max: vMaxAbs)
+    #pragma omp parallel for reduction(max: vMax)
     for (int i = 0; i <= imax+1; i++) {
         for (int j = 0; j <= jmax; j++) {
             for (int k = 0; k <= kmax+1; k++) {
-                vMaxAbs = std::max(vMaxAbs, std::abs(V[IDXV(i,j,k)]));
+                vMax = std::max(vMax, std::abs(V[IDXV(i,j,k)]));
             }
         }
     }
 
-    #pragma omp parallel for reduction(max: wMaxAbs)
+    #pragma omp parallel for reduction(max: wMax)
     for (int i = 0; i <= imax+1; i++) {
         for (int j = 0; j <= jmax+1; j++) {
             for (int k = 0; k <= kmax; k++) {
-                wMaxAbs = std::max(wMaxAbs, std::abs(W[IDXW(i,j,k)]));
+                wMax = std::max(wMax, std::abs(W[IDXW(i,j,k)]));
+            }
+        }
+    }
+
+    uMaxAbs = uMax;
+    vMaxAbs = vMax;
+    wMaxAbs = wMax;
+}
+
+void createMaxVelocityDataCpp(int imax, int jmax, int kmax, FlagType *Flag, MaxVelocityDataCpp &maxVelocityData) {
+    // The faces between two fluid cells are exactly the faces updated by calculateUvwCpp. All other faces are listed.
+    std::vector<int> facesU, facesV, facesW;
+    for (int i = 0; i <= imax+1; i++) {
+        for (int j = 0; j <= jmax+1; j++) {
+            for (int k = 0; k <= kmax+1; k++) {
+                const bool isInnerFluidCell = i >= 1 && i <= imax && j >= 1 && j <= jmax && k >= 1 && k <= kmax
+                        && isFluid(Flag[IDXFLAG(i,j,k)]);
+                if (i <= imax && !(isInnerFluidCell && i <= imax-1 && isFluid(Flag[IDXFLAG(i+1,j,k)]))) {
+                    facesU.push_back(IDXU(i,j,k));
+                }
+                if (j <= jmax && !(isInnerFluidCell && j <= jmax-1 && isFluid(Flag[IDXFLAG(i,j+1,k)]))) {
+                    facesV.push_back(IDXV(i,j,k));
+                }
+                if (k <= kmax && !(isInnerFluidCell && k <= kmax-1 && isFluid(Flag[IDXFLAG(i,j,k+1)]))) {
+                    facesW.push_back(IDXW(i,j,k));
+                }
             }
         }
     }
 
+    // With many obstacles, the gather over the face lists is not cheaper than the reduction over the whole arrays.
+    const size_t numFaces = size_t(imax+1)*(jmax+2)*(kmax+2) + size_t(imax+2)*(jmax+1)*(kmax+2)
+            + size_t(imax+2)*(jmax+2)*(kmax+1);
+    const size_t numListedFaces = facesU.size() + facesV.size() + facesW.size();
+    if (Real(numListedFaces) > MAX_VELOCITY_FUSED_REDUCTION_MAX_FACE_FRACTION * Real(numFaces)) {
+        return;
+    }
+
+    maxVelocityData.numFacesU = int(facesU.size());
+    maxVelocityData.numFacesV = int(facesV.size());
+    maxVelocityData.numFacesW = int(facesW.size());
+    maxVelocityData.facesU = new int[facesU.size()];
+    maxVelocityData.facesV = new int[facesV.size()];
+    maxVelocityData.facesW = new int[facesW.size()];
+    std::copy(facesU.begin(), facesU.end(), maxVelocityData.facesU);
+    std::copy(facesV.begin(), facesV.end(), maxVelocityData.facesV);
+    std::copy(facesW.begin(), facesW.end(), maxVelocityData.facesW);
+}
+
+void destroyMaxVelocityDataCpp(MaxVelocityDataCpp &maxVelocityData) {
+    delete[] maxVelocityData.facesU;
+    delete[] maxVelocityData.facesV;
+    delete[] maxVelocityData.facesW;
+    maxVelocityData = MaxVelocityDataCpp();
+}
+
+void computeMaxVelocitiesListedFacesCpp(Real *U, Real *V, Real *W, MaxVelocityDataCpp &maxVelocityData) {
+    Real uMax = maxVelocityData.uMaxAbs, vMax = maxVelocityData.vMaxAbs, wMax = maxVelocityData.wMaxAbs;
+    const int *facesU = maxVelocityData.facesU;
+    const int *facesV = maxVelocityData.facesV;
+    const int *facesW = maxVelocityData.facesW;
+
+    #pragma omp parallel for reduction(max: uMax)
+    for (int f = 0; f < maxVelocityData.numFacesU; f++) {
+        uMax = std::max(uMax, std::abs(U[facesU[f]]));
+    }
+    #pragma omp parallel for reduction(max: vMax)
+    for (int f = 0; f < maxVelocityData.numFacesV; f++) {
+        vMax = std::max(vMax, std::abs(V[facesV[f]]));
+    }
+    #pragma omp parallel for reduction(max: wMax)
+    for (int f = 0; f < maxVelocityData.numFacesW; f++) {
+        wMax = std::max(wMax, std::abs(W[facesW[f]]));
+    }
+
+    maxVelocityData.uMaxAbs = uMax;
+    maxVelocityData.vMaxAbs = vMax;
+    maxVelocityData.wMaxAbs = wMax;
+}
+
+/**
+ * Without the diffusive terms, the explicit donor-cell discretization of the convective terms is only stable if
+ * dt * sum_d u_d^2 / (alpha*|u_d|*h_d + 2*nu) <= 1 (von Neumann analysis, d: x, y, z direction, nu: diffusivity).
+ * @return The maximum time step size according to this condition.
+ */
+static Real calculateConvectiveDtLimitCpp(
+        Real nu, Real alpha, Real dx, Real dy, Real dz, Real uMaxAbs, Real vMaxAbs, Real wMaxAbs) {
+    Real inverseDt =
+            uMaxAbs*uMaxAbs / (alpha*uMaxAbs*dx + 2*nu)
+            + vMaxAbs*vMaxAbs / (alpha*vMaxAbs*dy + 2*nu)
+            + wMaxAbs*wMaxAbs / (alpha*wMaxAbs*dz + 2*nu);
+    return Real(1.0) / inverseDt;
+}
+
+void calculateDtFromMaxVelocitiesCpp(
+        Real Re, Real Pr, Real alpha, Real tau,
+        Real &dt, Real dx, Real dy, Real dz, Real uMaxAbs, Real vMaxAbs, Real wMaxAbs,
+        bool useTemperature, bool implicitDiffusion, TimeIntegratorType timeIntegrator) {
+    // The stability limits of the time integration scheme relative to forward Euler.
+    Real convectiveFactor = Real(1.0), diffusiveFactor = Real(1.0);
+    if (timeIntegrator == TIME_INTEGRATOR_ADAMS_BASHFORTH_2) {
+        convectiveFactor = ADAMS_BASHFORTH_2_CONVECTIVE_DT_FACTOR;
+        diffusiveFactor = ADAMS_BASHFORTH_2_DIFFUSIVE_DT_FACTOR;
+    } else if (timeIntegrator == TIME_INTEGRATOR_RUNGE_KUTTA_3) {
+        convectiveFactor = RUNGE_KUTTA_3_CONVECTIVE_DT_FACTOR;
+        diffusiveFactor = RUNGE_KUTTA_3_DIFFUSIVE_DT_FACTOR;
+    }
+
     if (tau < Real(0.0)) {
         // Constant time step manually specified in configuration file. Check for stability.
-        assert(2 / Re * dt < dx * dx * dy * dy * dz * dz / (dx * dx + dy * dy + dz * dz));
-        assert(uMaxAbs * dt < dx);
-        assert(vMaxAbs * dt < dy);
-        assert(wMaxAbs * dt < dz);
-        if (useTemperature){
-            assert(dt < (Re*Pr/2)*(1/((1/(dx*dx))+1/(dy*dy)+1/(dz*dz))));
+        assert(implicitDiffusion
+                || 2 / Re * dt < diffusiveFactor * dx * dx * dy * dy * dz * dz / (dx * dx + dy * dy + dz * dz));
+        assert(uMaxAbs * dt < convectiveFactor * dx);
+        assert(vMaxAbs * dt < convectiveFactor * dy);
+        assert(wMaxAbs * dt < convectiveFactor * dz);
+        if (useTemperature && !implicitDiffusion){
+            assert(dt < diffusiveFactor*(Re*Pr/2)*(1/((1/(dx*dx))+1/(dy*dy)+1/(dz*dz))));
         }
         return;
     }
 
     // Now, use formula (14) from worksheet 1 to compute the time step size.
-    dt = std::min(dx / uMaxAbs, dy / vMaxAbs);
-    dt = std::min(dt, dz / wMaxAbs);
-    dt = std::min(dt, (Re / Real(2.0)) * (Real(1.0) / (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy)
-            + Real(1.0) / (dz*dz))));
+    Real dtDiffusion = (Re / Real(2.0)) * (Real(1.0) / (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy)
+            + Real(1.0) / (dz*dz)));
     if (useTemperature){
-        dt = std::min(dt, (Re * Pr / Real(2.0)) * (Real(1.0) / (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy)
-                + Real(1.0) / (dz*dz))));
+        dtDiffusion = std::min(dtDiffusion, (Re * Pr / Real(2.0)) * (Real(1.0) / (Real(1.0) / (dx*dx)
+                + Real(1.0) / (dy*dy) + Real(1.0) / (dz*dz))));
+    }
+    dt = std::min(dx / uMaxAbs, dy / vMaxAbs);
+    dt = convectiveFactor * std::min(dt, dz / wMaxAbs);
+    if (implicitDiffusion) {
+        // Backward Euler is unconditionally stable for the diffusive terms. The time step size is still bounded, as the
+        // solution of the diffusion equations gets more expensive and the lagged boundary values get less accurate.
+        dt = std::min(dt, IMPLICIT_DIFFUSION_MAX_DT_FACTOR * dtDiffusion);
+        dt = std::min(dt, convectiveFactor * calculateConvectiveDtLimitCpp(
+                1 / Re, alpha, dx, dy, dz, uMaxAbs, vMaxAbs, wMaxAbs));
+        if (useTemperature) {
+            dt = std::min(dt, convectiveFactor * calculateConvectiveDtLimitCpp(
+                    1 / (Re * Pr), alpha, dx, dy, dz, uMaxAbs, vMaxAbs, wMaxAbs));
+        }
+    } else {
+        dt = std::min(dt, diffusiveFactor * dtDiffusion);
     }
     dt = tau * dt;
 }
 
+void calculateDtCpp(
+        Real Re, Real Pr, Real alpha, Real tau,
+        Real &dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W,
+        bool useTemperature, bool implicitDiffusion, TimeIntegratorType timeIntegrator) {
+    // First, compute the maximum absolute velocities in x, y and z direction.
+    Real uMaxAbs, vMaxAbs, wMaxAbs;
+    computeMaxVelocitiesCpp(imax, jmax, kmax, U, V, W, uMaxAbs, vMaxAbs, wMaxAbs);
+    calculateDtFromMaxVelocitiesCpp(
+            Re, Pr, alpha, tau, dt, dx, dy, dz, uMaxAbs, vMaxAbs, wMaxAbs, useTemperature, implicitDiffusion,
+            timeIntegrator);
+}
+
 void calculateUvwCpp(
         Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W, Real *F, Real *G, Real *H, Real *P, FlagType *Flag) {
-    #pragma omp parallel for
+        Real *U, Real *V, Real *W, Real *F, Real *G, Real *H, Real *P, FlagType *Flag,
+        Real &uMaxAbs, Real &vMaxAbs, Real &wMaxAbs) {
+    Real uMax = Real(0.0), vMax = Real(0.0), wMax = Real(0.0);
+
+    #pragma omp parallel for reduction(max: uMax)
     for (int i = 1; i <= imax - 1; i++) {
         for (int j = 1; j <= jmax; j++) {
             for (int k = 1; k <= kmax; k++) {
                 if(isFluid(Flag[IDXFLAG(i,j,k)]) && isFluid(Flag[IDXFLAG(i+1,j,k)])){
                     U[IDXU(i, j, k)] = F[IDXF(i, j, k)] - dt / dx * (P[IDXP(i + 1, j, k)] - P[IDXP(i, j, k)]);
+                    uMax = std::max(uMax, std::abs(U[IDXU(i, j, k)]));
                 }
             }
         }
     }
 
-    #pragma omp parallel for
+    #pragma omp parallel for reduction(max: vMax)
     for (int i = 1; i <= imax; i++) {
         for (int j = 1; j <= jmax - 1; j++) {
             for (int k = 1; k <= kmax; k++) {
                 if(isFluid(Flag[IDXFLAG(i,j,k)]) && isFluid(Flag[IDXFLAG(i,j+1,k)])){
                     V[IDXV(i, j, k)] = G[IDXG(i, j, k)] - dt / dy * (P[IDXP(i, j + 1, k)] - P[IDXP(i, j, k)]);
+                    vMax = std::max(vMax, std::abs(V[IDXV(i, j, k)]));
                 }
             }
         }
     }
 
-    #pragma omp parallel for
+    #pragma omp parallel for reduction(max: wMax)
     for (int i = 1; i <= imax; i++) {
         for (int j = 1; j <= jmax; j++) {
             for (int k = 1; k <= kmax - 1; k++) {
                 if(isFluid(Flag[IDXFLAG(i,j,k)]) && isFluid(Flag[IDXFLAG(i,j,k+1)])){
                     W[IDXW(i, j, k)] = H[IDXH(i, j, k)] - dt / dz * (P[IDXP(i, j, k + 1)] - P[IDXP(i, j, k)]);
+                    wMax = std::max(wMax, std::abs(W[IDXW(i, j, k)]));
                 }
             }
         }
     }
-}
 
-void calculateTemperatureCpp(
-        Real Re, Real Pr, Real alpha,
-        Real dt, Real dx, Real dy, Real dz,
-        int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W, Real *T, Real *T_temp, FlagType *Flag) {
-    Real duT_dx, dvT_dy, dwT_dz, d2T_dx2, d2T_dy2, d2T_dz2;
+    uMaxAbs = uMax;
+    vMaxAbs = vMax;
+    wMaxAbs = wMax;
+}
 
-    #pragma omp parallel for private(duT_dx, dvT_dy, dwT_dz, d2T_dx2, d2T_dy2, d2T_dz2)
+Real computeDivergenceNormCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W, FlagType *Flag) {
+    Real divergenceSum = Real(0.0);
+    int numFluidCells = 0;
+    #pragma omp parallel for reduction(+: divergenceSum) reduction(+: numFluidCells)
     for (int i = 1; i <= imax; i++) {
         for (int j = 1; j <= jmax; j++) {
             for (int k = 1; k <= kmax; k++) {
-                if(isFluid(Flag[IDXFLAG(i,j,k)])){
-                    duT_dx = 1 / dx * (
-                            U[IDXU(i, j, k)] * ((T_temp[IDXT(i, j, k)] + T_temp[IDXT(i + 1, j, k)]) / 2) -
-                            U[IDXU(i - 1, j, k)] * ((T_temp[IDXT(i - 1, j, k)] + T_temp[IDXT(i, j, k)]) / 2) +
-                            alpha * (
-                                    std::abs(U[IDXU(i, j, k)])*((T_temp[IDXT(i, j, k)] - T_temp[IDXT(i + 1, j, k)]) / 2) -
-                                    std::abs(U[IDXU(i - 1, j, k)])*((T_temp[IDXT(i - 1, j, k)] - T_temp[IDXT(i, j, k)]) / 2)
-                            )
-                    );
-
-                    dvT_dy = 1 / dy * (
-                            V[IDXV(i, j, k)] * ((T_temp[IDXT(i, j, k)] + T_temp[IDXT(i, j + 1, k)]) / 2) -
-                            V[IDXV(i, j - 1, k)] * ((T_temp[IDXT(i, j - 1, k)] + T_temp[IDXT(i, j, k)]) / 2) +
-                            alpha * (
-                                    std::abs(V[IDXV(i, j, k)])*((T_temp[IDXT(i, j, k)] - T_temp[IDXT(i, j + 1, k)]) / 2) -
-                                    std::abs(V[IDXV(i, j - 1, k)])*((T_temp[IDXT(i, j - 1, k)] - T_temp[IDXT(i, j, k)]) / 2)
-                            )
-                    );
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    Real divergence = (U[IDXU(i,j,k)] - U[IDXU(i-1,j,k)]) / dx
+                            + (V[IDXV(i,j,k)] - V[IDXV(i,j-1,k)]) / dy
+                            + (W[IDXW(i,j,k)] - W[IDXW(i,j,k-1)]) / dz;
+                    divergenceSum += divergence * divergence;
+                    numFluidCells++;
+                }
+            }
+        }
+    }
 
-                    dwT_dz = 1 / dz * (
-                            W[IDXW(i, j, k)] * ((T_temp[IDXT(i, j, k)] + T_temp[IDXT(i, j, k + 1)]) / 2) -
-                            W[IDXW(i, j, k - 1)] * ((T_temp[IDXT(i, j, k - 1)] + T_temp[IDXT(i, j, k)]) / 2) +
-                            alpha * (
-                                    std::abs(W[IDXW(i, j, k)])*((T_temp[IDXT(i, j, k)] - T_temp[IDXT(i, j, k + 1)]) / 2) -
-                                    std::abs(W[IDXW(i, j, k - 1)])*((T_temp[IDXT(i, j, k - 1)] - T_temp[IDXT(i, j, k)]) / 2)
-                            )
-                    );
+    // The divergence is normalized by dividing by the total number of fluid cells (like the residual of the PPE).
+    return numFluidCells == 0 ? Real(0.0) : std::sqrt(divergenceSum / numFluidCells);
+}
 
-                    d2T_dx2 =
+void calculateTemperatureCpp(
+        Real Re, Real Pr, Real alpha,
+        Real dt, Real dx, Real dy, Real dz,
+        int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W, Real *T, Real *T_temp, FlagType *Flag, bool implicitDiffusion) {
+    const int planeStride = kmax+2;
+    // With implicit diffusion, the diffusive term is added by solveImplicitTemperatureDiffusionCpp afterwards.
+    const Real diffusivity = implicitDiffusion ? Real(0.0) : 1 / (Re*Pr);
+
+    // Flux form with rolling buffers of the face fluxes, like in calculateFghCpp.
+    #pragma omp parallel
+    {
+        const int threadIdx = omp_get_thread_num();
+        const int numThreads = omp_get_num_threads();
+        const int il = 1 + threadIdx * imax / numThreads;
+        const int iu = (threadIdx + 1) * imax / numThreads;
+        FaceFluxBuffersCpp fluxes(jmax, kmax);
+
+        for (int j = 1; j <= jmax && il <= iu; j++) {
+            computeTemperatureFluxLineCpp(
+                    kmax, &U[IDXU(il-1,j,1)], &T_temp[IDXT(il-1,j,1)], &T_temp[IDXT(il,j,1)],
+                    fluxes.xLowerCentral + j*planeStride + 1, fluxes.xLowerUpwind + j*planeStride + 1);
+        }
+        for (int i = il; i <= iu; i++) {
+            computeTemperatureFluxLineCpp(
+                    kmax, &V[IDXV(i,0,1)], &T_temp[IDXT(i,0,1)], &T_temp[IDXT(i,1,1)],
+                    fluxes.yLowerCentral + 1, fluxes.yLowerUpwind + 1);
+            for (int j = 1; j <= jmax; j++) {
+                const Real *xLowerCentral = fluxes.xLowerCentral + j*planeStride;
+                const Real *xLowerUpwind = fluxes.xLowerUpwind + j*planeStride;
+                Real *xUpperCentral = fluxes.xUpperCentral + j*planeStride;
+                Real *xUpperUpwind = fluxes.xUpperUpwind + j*planeStride;
+                const Real *yLowerCentral = fluxes.yLowerCentral, *yLowerUpwind = fluxes.yLowerUpwind;
+                Real *yUpperCentral = fluxes.yUpperCentral, *yUpperUpwind = fluxes.yUpperUpwind;
+                Real *zCentral = fluxes.zCentral, *zUpwind = fluxes.zUpwind;
+                computeTemperatureFluxLineCpp(
+                        kmax, &U[IDXU(i,j,1)], &T_temp[IDXT(i,j,1)], &T_temp[IDXT(i+1,j,1)],
+                        xUpperCentral + 1, xUpperUpwind + 1);
+                computeTemperatureFluxLineCpp(
+                        kmax, &V[IDXV(i,j,1)], &T_temp[IDXT(i,j,1)], &T_temp[IDXT(i,j+1,1)],
+                        yUpperCentral + 1, yUpperUpwind + 1);
+                computeTemperatureFluxLineCpp(
+                        kmax+1, &W[IDXW(i,j,0)], &T_temp[IDXT(i,j,0)], &T_temp[IDXT(i,j,1)], zCentral, zUpwind);
+
+                #pragma omp simd
+                for (int k = 1; k <= kmax; k++) {
+                    Real duT_dx = 1 / dx * (
+                            xUpperCentral[k] - xLowerCentral[k] + alpha * (xUpperUpwind[k] - xLowerUpwind[k]));
+                    Real dvT_dy = 1 / dy * (
+                            yUpperCentral[k] - yLowerCentral[k] + alpha * (yUpperUpwind[k] - yLowerUpwind[k]));
+                    Real dwT_dz = 1 / dz * (
+                            zCentral[k] - zCentral[k-1] + alpha * (zUpwind[k] - zUpwind[k-1]));
+
+                    Real d2T_dx2 =
                             (T_temp[IDXT(i + 1, j, k)] - 2 * T_temp[IDXT(i, j, k)] + T_temp[IDXT(i - 1, j, k)]) / (dx*dx);
 
-                    d2T_dy2 =
+                    Real d2T_dy2 =
                             (T_temp[IDXT(i, j + 1, k)] - 2 * T_temp[IDXT(i, j, k)] + T_temp[IDXT(i, j - 1, k)]) / (dy*dy);
 
-                    d2T_dz2 =
+                    Real d2T_dz2 =
                             (T_temp[IDXT(i, j, k + 1)] - 2 * T_temp[IDXT(i, j, k)] + T_temp[IDXT(i, j, k - 1)]) / (dz*dz);
 
-                    T[IDXT(i, j, k)] = T_temp[IDXT(i, j, k)] + dt * (
-                            (1 / (Re*Pr))*(d2T_dx2 + d2T_dy2 + d2T_dz2) -
+                    Real T_fluid = T_temp[IDXT(i, j, k)] + dt * (
+                            diffusivity*(d2T_dx2 + d2T_dy2 + d2T_dz2) -
                             duT_dx -
                             dvT_dy -
                             dwT_dz
                     );
+                    T[IDXT(i, j, k)] = isFluid(Flag[IDXFLAG(i,j,k)]) ? T_fluid : T[IDXT(i, j, k)];
                 }
+                fluxes.swapY();
             }
+            fluxes.swapX();
         }
     }
 }
+
+}
@@ -29,15 +29,46 @@
 #ifndef CFD3D_UVWCPP_HPP
 #define CFD3D_UVWCPP_HPP
 
+#include <cstdint>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
+// The possible values of the face masks of calculateFghCpp.
+const uint8_t FGH_MASK_KEEP = 0; ///< The face is not touched (e.g., inside of obstacles).
+const uint8_t FGH_MASK_COMPUTE = 1; ///< The face lies between two fluid cells, so F, G or H is computed.
+const uint8_t FGH_MASK_COPY = 2; ///< The face lies at an obstacle boundary, so the velocity is copied to F, G or H.
+
+/**
+ * One byte per face of the staggered grid (in the layout of F, G and H, i.e., indexed with IDXF, IDXG and IDXH) that
+ * encodes which of the branches of the momentum kernel applies to the face. The masks only depend on the flag array,
+ * so they are precomputed once, and calculateFghCpp can blend the results instead of branching on the flags per cell.
+ */
+struct FghMasksCpp {
+    uint8_t *maskF = nullptr, *maskG = nullptr, *maskH = nullptr;
+};
+
+/**
+ * Computes the face masks of calculateFghCpp from the flag array.
+ */
+void createFghMasksCpp(int imax, int jmax, int kmax, FlagType *Flag, FghMasksCpp &fghMasks);
+
+/**
+ * Frees the memory allocated by createFghMasksCpp.
+ */
+void destroyFghMasksCpp(FghMasksCpp &fghMasks);
+
 /*
  * Determines the value of F, H and H for computing RS.
+ * @param implicitDiffusion If true, the viscous terms and the body forces are left out
+ * (@see solveImplicitMomentumDiffusionCpp).
+ * @param RS If not nullptr, the right-hand side of the PPE is computed in the same sweep (like calculateRsCpp).
  */
 void calculateFghCpp(
         Real Re, Real GX, Real GY, Real GZ, Real alpha, Real beta,
         Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W, Real *T, Real *F, Real *G, Real *H, FlagType *Flag);
+        Real *U, Real *V, Real *W, Real *T, Real *F, Real *G, Real *H, const FghMasksCpp &fghMasks,
+        bool implicitDiffusion, Real *RS);
 
 /*
  * Computes the right hand side of the Pressure Poisson Equation (PPE).
@@ -46,29 +77,112 @@ void calculateRsCpp(
         Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
         Real *F, Real *G, Real *H, Real *RS);
 
+/**
+ * The fused time step pipeline (CfdSolverCpp::step) only needs to reduce the listed faces if at most this fraction of
+ * all faces is not updated by calculateUvwCpp.
+ */
+const Real MAX_VELOCITY_FUSED_REDUCTION_MAX_FACE_FRACTION = Real(0.25);
+
+/**
+ * The maximum absolute velocities for computing the time step size in the fused time step pipeline.
+ * calculateUvwCpp computes the maxima over the faces it updates (i.e., the faces between two fluid cells), which are
+ * not changed by the boundary conditions afterwards. Thus, only the remaining faces (ghost cells, domain boundary and
+ * obstacles), which are listed here, need to be reduced again after setting the boundary values.
+ */
+struct MaxVelocityDataCpp {
+    int numFacesU = 0, numFacesV = 0, numFacesW = 0;
+    int *facesU = nullptr, *facesV = nullptr, *facesW = nullptr;
+    Real uMaxAbs = Real(0.0), vMaxAbs = Real(0.0), wMaxAbs = Real(0.0);
+    // Whether uMaxAbs, vMaxAbs and wMaxAbs hold the maxima of the faces updated in the last call of calculateUvwCpp.
+    bool isValid = false;
+};
+
+/**
+ * Lists the faces not updated by calculateUvwCpp. If there are too many of these faces
+ * (@see MAX_VELOCITY_FUSED_REDUCTION_MAX_FACE_FRACTION), the lists are not created (i.e., facesU is nullptr).
+ */
+void createMaxVelocityDataCpp(int imax, int jmax, int kmax, FlagType *Flag, MaxVelocityDataCpp &maxVelocityData);
+
+/**
+ * Frees the memory allocated by createMaxVelocityDataCpp.
+ */
+void destroyMaxVelocityDataCpp(MaxVelocityDataCpp &maxVelocityData);
+
+/**
+ * Updates the maxima in maxVelocityData with the absolute velocities on the listed faces.
+ */
+void computeMaxVelocitiesListedFacesCpp(Real *U, Real *V, Real *W, MaxVelocityDataCpp &maxVelocityData);
+
+/**
+ * Computes the maximum absolute velocities in x, y and z direction (including the ghost cells).
+ */
+void computeMaxVelocitiesCpp(
+        int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real &uMaxAbs, Real &vMaxAbs, Real &wMaxAbs);
+
+/**
+ * With implicit diffusion, the time step size may be at most this factor times the stability limit of the explicit
+ * diffusive terms.
+ */
+const Real IMPLICIT_DIFFUSION_MAX_DT_FACTOR = Real(20.0);
+
+/**
+ * The stability limits of the time integrators relative to forward Euler. The diffusive factors are the ratios of the
+ * extents of the stability regions along the negative real axis (Euler: 2, Adams-Bashforth 2: 1, Runge-Kutta 3: 2.51).
+ * The eigenvalues of the donor-cell convection operator lie on a circle through the origin centered on the negative
+ * real axis, which fits into the stability region of Adams-Bashforth 2 for half the radius of forward Euler and into
+ * the one of the strong stability preserving Runge-Kutta 3 method for the same radius.
+ */
+const Real ADAMS_BASHFORTH_2_CONVECTIVE_DT_FACTOR = Real(0.5);
+const Real ADAMS_BASHFORTH_2_DIFFUSIVE_DT_FACTOR = Real(0.5);
+const Real RUNGE_KUTTA_3_CONVECTIVE_DT_FACTOR = Real(1.0);
+const Real RUNGE_KUTTA_3_DIFFUSIVE_DT_FACTOR = Real(1.25);
+
+/**
+ * Determines the maximum time step size from the maximum absolute velocities (@see calculateDtCpp).
+ */
+void calculateDtFromMaxVelocitiesCpp(
+        Real Re, Real Pr, Real alpha, Real tau,
+        Real &dt, Real dx, Real dy, Real dz, Real uMaxAbs, Real vMaxAbs, Real wMaxAbs,
+        bool useTemperature, bool implicitDiffusion, TimeIntegratorType timeIntegrator);
+
 /*
  * Determines the maximum time step size. The time step size is restricted according to the CFL theorem.
+ * @param implicitDiffusion If true, the stability limit of the diffusive terms is replaced by the stability limit of
+ * the explicit convective terms alone and by IMPLICIT_DIFFUSION_MAX_DT_FACTOR times the diffusive limit.
+ * @param timeIntegrator The stability limits of the explicit terms are scaled by the factors of the time integrator.
  */
 void calculateDtCpp(
-        Real Re, Real Pr, Real tau,
+        Real Re, Real Pr, Real alpha, Real tau,
         Real &dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
         Real *U, Real *V, Real *W,
-        bool useTemperature);
+        bool useTemperature, bool implicitDiffusion, TimeIntegratorType timeIntegrator);
 
 /*
  * Calculates the new velocity values.
+ * @param uMaxAbs, vMaxAbs, wMaxAbs The maximum absolute values of the updated velocities.
  */
 void calculateUvwCpp(
         Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W, Real *F, Real *G, Real *H, Real *P, FlagType *Flag);
+        Real *U, Real *V, Real *W, Real *F, Real *G, Real *H, Real *P, FlagType *Flag,
+        Real &uMaxAbs, Real &vMaxAbs, Real &wMaxAbs);
+
+/**
+ * Computes the norm of the divergence of the velocity field normalized by the number of fluid cells.
+ */
+Real computeDivergenceNormCpp(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real *U, Real *V, Real *W, FlagType *Flag);
 
 /*
  * Calculates the new temperature values.
+ * @param implicitDiffusion If true, the diffusive term is left out (@see solveImplicitTemperatureDiffusionCpp).
  */
 void calculateTemperatureCpp(
         Real Re, Real Pr, Real alpha,
         Real dt, Real dx, Real dy, Real dz,
         int imax, int jmax, int kmax,
-        Real *U, Real *V, Real *W, Real *T, Real *T_temp, FlagType *Flag);
+        Real *U, Real *V, Real *W, Real *T, Real *T_temp, FlagType *Flag, bool implicitDiffusion);
+
+}
 
 #endif //CFD3D_UVWCPP_HPP
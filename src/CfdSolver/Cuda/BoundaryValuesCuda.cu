@@ -30,6 +30,8 @@
 #include "../../Defines.hpp"
 #include "CudaDefines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 __global__ void setLeftRightBoundariesCuda(
         Real T_h, Real T_c,
         int imax, int jmax, int kmax,
@@ -575,3 +577,5 @@ void setBoundaryValuesScenarioSpecificCuda(
         setMountainBoundariesCuda<<<dimBlock2D, dimGrid_y_z>>>(imax, jmax, kmax, U, V, W, Flag);
     }
 }
+
+}
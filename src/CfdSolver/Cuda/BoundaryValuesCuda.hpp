@@ -32,6 +32,8 @@
 #include <string>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Sets the boundary condition values of U, V, W and T using the Flag array.
  */
@@ -52,4 +54,6 @@ void setBoundaryValuesScenarioSpecificCuda(
         Real *U, Real *V, Real *W,
         FlagType *Flag);
 
+}
+
 #endif //CFD3D_BOUNDARYVALUESCUDA_HPP
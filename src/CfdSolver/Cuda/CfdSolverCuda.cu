@@ -34,6 +34,8 @@
 #include "CfdSolverCuda.hpp"
 #include "../../Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 
 CfdSolverCuda::CfdSolverCuda(int blockSizeX, int blockSizeY, int blockSizeZ, int blockSize1D) {
     this->blockSizeX = blockSizeX;
@@ -44,9 +46,10 @@ CfdSolverCuda::CfdSolverCuda(int blockSizeX, int blockSizeY, int blockSizeZ, int
 
 void CfdSolverCuda::initialize(
         const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-        Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-        int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+        Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+        bool adaptiveOmega, Real epsRelative, bool /*implicitDiffusion*/, TimeIntegratorType /*timeIntegrator*/,
+        Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+        bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
         Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag) {
     this->scenarioName = scenarioName;
     this->linearSystemSolverType = linearSystemSolverType;
@@ -56,6 +59,7 @@ void CfdSolverCuda::initialize(
     this->omg = omg;
     this->eps = eps;
     this->itermax = itermax;
+    this->residualCheckInterval = residualCheckInterval;
     this->alpha = alpha;
     this->beta = beta;
     this->dt = dt;
@@ -108,6 +112,7 @@ void CfdSolverCuda::initialize(
     cudaMemcpy(this->V, V, sizeof(Real)*(imax+2)*(jmax+1)*(kmax+2), cudaMemcpyHostToDevice);
     cudaMemcpy(this->W, W, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+1), cudaMemcpyHostToDevice);
     cudaMemcpy(this->P, P, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2), cudaMemcpyHostToDevice);
+    cudaMemcpy(this->P_temp, P, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2), cudaMemcpyHostToDevice);
     cudaMemcpy(this->T, T, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2), cudaMemcpyHostToDevice);
     cudaMemcpy(this->Flag, Flag, sizeof(unsigned int)*(imax+2)*(jmax+2)*(kmax+2), cudaMemcpyHostToDevice);
 }
@@ -184,7 +189,7 @@ void CfdSolverCuda::calculateRs() {
 
 void CfdSolverCuda::executeSorSolver() {
     sorSolverCuda(
-            omg, eps, itermax, linearSystemSolverType, shallWriteOutput,
+            omg, eps, itermax, residualCheckInterval, linearSystemSolverType, shallWriteOutput,
             dx, dy, dz, imax, jmax, kmax,
             blockSizeX, blockSizeY, blockSizeZ, blockSize1D, P, P_temp, RS, Flag,
             cudaReductionArrayResidual1, cudaReductionArrayResidual2,
@@ -205,3 +210,5 @@ void CfdSolverCuda::getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real *T
     cudaMemcpy(P, this->P, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2), cudaMemcpyDeviceToHost);
     cudaMemcpy(T, this->T, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2), cudaMemcpyDeviceToHost);
 }
+
+}
@@ -27,9 +27,12 @@
  */
 
 #include <iostream>
+#include <utility>
 #include "SorSolverCuda.hpp"
 #include "CudaDefines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 __global__ void setXYPlanesPressureBoundaries(
         int imax, int jmax, int kmax, Real *P) {
     int i = blockIdx.y * blockDim.y + threadIdx.y + 1;
@@ -203,10 +206,10 @@ __global__ void sorSolverIterationCuda(
 
     if (i <= imax && j <= jmax && k <= kmax) {
         if (isFluid(Flag[IDXFLAG(i,j,k)])) {
-            P[IDXP(i, j, k)] = (Real(1.0) - omg) * P_temp[IDXP(i, j, k)] + coeff *
-                    ((P_temp[IDXP(i + 1, j, k)] + P_temp[IDXP(i - 1, j, k)]) / (dx * dx)
-                     + (P_temp[IDXP(i, j + 1, k)] + P_temp[IDXP(i, j - 1, k)]) / (dy * dy)
-                     + (P_temp[IDXP(i, j, k + 1)] + P_temp[IDXP(i, j, k - 1)]) / (dz * dz)
+            P_temp[IDXP(i, j, k)] = (Real(1.0) - omg) * P[IDXP(i, j, k)] + coeff *
+                    ((P[IDXP(i + 1, j, k)] + P[IDXP(i - 1, j, k)]) / (dx * dx)
+                     + (P[IDXP(i, j + 1, k)] + P[IDXP(i, j - 1, k)]) / (dy * dy)
+                     + (P[IDXP(i, j, k + 1)] + P[IDXP(i, j, k - 1)]) / (dz * dz)
                      - RS[IDXRS(i, j, k)]);
         }
     }
@@ -237,10 +240,10 @@ __global__ void sorSolverComputeResidualArrayCuda(
 }
 
 void sorSolverCuda(
-        Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
         int blockSizeX, int blockSizeY, int blockSizeZ, int blockSize1D,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag,
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag,
         Real *cudaReductionArrayResidual1, Real *cudaReductionArrayResidual2,
         unsigned int *cudaReductionArrayNumCells1, unsigned int *cudaReductionArrayNumCells2) {
     if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL) {
@@ -254,38 +257,46 @@ void sorSolverCuda(
     const Real coeff = omg / (2.0 * (1.0 / (dx*dx) + 1.0 / (dy*dy) + 1.0 / (dz*dz)));
     Real residual = 1e9;
     int it = 0;
+    dim3 dimBlock2D(blockSizeX, blockSizeY);
+    dim3 dimGrid_x_y(iceil(jmax, dimBlock2D.x), iceil(imax, dimBlock2D.y));
+    dim3 dimGrid_x_z(iceil(kmax, dimBlock2D.x), iceil(imax, dimBlock2D.y));
+    dim3 dimGrid_y_z(iceil(kmax, dimBlock2D.x), iceil(jmax, dimBlock2D.y));
+    dim3 dimBlock(blockSizeX, blockSizeY, blockSizeZ);
+    dim3 dimGrid(iceil(kmax, dimBlock.x), iceil(jmax, dimBlock.y), iceil(imax, dimBlock.z));
     while (it < itermax && residual > eps) {
-        dim3 dimBlock2D(blockSizeX, blockSizeY);
-        dim3 dimGrid_x_y(iceil(jmax, dimBlock2D.x), iceil(imax, dimBlock2D.y));
         setXYPlanesPressureBoundaries<<<dimGrid_x_y, dimBlock2D>>>(imax, jmax, kmax, P);
-
-        dim3 dimGrid_x_z(iceil(kmax, dimBlock2D.x), iceil(imax, dimBlock2D.y));
         setXZPlanesPressureBoundaries<<<dimGrid_x_z, dimBlock2D>>>(imax, jmax, kmax, P);
-
-        dim3 dimGrid_y_z(iceil(kmax, dimBlock2D.x), iceil(jmax, dimBlock2D.y));
         setYZPlanesPressureBoundaries<<<dimGrid_y_z, dimBlock2D>>>(imax, jmax, kmax, P);
-
-        dim3 dimBlock(blockSizeX, blockSizeY, blockSizeZ);
-        dim3 dimGrid(iceil(kmax, dimBlock.x), iceil(jmax, dimBlock.y), iceil(imax, dimBlock.z));
         setBoundaryConditionsPressureInDomainCuda<<<dimGrid, dimBlock>>>(imax, jmax, kmax, P, Flag);
 
-        cudaMemcpy(P_temp, P, sizeof(Real) * (imax + 2) * (jmax + 2) * (kmax + 2), cudaMemcpyDeviceToDevice);
-
+        // The new values are written to P_temp. Swapping the buffers replaces the device-to-device copy of P.
         sorSolverIterationCuda<<<dimGrid, dimBlock>>>(
                 omg, dx, dy, dz, coeff, imax, jmax, kmax, P, P_temp, RS, Flag);
-
-        sorSolverComputeResidualArrayCuda<<<dimGrid, dimBlock>>>(
-                dx, dy, dz, imax, jmax, kmax, P, RS, Flag, cudaReductionArrayResidual1, cudaReductionArrayNumCells1);
-
-        residual = reduceSumCuda(
-                cudaReductionArrayResidual1, imax*jmax*kmax, cudaReductionArrayResidual2, blockSize1D);
-        unsigned int numFluidCells = reduceSumCuda(
-                cudaReductionArrayNumCells1, imax*jmax*kmax, cudaReductionArrayNumCells2, blockSize1D);
-        residual = std::sqrt(residual / Real(numFluidCells));
+        std::swap(P, P_temp);
 
         it++;
+
+        // Convergence is only checked every residualCheckInterval iterations. The boundary values of the current buffer
+        // were last set two iterations ago, so they are updated before computing the residual.
+        if (it % residualCheckInterval == 0 || it == itermax) {
+            setXYPlanesPressureBoundaries<<<dimGrid_x_y, dimBlock2D>>>(imax, jmax, kmax, P);
+            setXZPlanesPressureBoundaries<<<dimGrid_x_z, dimBlock2D>>>(imax, jmax, kmax, P);
+            setYZPlanesPressureBoundaries<<<dimGrid_y_z, dimBlock2D>>>(imax, jmax, kmax, P);
+            setBoundaryConditionsPressureInDomainCuda<<<dimGrid, dimBlock>>>(imax, jmax, kmax, P, Flag);
+            sorSolverComputeResidualArrayCuda<<<dimGrid, dimBlock>>>(
+                    dx, dy, dz, imax, jmax, kmax, P, RS, Flag,
+                    cudaReductionArrayResidual1, cudaReductionArrayNumCells1);
+
+            residual = reduceSumCuda(
+                    cudaReductionArrayResidual1, imax*jmax*kmax, cudaReductionArrayResidual2, blockSize1D);
+            unsigned int numFluidCells = reduceSumCuda(
+                    cudaReductionArrayNumCells1, imax*jmax*kmax, cudaReductionArrayNumCells2, blockSize1D);
+            residual = std::sqrt(residual / Real(numFluidCells));
+        }
     }
 
+    // The loop only terminates after a residual check, so the boundary values of the current buffer are up to date.
+
     if (((residual > eps && it == itermax) || std::isnan(residual)) && shallWriteOutput) {
         std::cerr << "\nSOR solver reached maximum number of iterations without converging (res: "
                   << residual << ")." << std::endl;
@@ -295,3 +306,5 @@ void sorSolverCuda(
         exit(1);
     }
 }
+
+}
@@ -31,15 +31,20 @@
 
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Uses an SOR solver to compute the updated pressure values using the pressure poisson equation (PPE).
+ * The iterations alternate between P and P_temp, so the two pointers may be swapped after the call.
  */
 void sorSolverCuda(
-        Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
         int blockSizeX, int blockSizeY, int blockSizeZ, int blockSize1D,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag,
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag,
         Real *cudaReductionArrayResidual1, Real *cudaReductionArrayResidual2,
         unsigned int *cudaReductionArrayNumCells1, unsigned int *cudaReductionArrayNumCells2);
 
+}
+
 #endif //CFD3D_SORSOLVERCUDA_HPP
@@ -31,6 +31,8 @@
 #include "UvwCuda.hpp"
 #include "CudaDefines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 __global__ void calculateFghCudaKernel(
         Real Re, Real GX, Real GY, Real GZ, Real alpha, Real beta,
         Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
@@ -496,3 +498,5 @@ __global__ void calculateTemperatureCuda(
         }
     }
 }
+
+}
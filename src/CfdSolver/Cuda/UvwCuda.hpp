@@ -31,6 +31,8 @@
 
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /*
  * Determines the value of F, H and H for computing RS.
  */
@@ -75,4 +77,6 @@ __global__ void calculateTemperatureCuda(
         int imax, int jmax, int kmax,
         Real *U, Real *V, Real *W, Real *T, Real *T_temp, FlagType *Flag);
 
+}
+
 #endif //CFD3D_UVWCUDA_HPP
@@ -33,6 +33,22 @@
 #include <vector>
 #include "Defines.hpp"
 
+// Bit values of the flags. For more details, see docs/FlagsBitfield.pdf.
+const unsigned int FLAG_FLUID = 0x1;
+const unsigned int FLAG_NO_SLIP = 0x2;
+const unsigned int FLAG_FREE_SLIP = 0x4;
+const unsigned int FLAG_OUTFLOW = 0x8;
+const unsigned int FLAG_INFLOW = 0x10;
+const unsigned int FLAG_B_L = 0x20;
+const unsigned int FLAG_B_R = 0x40;
+const unsigned int FLAG_B_D = 0x80;
+const unsigned int FLAG_B_U = 0x100;
+const unsigned int FLAG_B_B = 0x200;
+const unsigned int FLAG_B_F = 0x400;
+const unsigned int FLAG_HOT = 0x800;
+const unsigned int FLAG_COLD = 0x1000;
+const unsigned int FLAG_COUPLING = 0x2000;
+
 // Inline flag testing functions. For more details, see docs/FlagsBitfield.pdf.
 // TODO: Add more inline functions.
 inline bool isFluid(unsigned int flag) { return (flag >> 0) & 1; }
@@ -28,6 +28,8 @@
 
 #include "Init.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void initArrays(
         Real UI, Real VI, Real WI, Real PI, Real TI, int imax, int jmax, int kmax,
         Real *U, Real *V, Real *W, Real *P, Real *T, FlagType *Flag) {
@@ -107,3 +109,5 @@ void initArraysMpi(
         }
     }
 }
+
+}
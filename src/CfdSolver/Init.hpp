@@ -31,6 +31,8 @@
 
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Initializes the passed arrays U, V, W, P and T. For fluid cells, UI, VI, WI, PI and TI are used.
  * For obstacle cells (or edges between an obstacle cell and a fluid cell or edges between two obstacle cells), the
@@ -61,4 +63,6 @@ void initArraysMpi(
         Real UI, Real VI, Real WI, Real PI, Real TI, int il, int iu, int jl, int ju, int kl, int ku,
         Real *U, Real *V, Real *W, Real *P, Real *T, FlagType *Flag);
 
+}
+
 #endif //CFD3D_INIT_HPP
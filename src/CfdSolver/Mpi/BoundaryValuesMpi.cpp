@@ -30,6 +30,8 @@
 #include "../Flag.hpp"
 #include "DefinesMpi.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void setLeftRightBoundariesMpi(
         Real T_h, Real T_c,
         int imax, int jmax, int kmax,
@@ -631,3 +633,5 @@ void setBoundaryValuesScenarioSpecificMpi(
         }
     }
 }
+
+}
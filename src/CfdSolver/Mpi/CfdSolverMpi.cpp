@@ -31,10 +31,16 @@
 #include "BoundaryValuesMpi.hpp"
 #include "UvwMpi.hpp"
 #include "SorSolverMpi.hpp"
+#include "PressureHistoryMpi.hpp"
+#include "ChebyshevMpi.hpp"
+#include "MultigridMpi.hpp"
 #include "CfdSolverMpi.hpp"
+#include "CfdSolver/AdaptiveTolerance.hpp"
 #include "MpiHelpers.hpp"
 #include "DefinesMpi.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 CfdSolverMpi::CfdSolverMpi(
         int il, int iu, int jl, int ju, int kl, int ku,
         int myrank, int rankL, int rankR, int rankD, int rankU, int rankB, int rankF) {
@@ -55,9 +61,10 @@ CfdSolverMpi::CfdSolverMpi(
 
 void CfdSolverMpi::initialize(
         const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-        Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-        int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+        Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+        bool adaptiveOmega, Real epsRelative, bool /*implicitDiffusion*/, TimeIntegratorType /*timeIntegrator*/,
+        Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+        bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
         Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag) {
     this->scenarioName = scenarioName;
     this->linearSystemSolverType = linearSystemSolverType;
@@ -67,6 +74,9 @@ void CfdSolverMpi::initialize(
     this->omg = omg;
     this->eps = eps;
     this->itermax = itermax;
+    this->residualCheckInterval = residualCheckInterval;
+    this->adaptiveOmegaData.isEnabled = adaptiveOmega;
+    this->epsRelative = epsRelative;
     this->alpha = alpha;
     this->beta = beta;
     this->dt = dt;
@@ -125,6 +135,23 @@ void CfdSolverMpi::initialize(
             (ju - jl + 2) * (ku - kl + 2));
     bufSend = new Real[maxMpiBufferSize];
     bufRecv = new Real[maxMpiBufferSize];
+
+    createPressureOperatorMpi(
+            dx, dy, dz, imax, jmax, kmax, il, iu, jl, ju, kl, ku, this->Flag, pressureOperator);
+    if (linearSystemSolverType == LINEAR_SOLVER_CHEBYSHEV) {
+        createChebyshevDataMpi(
+                il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv,
+                pressureOperator, chebyshevData);
+    }
+    if (linearSystemSolverType == LINEAR_SOLVER_MULTIGRID
+            || linearSystemSolverType == LINEAR_SOLVER_MULTIGRID_W_CYCLE) {
+        createMultigridDataMpi(
+                dx, dy, dz, imax, jmax, kmax, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF,
+                this->P, this->RS, this->Flag, pressureOperator, multigridData);
+    }
+    if (pressureHistorySize > 0) {
+        createPressureHistoryMpi(pressureHistorySize, il, iu, jl, ju, kl, ku, pressureHistory);
+    }
 }
 
 CfdSolverMpi::~CfdSolverMpi() {
@@ -143,6 +170,11 @@ CfdSolverMpi::~CfdSolverMpi() {
 
     delete[] bufSend;
     delete[] bufRecv;
+
+    destroyPressureOperatorMpi(pressureOperator);
+    destroyPressureHistoryMpi(pressureHistory);
+    destroyChebyshevDataMpi(chebyshevData);
+    destroyMultigridDataMpi(multigridData);
 }
 
 void CfdSolverMpi::setBoundaryValues() {
@@ -179,10 +211,29 @@ void CfdSolverMpi::calculateRs() {
 
 
 void CfdSolverMpi::executeSorSolver() {
+    if (pressureHistory.maxSize > 0) {
+        computePressureInitialGuessMpi(il, iu, jl, ju, kl, ku, P, RS, pressureHistory);
+    }
+    Real epsStep = eps;
+    if (epsRelative > Real(0.0)) {
+        // The velocities are still the ones of the last time step, i.e., this is the divergence it left behind.
+        Real divergence = computeDivergenceNormMpi(dx, dy, dz, il, iu, jl, ju, kl, ku, U, V, W, Flag);
+        Real rsNorm = computeRsNormMpi(il, iu, jl, ju, kl, ku, RS, Flag, pressureOperator);
+        epsStep = computeAdaptiveTolerance(eps, epsRelative, dt, rsNorm, divergence);
+        if (myrank == 0 && shallWriteOutput) {
+            std::cout << "\nDivergence: " << divergence << ", PPE tolerance: " << epsStep << std::endl;
+        }
+    }
     sorSolverMpi(
-            myrank, omg, eps, itermax, linearSystemSolverType, shallWriteOutput,
-            dx, dy, dz, imax, jmax, kmax, il, iu, jl, ju, kl, ku,
-            rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, P, P_temp, RS, Flag);
+            myrank, omg, epsStep, itermax, residualCheckInterval, linearSystemSolverType, shallWriteOutput,
+            imax, jmax, kmax, il, iu, jl, ju, kl, ku,
+            rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, P, P_temp, RS, Flag,
+            pressureOperator, chebyshevData, multigridData, adaptiveOmegaData);
+    if (pressureHistory.maxSize > 0) {
+        addPressureSolutionMpi(
+                il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv,
+                P, pressureOperator, pressureHistory);
+    }
 }
 
 void CfdSolverMpi::calculateUvw() {
@@ -199,3 +250,5 @@ void CfdSolverMpi::getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real *T)
     memcpy(P, this->P, sizeof(Real)*(iu - il + 3)*(ju - jl + 3)*(ku - kl + 3));
     memcpy(T, this->T, sizeof(Real)*(iu - il + 3)*(ju - jl + 3)*(ku - kl + 3));
 }
+
+}
@@ -30,6 +30,13 @@
 #define CFD3D_CFDSOLVERMPI_HPP
 
 #include "CfdSolver/CfdSolver.hpp"
+#include "PressureOperatorMpi.hpp"
+#include "PressureHistoryMpi.hpp"
+#include "ChebyshevMpi.hpp"
+#include "MultigridMpi.hpp"
+#include "CfdSolver/AdaptiveOmega.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
 
 class CfdSolverMpi : public CfdSolver {
 public:
@@ -48,6 +55,16 @@ public:
      * @param omg The over-relaxation factor of the SOR solver.
      * @param eps The residual value (epsilon) for which the solution of the SOR solver is considered as converged.
      * @param itermax The maximum number of iterations the SOR solver performs until it gives up.
+     * @param residualCheckInterval The number of iterations of the SOR solver after which the convergence is checked.
+     * @param pressureHistorySize The number of previous pressure solutions the initial guess of the SOR solver is
+     * computed from (0: The last solution is used as the initial guess).
+     * @param adaptiveOmega Whether the over-relaxation factor of the SOR solver is estimated online instead of using a
+     * fixed value (@see AdaptiveOmega.hpp).
+     * @param epsRelative If > 0, the residual for which the solution of the PPE is considered as converged is chosen in
+     * each time step relative to the norm of the right-hand side (@see AdaptiveTolerance.hpp). eps is then a lower
+     * bound.
+     * @param implicitDiffusion Ignored, as the MPI solver only supports the explicit treatment of the diffusive terms.
+     * @param timeIntegrator Ignored, as the MPI solver only supports forward Euler time integration.
      * @param alpha Donor-cell scheme factor.
      * @param beta Coefficient of thermal expansion.
      * @param dt If tau > 0: The constant time step to use for simulating. Otherwise, dt is overwritten each iteration.
@@ -74,9 +91,10 @@ public:
      */
     virtual void initialize(
             const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-            Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-            Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-            int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+            Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+            bool adaptiveOmega, Real epsRelative, bool implicitDiffusion, TimeIntegratorType timeIntegrator,
+            Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+            bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
             Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag);
 
     /**
@@ -144,9 +162,9 @@ private:
     std::string scenarioName;
     LinearSystemSolverType linearSystemSolverType;
     bool shallWriteOutput;
-    Real Re, Pr, omg, eps, alpha, beta, dt, tau, GX, GY, GZ, T_h, T_c;
+    Real Re, Pr, omg, eps, epsRelative, alpha, beta, dt, tau, GX, GY, GZ, T_h, T_c;
     bool useTemperature;
-    int itermax;
+    int itermax, residualCheckInterval;
     int imax, jmax, kmax;
     int il, iu, jl, ju, kl, ku;
     int myrank, rankL, rankR, rankD, rankU, rankB, rankF;
@@ -154,7 +172,22 @@ private:
     Real *U, *V, *W, *P, *P_temp, *T, *T_temp, *F, *G, *H, *RS;
     FlagType *Flag;
     Real *bufSend, *bufRecv;
+
+    // The Laplace operator of the PPE including the boundary conditions.
+    PressureOperatorMpi pressureOperator;
+    // The last pressure solutions for computing the initial guess of the iterative solvers for the PPE.
+    PressureHistoryMpi pressureHistory;
+
+    // Only used by the Chebyshev solver for the PPE.
+    ChebyshevDataMpi chebyshevData;
+    // Only used by the multigrid solvers for the PPE.
+    MultigridDataMpi multigridData;
+
+    // The online estimate of the over-relaxation factor of the SOR type solvers.
+    AdaptiveOmegaData adaptiveOmegaData;
 };
 
 
+}
+
 #endif //CFD3D_CFDSOLVERMPI_HPP
@@ -0,0 +1,256 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "MpiHelpers.hpp"
+#include "../Cpp/ChebyshevCpp.hpp"
+#include "ChebyshevMpi.hpp"
+#include "DefinesMpi.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Computes the global inner product x^T D y with the diagonal D of the pressure operator (fluid cells only).
+ */
+static double diagonalInnerProductMpi(
+        int il, int iu, int jl, int ju, int kl, int ku, const Real *X, const Real *Y, const Real *diagonalInverse) {
+    double innerProduct = 0.0;
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    innerProduct += double(X[IDXP(i,j,k)]) * double(Y[IDXP(i,j,k)])
+                            / double(diagonalInverse[IDXP(i,j,k)]);
+                }
+            }
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &innerProduct, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return innerProduct;
+}
+
+/**
+ * Removes the component of X in the null space of the operator (i.e., the constant vector on all fluid cells of the
+ * global domain) with respect to the inner product weighted by the diagonal.
+ */
+static void removeNullSpaceComponentMpi(
+        int il, int iu, int jl, int ju, int kl, int ku, Real *X, const Real *diagonalInverse) {
+    double sums[2] = { 0.0, 0.0 };
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    sums[0] += double(X[IDXP(i,j,k)]) / double(diagonalInverse[IDXP(i,j,k)]);
+                    sums[1] += 1.0 / double(diagonalInverse[IDXP(i,j,k)]);
+                }
+            }
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    if (sums[1] <= 0.0) {
+        return;
+    }
+    const Real mean = Real(sums[0] / sums[1]);
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    X[IDXP(i,j,k)] -= mean;
+                }
+            }
+        }
+    }
+}
+
+void createChebyshevDataMpi(
+        int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        PressureOperatorMpi &pressureOperator, ChebyshevDataMpi &chebyshevData) {
+    const int size = (iu - il + 3)*(ju - jl + 3)*(ku - kl + 3);
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    MPI_Status status;
+
+    chebyshevData.D = new Real[size];
+    memset(chebyshevData.D, 0, sizeof(Real)*size);
+
+    // Lanczos iteration for the operator D^-1 A (@see createChebyshevDataCpp).
+    Real *V = new Real[size];
+    Real *V_old = new Real[size];
+    Real *W = new Real[size];
+    memset(V, 0, sizeof(Real)*size);
+    memset(V_old, 0, sizeof(Real)*size);
+    memset(W, 0, sizeof(Real)*size);
+
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                if (diagonalInverse[IDXP(i,j,k)] > Real(0.0)) {
+                    V[IDXP(i,j,k)] = lanczosStartValue(i, j, k);
+                }
+            }
+        }
+    }
+    removeNullSpaceComponentMpi(il, iu, jl, ju, kl, ku, V, diagonalInverse);
+    double norm = std::sqrt(diagonalInnerProductMpi(il, iu, jl, ju, kl, ku, V, V, diagonalInverse));
+
+    std::vector<double> alpha, beta;
+    const int numSteps = std::min(CHEBYSHEV_LANCZOS_STEPS, pressureOperator.numFluidCells - 1);
+    for (int step = 0; step < numSteps && norm > 0.0; step++) {
+        const Real normInverse = Real(1.0 / norm);
+        for (int idx = 0; idx < size; idx++) {
+            V[idx] *= normInverse;
+        }
+        mpiExchangeCellData(V, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, &status);
+
+        // W = D^-1 A V and alpha = V^T A V. A is the negative Laplace operator.
+        double vav = 0.0;
+        for (int i = il; i <= iu; i++) {
+            for (int j = jl; j <= ju; j++) {
+                for (int k = kl; k <= ku; k++) {
+                    const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                    const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                    const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                    Real av = (cR + cL + cU + cD + cF + cB)*V[IDXP(i,j,k)]
+                            - cR*V[IDXP(i+1,j,k)] - cL*V[IDXP(i-1,j,k)]
+                            - cU*V[IDXP(i,j+1,k)] - cD*V[IDXP(i,j-1,k)]
+                            - cF*V[IDXP(i,j,k+1)] - cB*V[IDXP(i,j,k-1)];
+                    W[IDXP(i,j,k)] = diagonalInverse[IDXP(i,j,k)] * av;
+                    vav += double(V[IDXP(i,j,k)]) * double(av);
+                }
+            }
+        }
+        MPI_Allreduce(MPI_IN_PLACE, &vav, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        alpha.push_back(vav);
+        if (step == numSteps - 1) {
+            break;
+        }
+
+        const Real a = Real(vav), b = beta.empty() ? Real(0.0) : Real(beta.back());
+        for (int idx = 0; idx < size; idx++) {
+            W[idx] -= a * V[idx] + b * V_old[idx];
+        }
+        removeNullSpaceComponentMpi(il, iu, jl, ju, kl, ku, W, diagonalInverse);
+        norm = std::sqrt(diagonalInnerProductMpi(il, iu, jl, ju, kl, ku, W, W, diagonalInverse));
+        if (norm <= 1e-10 * std::abs(vav)) {
+            break;
+        }
+        beta.push_back(norm);
+
+        Real *temp = V_old;
+        V_old = V;
+        V = W;
+        W = temp;
+    }
+
+    delete[] V;
+    delete[] V_old;
+    delete[] W;
+
+    chebyshevData.lambdaMax = Real(2.0);
+    double lambdaMin = alpha.empty() ? -1.0 : computeSmallestRitzValue(alpha, beta, 1e-7);
+    if (lambdaMin <= 0.0 || lambdaMin >= 1.0) {
+        lambdaMin = 1.0;
+    }
+    chebyshevData.lambdaMin = Real(lambdaMin);
+}
+
+void destroyChebyshevDataMpi(ChebyshevDataMpi &chebyshevData) {
+    delete[] chebyshevData.D;
+    chebyshevData = ChebyshevDataMpi();
+}
+
+void chebyshevSolverMpi(
+        Real eps, int itermax, int residualCheckInterval, int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        Real *P, Real *RS, PressureOperatorMpi &pressureOperator, ChebyshevDataMpi &chebyshevData,
+        Real &residual, int &it) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
+    Real *D = chebyshevData.D;
+    MPI_Status status;
+
+    const Real theta = (chebyshevData.lambdaMax + chebyshevData.lambdaMin) / Real(2.0);
+    const Real delta = (chebyshevData.lambdaMax - chebyshevData.lambdaMin) / Real(2.0);
+    const Real sigma = theta / delta;
+    const int checkInterval = std::max(residualCheckInterval, CHEBYSHEV_RESIDUAL_CHECK_INTERVAL);
+    Real rho = Real(1.0) / sigma;
+
+    for (int chebyshevIt = 0; it < itermax && residual > eps; chebyshevIt++) {
+        Real directionFactor = Real(0.0), residualFactor = Real(1.0) / theta;
+        if (chebyshevIt > 0) {
+            Real rhoNew = Real(1.0) / (Real(2.0) * sigma - rho);
+            directionFactor = rhoNew * rho;
+            residualFactor = Real(2.0) * rhoNew / delta;
+            rho = rhoNew;
+        }
+
+        const bool checkResidual = (it + 1) % checkInterval == 0 || it + 1 == itermax;
+        Real residualLocal = Real(0.0);
+        for (int i = il; i <= iu; i++) {
+            for (int j = jl; j <= ju; j++) {
+                for (int k = kl; k <= ku; k++) {
+                    const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                    const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                    const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                    Real r = cR*P[IDXP(i+1,j,k)] + cL*P[IDXP(i-1,j,k)]
+                            + cU*P[IDXP(i,j+1,k)] + cD*P[IDXP(i,j-1,k)]
+                            + cF*P[IDXP(i,j,k+1)] + cB*P[IDXP(i,j,k-1)]
+                            - RS[IDXRS(i,j,k)] - (cR + cL + cU + cD + cF + cB)*P[IDXP(i,j,k)];
+                    residualLocal += r*r;
+                    D[IDXP(i,j,k)] = directionFactor * D[IDXP(i,j,k)]
+                            + residualFactor * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+        for (int i = il; i <= iu; i++) {
+            for (int j = jl; j <= ju; j++) {
+                for (int k = kl; k <= ku; k++) {
+                    P[IDXP(i,j,k)] += D[IDXP(i,j,k)];
+                }
+            }
+        }
+        mpiExchangeCellData(P, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, &status);
+        it++;
+
+        if (checkResidual) {
+            MPI_Allreduce(MPI_IN_PLACE, &residualLocal, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
+            residual = pressureOperator.numFluidCells == 0 ?
+                    Real(0.0) : std::sqrt(residualLocal/pressureOperator.numFluidCells);
+        }
+    }
+}
+
+}
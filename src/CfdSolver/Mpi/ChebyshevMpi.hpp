@@ -0,0 +1,77 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_CHEBYSHEVMPI_HPP
+#define CFD3D_CHEBYSHEVMPI_HPP
+
+#include "Defines.hpp"
+#include "PressureOperatorMpi.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Data of the Chebyshev semi-iterative solver (@see ChebyshevDataCpp). The spectral bounds are estimated for the
+ * global operator, so they are the same on all processes.
+ */
+struct ChebyshevDataMpi {
+    // The bounds of the spectrum of D^-1 A without the null space of the operator.
+    Real lambdaMin = Real(0.0), lambdaMax = Real(0.0);
+    // The update direction of the last iteration (local pressure array size).
+    Real *D = nullptr;
+};
+
+/**
+ * Allocates the work array of the Chebyshev solver and estimates the spectral bounds of the pressure operator.
+ * Needs to be called by all processes.
+ */
+void createChebyshevDataMpi(
+        int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        PressureOperatorMpi &pressureOperator, ChebyshevDataMpi &chebyshevData);
+
+/**
+ * Frees the memory allocated by createChebyshevDataMpi.
+ */
+void destroyChebyshevDataMpi(ChebyshevDataMpi &chebyshevData);
+
+/**
+ * Solves the PPE using the Chebyshev semi-iterative method with a Jacobi preconditioner. Each iteration only needs
+ * one halo exchange. The only global reduction is the residual norm every residualCheckInterval (at least
+ * CHEBYSHEV_RESIDUAL_CHECK_INTERVAL) iterations. RS needs to be zero in all non-fluid cells.
+ * @param residual The residual at the last convergence check.
+ * @param it The number of iterations performed.
+ */
+void chebyshevSolverMpi(
+        Real eps, int itermax, int residualCheckInterval, int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        Real *P, Real *RS, PressureOperatorMpi &pressureOperator, ChebyshevDataMpi &chebyshevData,
+        Real &residual, int &it);
+
+}
+
+#endif //CFD3D_CHEBYSHEVMPI_HPP
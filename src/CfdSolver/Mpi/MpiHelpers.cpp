@@ -30,6 +30,8 @@
 #include "MpiHelpers.hpp"
 #include "DefinesMpi.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void mpiInit(
         int argc, char **argv,
         int iproc, int jproc, int kproc, int imax, int jmax, int kmax,
@@ -223,6 +225,99 @@ void mpiExchangeCellData(
     }
 }
 
+void mpiExchangeCellDataWithCorners(
+        Real *PT, int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
+        Real *bufSend, Real *bufRecv, MPI_Status *status) {
+    int chunk;
+
+    // Send to the left, receive from the right.
+    for (int j = jl; j <= ju && rankL != MPI_PROC_NULL; j++) {
+        for (int k = kl; k <= ku; k++) {
+            bufSend[(j - jl) * (ku - kl + 1) + (k - kl)] = PT[IDXP(il,j,k)];
+        }
+    }
+    chunk = (ju - jl + 1) * (ku - kl + 1);
+    MPI_Sendrecv(bufSend, chunk, MPI_REAL_CFD3D, rankL, 1, bufRecv, chunk, MPI_REAL_CFD3D, rankR, 1, MPI_COMM_WORLD, status);
+    for (int j = jl; j <= ju && rankR != MPI_PROC_NULL; j++) {
+        for (int k = kl; k <= ku; k++) {
+            PT[IDXP(iu + 1,j,k)] = bufRecv[(j - jl) * (ku - kl + 1) + (k - kl)];
+        }
+    }
+
+    // Send to the right, receive from the left.
+    for (int j = jl; j <= ju && rankR != MPI_PROC_NULL; j++) {
+        for (int k = kl; k <= ku; k++) {
+            bufSend[(j - jl) * (ku - kl + 1) + (k - kl)] = PT[IDXP(iu,j,k)];
+        }
+    }
+    chunk = (ju - jl + 1) * (ku - kl + 1);
+    MPI_Sendrecv(bufSend, chunk, MPI_REAL_CFD3D, rankR, 1, bufRecv, chunk, MPI_REAL_CFD3D, rankL, 1, MPI_COMM_WORLD, status);
+    for (int j = jl; j <= ju && rankL != MPI_PROC_NULL; j++) {
+        for (int k = kl; k <= ku; k++) {
+            PT[IDXP(il - 1,j,k)] = bufRecv[(j - jl) * (ku - kl + 1) + (k - kl)];
+        }
+    }
+
+
+    // Send to the bottom, receive from the top (including the halo cells in x direction).
+    for (int i = il - 1; i <= iu + 1 && rankD != MPI_PROC_NULL; i++) {
+        for (int k = kl; k <= ku; k++) {
+            bufSend[(i - il + 1) * (ku - kl + 1) + (k - kl)] = PT[IDXP(i,jl,k)];
+        }
+    }
+    chunk = (iu - il + 3) * (ku - kl + 1);
+    MPI_Sendrecv(bufSend, chunk, MPI_REAL_CFD3D, rankD, 1, bufRecv, chunk, MPI_REAL_CFD3D, rankU, 1, MPI_COMM_WORLD, status);
+    for (int i = il - 1; i <= iu + 1 && rankU != MPI_PROC_NULL; i++) {
+        for (int k = kl; k <= ku; k++) {
+            PT[IDXP(i,ju + 1,k)] = bufRecv[(i - il + 1) * (ku - kl + 1) + (k - kl)];
+        }
+    }
+
+    // Send to the top, receive from the bottom (including the halo cells in x direction).
+    for (int i = il - 1; i <= iu + 1 && rankU != MPI_PROC_NULL; i++) {
+        for (int k = kl; k <= ku; k++) {
+            bufSend[(i - il + 1) * (ku - kl + 1) + (k - kl)] = PT[IDXP(i,ju,k)];
+        }
+    }
+    chunk = (iu - il + 3) * (ku - kl + 1);
+    MPI_Sendrecv(bufSend, chunk, MPI_REAL_CFD3D, rankU, 1, bufRecv, chunk, MPI_REAL_CFD3D, rankD, 1, MPI_COMM_WORLD, status);
+    for (int i = il - 1; i <= iu + 1 && rankD != MPI_PROC_NULL; i++) {
+        for (int k = kl; k <= ku; k++) {
+            PT[IDXP(i,jl - 1,k)] = bufRecv[(i - il + 1) * (ku - kl + 1) + (k - kl)];
+        }
+    }
+
+
+    // Send to the back, receive from the front (including the halo cells in x and y direction).
+    for (int i = il - 1; i <= iu + 1 && rankB != MPI_PROC_NULL; i++) {
+        for (int j = jl - 1; j <= ju + 1; j++) {
+            bufSend[(i - il + 1) * (ju - jl + 3) + (j - jl + 1)] = PT[IDXP(i,j,kl)];
+        }
+    }
+    chunk = (iu - il + 3) * (ju - jl + 3);
+    MPI_Sendrecv(bufSend, chunk, MPI_REAL_CFD3D, rankB, 1, bufRecv, chunk, MPI_REAL_CFD3D, rankF, 1, MPI_COMM_WORLD, status);
+    for (int i = il - 1; i <= iu + 1 && rankF != MPI_PROC_NULL; i++) {
+        for (int j = jl - 1; j <= ju + 1; j++) {
+            PT[IDXP(i,j,ku + 1)] = bufRecv[(i - il + 1) * (ju - jl + 3) + (j - jl + 1)];
+        }
+    }
+
+    // Send to the front, receive from the back (including the halo cells in x and y direction).
+    for (int i = il - 1; i <= iu + 1 && rankF != MPI_PROC_NULL; i++) {
+        for (int j = jl - 1; j <= ju + 1; j++) {
+            bufSend[(i - il + 1) * (ju - jl + 3) + (j - jl + 1)] = PT[IDXP(i,j,ku)];
+        }
+    }
+    chunk = (iu - il + 3) * (ju - jl + 3);
+    MPI_Sendrecv(bufSend, chunk, MPI_REAL_CFD3D, rankF, 1, bufRecv, chunk, MPI_REAL_CFD3D, rankB, 1, MPI_COMM_WORLD, status);
+    for (int i = il - 1; i <= iu + 1 && rankB != MPI_PROC_NULL; i++) {
+        for (int j = jl - 1; j <= ju + 1; j++) {
+            PT[IDXP(i,j,kl - 1)] = bufRecv[(i - il + 1) * (ju - jl + 3) + (j - jl + 1)];
+        }
+    }
+}
+
 void mpiExchangeUvw(
         Real *U, Real *V, Real *W, int il, int iu, int jl, int ju, int kl, int ku,
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
@@ -480,7 +575,49 @@ void mpiExchangeUvw(
     }
 }
 
+void mpiAllgatherCellData(
+        const Real *PT, int il, int iu, int jl, int ju, int kl, int ku, int jmax, int kmax,
+        const std::vector<int> &localRanges, Real *PT_global) {
+    const int nproc = int(localRanges.size()) / 6;
+    std::vector<int> recvCounts(nproc), displacements(nproc);
+    int totalSize = 0;
+    for (int p = 0; p < nproc; p++) {
+        const int *range = &localRanges.at(6*p);
+        recvCounts.at(p) = (range[1] - range[0] + 1) * (range[3] - range[2] + 1) * (range[5] - range[4] + 1);
+        displacements.at(p) = totalSize;
+        totalSize += recvCounts.at(p);
+    }
+
+    std::vector<Real> bufSend((iu - il + 1) * (ju - jl + 1) * (ku - kl + 1));
+    std::vector<Real> bufRecv(totalSize);
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                bufSend[((i - il) * (ju - jl + 1) + (j - jl)) * (ku - kl + 1) + (k - kl)] = PT[IDXP(i,j,k)];
+            }
+        }
+    }
+    MPI_Allgatherv(
+            bufSend.data(), int(bufSend.size()), MPI_REAL_CFD3D, bufRecv.data(), recvCounts.data(),
+            displacements.data(), MPI_REAL_CFD3D, MPI_COMM_WORLD);
+
+    // The data of each process is stored in the same order as it was packed above.
+    for (int p = 0; p < nproc; p++) {
+        const int *range = &localRanges.at(6*p);
+        int idx = displacements.at(p);
+        for (int i = range[0]; i <= range[1]; i++) {
+            for (int j = range[2]; j <= range[3]; j++) {
+                for (int k = range[4]; k <= range[5]; k++) {
+                    PT_global[IDXP_NORMAL(i,j,k)] = bufRecv[idx++];
+                }
+            }
+        }
+    }
+}
+
 void mpiStop() {
     MPI_Barrier(MPI_COMM_WORLD);
     MPI_Finalize();
 }
+
+}
@@ -31,8 +31,11 @@
 
 //#include "mpi.h"
 #include "mpi.h"
+#include <vector>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void mpiInit(
         int argc, char **argv,
         int iproc, int jproc, int kproc, int imax, int jmax, int kmax,
@@ -55,11 +58,34 @@ void mpiExchangeCellData(
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
         Real *bufSend, Real *bufRecv, MPI_Status *status);
 
+/**
+ * Same as mpiExchangeCellData, but additionally exchanges the edge and corner cells of the halo. For this, the
+ * exchange in y direction includes the halo cells received in x direction, and the exchange in z direction includes
+ * the halo cells received in x and y direction. The buffers need to hold (iu-il+3)*(ju-jl+3), (iu-il+3)*(ku-kl+3)
+ * and (ju-jl+3)*(ku-kl+3) values.
+ */
+void mpiExchangeCellDataWithCorners(
+        Real *PT, int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
+        Real *bufSend, Real *bufRecv, MPI_Status *status);
+
 void mpiExchangeUvw(
         Real *U, Real *V, Real *W, int il, int iu, int jl, int ju, int kl, int ku,
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
         Real *bufSend, Real *bufRecv, MPI_Status *status);
 
+/**
+ * Gathers the interior cells of the distributed array PT of all processes in the global array PT_global on all
+ * processes. PT has the layout of the local pressure array, and PT_global has the layout of the pressure array of the
+ * non-MPI solvers (i.e., (imax+2)*(jmax+2)*(kmax+2) entries). The halo and ghost cells of PT_global are not changed.
+ * @param localRanges The index ranges il, iu, jl, ju, kl, ku of all processes (six entries per process).
+ */
+void mpiAllgatherCellData(
+        const Real *PT, int il, int iu, int jl, int ju, int kl, int ku, int jmax, int kmax,
+        const std::vector<int> &localRanges, Real *PT_global);
+
 void mpiStop();
 
+}
+
 #endif //CFD3D_MPIHELPERS_HPP
@@ -0,0 +1,541 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "../Flag.hpp"
+#include "MpiHelpers.hpp"
+#include "SorSolverMpi.hpp"
+#include "MultigridMpi.hpp"
+#include "DefinesMpi.hpp"
+
+/**
+ * For accessing the 1D-arrays of a distributed multigrid level as 3D-arrays.
+ */
+#define IDXP_LEVEL(level,i,j,k) (((i) - ((level).il-1))*((level).ju - (level).jl + 3)*((level).ku - (level).kl + 3) \
+        + ((j) - ((level).jl-1))*((level).ku - (level).kl + 3) + ((k) - ((level).kl-1)))
+#define IDXRS_LEVEL(level,i,j,k) (((i) - (level).il)*((level).ju - (level).jl + 1)*((level).ku - (level).kl + 1) \
+        + ((j) - (level).jl)*((level).ku - (level).kl + 1) + ((k) - (level).kl))
+#define IDXFLAG_LEVEL(level,i,j,k) IDXP_LEVEL(level,i,j,k)
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+// Number of smoothing sweeps before and after the coarse grid correction.
+const int NUM_PRE_SMOOTHING_SWEEPS = 2;
+const int NUM_POST_SMOOTHING_SWEEPS = 2;
+
+// A level is agglomerated if the subdomain of at least one process has less cells than this. Below this size, the
+// halo exchanges are dominated by the latency, and most processes would idle on the coarser levels anyway.
+const int MULTIGRID_AGGLOMERATION_MIN_LOCAL_CELLS = 512;
+
+// The number of serial multigrid cycles used for solving the agglomerated level.
+const int NUM_AGGLOMERATED_LEVEL_CYCLES = 2;
+
+/**
+ * Returns the size of the local arrays of the level including the halo cells.
+ */
+inline int getLevelSizeP(const MultigridLevelMpi &level) {
+    return (level.iu - level.il + 3) * (level.ju - level.jl + 3) * (level.ku - level.kl + 3);
+}
+
+/**
+ * Returns the size of the local arrays of the level without the halo cells.
+ */
+inline int getLevelSizeRS(const MultigridLevelMpi &level) {
+    return (level.iu - level.il + 1) * (level.ju - level.jl + 1) * (level.ku - level.kl + 1);
+}
+
+void exchangeMultigridLevelMpi(
+        const MultigridLevelMpi &level, Real *PT,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, MultigridDataMpi &multigridData) {
+    MPI_Status status;
+    mpiExchangeCellDataWithCorners(
+            PT, level.il, level.iu, level.jl, level.ju, level.kl, level.ku, rankL, rankR, rankD, rankU, rankB, rankF,
+            multigridData.bufSend.data(), multigridData.bufRecv.data(), &status);
+}
+
+/**
+ * Coarsens the Flag array of the fine level. A coarse cell is fluid if any of its children is fluid, as otherwise thin
+ * channels in the geometry would be closed on the coarse levels. Only the fluid bit is used on the coarse levels.
+ */
+void coarsenMultigridFlagMpi(
+        const MultigridLevelMpi &fine, MultigridLevelMpi &coarse,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, MultigridDataMpi &multigridData) {
+    // The flags are exchanged as a real-valued fluid indicator. Ghost cells outside of the domain stay non-fluid.
+    std::vector<Real> fluidIndicator(getLevelSizeP(coarse), Real(0.0));
+    for (int i = coarse.il; i <= coarse.iu; i++) {
+        for (int j = coarse.jl; j <= coarse.ju; j++) {
+            for (int k = coarse.kl; k <= coarse.ku; k++) {
+                bool isFluidCell = false;
+                for (int fi = (i-1)*coarse.ci+1; fi <= i*coarse.ci; fi++) {
+                    for (int fj = (j-1)*coarse.cj+1; fj <= j*coarse.cj; fj++) {
+                        for (int fk = (k-1)*coarse.ck+1; fk <= k*coarse.ck; fk++) {
+                            isFluidCell = isFluidCell || isFluid(fine.Flag[IDXFLAG_LEVEL(fine,fi,fj,fk)]);
+                        }
+                    }
+                }
+                fluidIndicator[IDXP_LEVEL(coarse,i,j,k)] = isFluidCell ? Real(1.0) : Real(0.0);
+            }
+        }
+    }
+    exchangeMultigridLevelMpi(
+            coarse, fluidIndicator.data(), rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+
+    for (int idx = 0; idx < getLevelSizeP(coarse); idx++) {
+        // Fluid or no-slip.
+        coarse.Flag[idx] = fluidIndicator[idx] > Real(0.5) ? FLAG_FLUID : FLAG_NO_SLIP;
+    }
+}
+
+/**
+ * Creates the global arrays of the agglomerated (i.e., coarsest distributed) level and the serial multigrid hierarchy
+ * used for solving it redundantly on all processes.
+ */
+void createAgglomeratedLevelMpi(MultigridDataMpi &multigridData) {
+    const MultigridLevelMpi &level = multigridData.levels.back();
+    const int imax = level.imax, jmax = level.jmax, kmax = level.kmax;
+
+    int nproc;
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    int localRange[6] = { level.il, level.iu, level.jl, level.ju, level.kl, level.ku };
+    multigridData.agglomerationRanges.resize(6*nproc);
+    MPI_Allgather(
+            localRange, 6, MPI_INT, multigridData.agglomerationRanges.data(), 6, MPI_INT, MPI_COMM_WORLD);
+
+    const int sizeP = (imax+2)*(jmax+2)*(kmax+2);
+    const int sizeRS = (imax+1)*(jmax+1)*(kmax+1);
+    multigridData.P_global = new Real[sizeP];
+    multigridData.P_temp_global = new Real[sizeP];
+    multigridData.RS_global = new Real[sizeRS];
+    multigridData.R_global = new Real[sizeP];
+    multigridData.Flag_global = new FlagType[sizeP];
+    memset(multigridData.P_global, 0, sizeof(Real)*sizeP);
+    memset(multigridData.P_temp_global, 0, sizeof(Real)*sizeP);
+    memset(multigridData.RS_global, 0, sizeof(Real)*sizeRS);
+    memset(multigridData.R_global, 0, sizeof(Real)*sizeP);
+
+    // Gather the fluid cells of all processes (R_global is used as the receive buffer).
+    std::vector<Real> fluidIndicator(getLevelSizeP(level), Real(0.0));
+    for (int i = level.il; i <= level.iu; i++) {
+        for (int j = level.jl; j <= level.ju; j++) {
+            for (int k = level.kl; k <= level.ku; k++) {
+                fluidIndicator[IDXP_LEVEL(level,i,j,k)] =
+                        isFluid(level.Flag[IDXFLAG_LEVEL(level,i,j,k)]) ? Real(1.0) : Real(0.0);
+            }
+        }
+    }
+    mpiAllgatherCellData(
+            fluidIndicator.data(), level.il, level.iu, level.jl, level.ju, level.kl, level.ku, jmax, kmax,
+            multigridData.agglomerationRanges, multigridData.R_global);
+
+    FlagType *Flag = multigridData.Flag_global;
+    for (int idx = 0; idx < sizeP; idx++) {
+        // Fluid or no-slip (the ghost cells were not written by the gather operation).
+        Flag[idx] = multigridData.R_global[idx] > Real(0.5) ? FLAG_FLUID : FLAG_NO_SLIP;
+    }
+    for (int i = 0; i <= imax+1; i++) {
+        for (int j = 0; j <= jmax+1; j++) {
+            for (int k = 0; k <= kmax+1; k++) {
+                if (i == 0 || j == 0 || k == 0 || i == imax+1 || j == jmax+1 || k == kmax+1) {
+                    Flag[IDXFLAG_NORMAL(i,j,k)] = FLAG_NO_SLIP;
+                }
+            }
+        }
+    }
+
+    // Set the neighbor bits of the obstacle cells in the interior (used for the pressure boundary values).
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                FlagType &flag = Flag[IDXFLAG_NORMAL(i,j,k)];
+                if (isFluid(flag)) {
+                    continue;
+                }
+                if (isFluid(Flag[IDXFLAG_NORMAL(i-1,j,k)])) flag |= FLAG_B_L;
+                if (isFluid(Flag[IDXFLAG_NORMAL(i+1,j,k)])) flag |= FLAG_B_R;
+                if (isFluid(Flag[IDXFLAG_NORMAL(i,j-1,k)])) flag |= FLAG_B_D;
+                if (isFluid(Flag[IDXFLAG_NORMAL(i,j+1,k)])) flag |= FLAG_B_U;
+                if (isFluid(Flag[IDXFLAG_NORMAL(i,j,k-1)])) flag |= FLAG_B_B;
+                if (isFluid(Flag[IDXFLAG_NORMAL(i,j,k+1)])) flag |= FLAG_B_F;
+            }
+        }
+    }
+
+    createMultigridHierarchyCpp(
+            level.dx, level.dy, level.dz, imax, jmax, kmax,
+            multigridData.P_global, multigridData.P_temp_global, multigridData.RS_global, Flag,
+            multigridData.agglomeratedLevels);
+}
+
+void createMultigridDataMpi(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
+        Real *P, Real *RS, FlagType *Flag, PressureOperatorMpi &pressureOperator, MultigridDataMpi &multigridData) {
+    // The coarse levels are never larger than the fine level, so the buffers of the fine level suffice.
+    const int maxBufferSize = std::max(
+            std::max((iu - il + 3) * (ju - jl + 3), (iu - il + 3) * (ku - kl + 3)),
+            (ju - jl + 3) * (ku - kl + 3));
+    multigridData.bufSend.resize(maxBufferSize);
+    multigridData.bufRecv.resize(maxBufferSize);
+
+    MultigridLevelMpi fineLevel;
+    fineLevel.imax = imax;
+    fineLevel.jmax = jmax;
+    fineLevel.kmax = kmax;
+    fineLevel.il = il;
+    fineLevel.iu = iu;
+    fineLevel.jl = jl;
+    fineLevel.ju = ju;
+    fineLevel.kl = kl;
+    fineLevel.ku = ku;
+    fineLevel.ci = fineLevel.cj = fineLevel.ck = 1;
+    fineLevel.dx = dx;
+    fineLevel.dy = dy;
+    fineLevel.dz = dz;
+    fineLevel.P = P;
+    fineLevel.RS = RS;
+    fineLevel.Flag = Flag;
+    fineLevel.pressureOperator = pressureOperator;
+    fineLevel.R = new Real[getLevelSizeP(fineLevel)];
+    memset(fineLevel.R, 0, sizeof(Real)*getLevelSizeP(fineLevel));
+    multigridData.levels.push_back(fineLevel);
+
+    while (true) {
+        const MultigridLevelMpi fine = multigridData.levels.back();
+        const Real hMin = std::min(std::min(fine.dx, fine.dy), fine.dz);
+
+        // All processes need to take the same decisions, so the minimum subdomain size over all processes is used.
+        int localSizes[4] = {
+                fine.iu - fine.il + 1, fine.ju - fine.jl + 1, fine.ku - fine.kl + 1, getLevelSizeRS(fine) };
+        MPI_Allreduce(MPI_IN_PLACE, localSizes, 4, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (localSizes[3] < MULTIGRID_AGGLOMERATION_MIN_LOCAL_CELLS) {
+            break;
+        }
+
+        // Same coarsening rules as for the serial multigrid solver. Additionally, every process needs to keep at least
+        // one cell in each direction.
+        MultigridLevelMpi coarse;
+        coarse.ci = fine.imax % 2 == 0 && fine.imax >= 4 && fine.dx < 2*hMin && localSizes[0] >= 2 ? 2 : 1;
+        coarse.cj = fine.jmax % 2 == 0 && fine.jmax >= 4 && fine.dy < 2*hMin && localSizes[1] >= 2 ? 2 : 1;
+        coarse.ck = fine.kmax % 2 == 0 && fine.kmax >= 4 && fine.dz < 2*hMin && localSizes[2] >= 2 ? 2 : 1;
+        if (coarse.ci == 1 && coarse.cj == 1 && coarse.ck == 1) {
+            break;
+        }
+
+        coarse.imax = fine.imax / coarse.ci;
+        coarse.jmax = fine.jmax / coarse.cj;
+        coarse.kmax = fine.kmax / coarse.ck;
+        coarse.dx = fine.dx * Real(coarse.ci);
+        coarse.dy = fine.dy * Real(coarse.cj);
+        coarse.dz = fine.dz * Real(coarse.ck);
+
+        // The process owns all coarse cells whose first child 2I-1 lies in its index range.
+        coarse.il = coarse.ci == 1 ? fine.il : (fine.il + 2) / 2;
+        coarse.iu = coarse.ci == 1 ? fine.iu : (fine.iu + 1) / 2;
+        coarse.jl = coarse.cj == 1 ? fine.jl : (fine.jl + 2) / 2;
+        coarse.ju = coarse.cj == 1 ? fine.ju : (fine.ju + 1) / 2;
+        coarse.kl = coarse.ck == 1 ? fine.kl : (fine.kl + 2) / 2;
+        coarse.ku = coarse.ck == 1 ? fine.ku : (fine.ku + 1) / 2;
+
+        const int sizeP = getLevelSizeP(coarse);
+        const int sizeRS = getLevelSizeRS(coarse);
+        coarse.P = new Real[sizeP];
+        coarse.RS = new Real[sizeRS];
+        coarse.R = new Real[sizeP];
+        coarse.Flag = new FlagType[sizeP];
+        memset(coarse.P, 0, sizeof(Real)*sizeP);
+        memset(coarse.RS, 0, sizeof(Real)*sizeRS);
+        memset(coarse.R, 0, sizeof(Real)*sizeP);
+
+        coarsenMultigridFlagMpi(fine, coarse, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+        createPressureOperatorMpi(
+                coarse.dx, coarse.dy, coarse.dz, coarse.imax, coarse.jmax, coarse.kmax,
+                coarse.il, coarse.iu, coarse.jl, coarse.ju, coarse.kl, coarse.ku, coarse.Flag,
+                coarse.pressureOperator);
+        multigridData.levels.push_back(coarse);
+    }
+
+    createAgglomeratedLevelMpi(multigridData);
+}
+
+void destroyMultigridDataMpi(MultigridDataMpi &multigridData) {
+    for (size_t l = 0; l < multigridData.levels.size(); l++) {
+        MultigridLevelMpi &level = multigridData.levels.at(l);
+        if (l != 0) {
+            delete[] level.P;
+            delete[] level.RS;
+            delete[] level.Flag;
+            destroyPressureOperatorMpi(level.pressureOperator);
+        }
+        delete[] level.R;
+    }
+    multigridData.levels.clear();
+
+    destroyMultigridHierarchyCpp(multigridData.agglomeratedLevels);
+    delete[] multigridData.P_global;
+    delete[] multigridData.P_temp_global;
+    delete[] multigridData.RS_global;
+    delete[] multigridData.R_global;
+    delete[] multigridData.Flag_global;
+    multigridData = MultigridDataMpi();
+}
+
+void smoothMultigridLevelMpi(
+        MultigridLevelMpi &level, int numSweeps,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, MultigridDataMpi &multigridData) {
+    // Red-black Gauss-Seidel. The boundary conditions are part of the operator, and the halo cells are exchanged
+    // after each sweep. The smoother needs no second buffer.
+    Real *P_temp = nullptr;
+    Real residual = Real(0.0);
+    for (int sweep = 0; sweep < numSweeps; sweep++) {
+        sorSolverIterationMpi(
+                Real(1.0), LINEAR_SOLVER_GAUSS_SEIDEL_RED_BLACK,
+                level.il, level.iu, level.jl, level.ju, level.kl, level.ku,
+                rankL, rankR, rankD, rankU, rankB, rankF, multigridData.bufSend.data(), multigridData.bufRecv.data(),
+                level.P, P_temp, level.RS, level.pressureOperator, false, residual);
+    }
+}
+
+/**
+ * Computes the residual R = RS - A P of the level and returns the local sum of its squares. The halo cells of P need
+ * to be up to date.
+ */
+Real computeResidualMultigridMpi(MultigridLevelMpi &level) {
+    const Real *coeffR = level.pressureOperator.coeffR;
+    const Real *coeffU = level.pressureOperator.coeffU;
+    const Real *coeffF = level.pressureOperator.coeffF;
+    const Real *P = level.P;
+    Real residualLocal = Real(0.0);
+
+    // Non-fluid cells have no neighbor coefficients and a zero right-hand side, so their residual is zero.
+    for (int i = level.il; i <= level.iu; i++) {
+        for (int j = level.jl; j <= level.ju; j++) {
+            for (int k = level.kl; k <= level.ku; k++) {
+                const Real cR = coeffR[IDXP_LEVEL(level,i,j,k)], cL = coeffR[IDXP_LEVEL(level,i-1,j,k)];
+                const Real cU = coeffU[IDXP_LEVEL(level,i,j,k)], cD = coeffU[IDXP_LEVEL(level,i,j-1,k)];
+                const Real cF = coeffF[IDXP_LEVEL(level,i,j,k)], cB = coeffF[IDXP_LEVEL(level,i,j,k-1)];
+                const Real r = level.RS[IDXRS_LEVEL(level,i,j,k)]
+                        - cR*P[IDXP_LEVEL(level,i+1,j,k)] - cL*P[IDXP_LEVEL(level,i-1,j,k)]
+                        - cU*P[IDXP_LEVEL(level,i,j+1,k)] - cD*P[IDXP_LEVEL(level,i,j-1,k)]
+                        - cF*P[IDXP_LEVEL(level,i,j,k+1)] - cB*P[IDXP_LEVEL(level,i,j,k-1)]
+                        + (cR + cL + cU + cD + cF + cB)*P[IDXP_LEVEL(level,i,j,k)];
+                level.R[IDXP_LEVEL(level,i,j,k)] = r;
+                residualLocal += r*r;
+            }
+        }
+    }
+    return residualLocal;
+}
+
+void restrictResidualMpi(
+        MultigridLevelMpi &fine, MultigridLevelMpi &coarse,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, MultigridDataMpi &multigridData) {
+    // The second child of a coarse cell may lie in the halo (including the edges and corners).
+    exchangeMultigridLevelMpi(fine, fine.R, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+
+    // The residual of a coarse cell is the mean value over the volume of all of its children.
+    const Real normalizationFactor = Real(1.0) / Real(coarse.ci * coarse.cj * coarse.ck);
+    for (int i = coarse.il; i <= coarse.iu; i++) {
+        for (int j = coarse.jl; j <= coarse.ju; j++) {
+            for (int k = coarse.kl; k <= coarse.ku; k++) {
+                Real residualSum = Real(0.0);
+                for (int fi = (i-1)*coarse.ci+1; fi <= i*coarse.ci; fi++) {
+                    for (int fj = (j-1)*coarse.cj+1; fj <= j*coarse.cj; fj++) {
+                        for (int fk = (k-1)*coarse.ck+1; fk <= k*coarse.ck; fk++) {
+                            residualSum += fine.R[IDXP_LEVEL(fine,fi,fj,fk)];
+                        }
+                    }
+                }
+                coarse.RS[IDXRS_LEVEL(coarse,i,j,k)] = residualSum * normalizationFactor;
+            }
+        }
+    }
+
+    // The coarse grid correction starts with an initial guess of zero.
+    memset(coarse.P, 0, sizeof(Real)*getLevelSizeP(coarse));
+}
+
+void prolongateCorrectionMpi(
+        MultigridLevelMpi &coarse, MultigridLevelMpi &fine,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, MultigridDataMpi &multigridData) {
+    // The parent of a fine cell and the neighbors of the parent may lie in the halo (including the edges and corners).
+    exchangeMultigridLevelMpi(coarse, coarse.P, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+
+    // Trilinear interpolation of the correction restricted to the fluid cells (@see prolongateCorrectionCpp).
+    for (int i = fine.il; i <= fine.iu; i++) {
+        for (int j = fine.jl; j <= fine.ju; j++) {
+            for (int k = fine.kl; k <= fine.ku; k++) {
+                if (!isFluid(fine.Flag[IDXFLAG_LEVEL(fine,i,j,k)])) {
+                    continue;
+                }
+
+                const int ic = (i + coarse.ci - 1) / coarse.ci;
+                const int jc = (j + coarse.cj - 1) / coarse.cj;
+                const int kc = (k + coarse.ck - 1) / coarse.ck;
+                const int si = coarse.ci == 1 ? 0 : (i % 2 == 1 ? -1 : 1);
+                const int sj = coarse.cj == 1 ? 0 : (j % 2 == 1 ? -1 : 1);
+                const int sk = coarse.ck == 1 ? 0 : (k % 2 == 1 ? -1 : 1);
+
+                Real correction = Real(0.0);
+                Real weightSum = Real(0.0);
+                for (int a = 0; a <= std::abs(si); a++) {
+                    for (int b = 0; b <= std::abs(sj); b++) {
+                        for (int c = 0; c <= std::abs(sk); c++) {
+                            const int in = ic + a*si, jn = jc + b*sj, kn = kc + c*sk;
+                            if (in < 1 || jn < 1 || kn < 1 || in > coarse.imax || jn > coarse.jmax || kn > coarse.kmax
+                                    || !isFluid(coarse.Flag[IDXFLAG_LEVEL(coarse,in,jn,kn)])) {
+                                continue;
+                            }
+                            const Real weight = (si == 0 ? Real(1.0) : (a == 0 ? Real(0.75) : Real(0.25)))
+                                    * (sj == 0 ? Real(1.0) : (b == 0 ? Real(0.75) : Real(0.25)))
+                                    * (sk == 0 ? Real(1.0) : (c == 0 ? Real(0.75) : Real(0.25)));
+                            correction += weight * coarse.P[IDXP_LEVEL(coarse,in,jn,kn)];
+                            weightSum += weight;
+                        }
+                    }
+                }
+
+                // The parent cell is always a fluid cell, thus weightSum > 0.
+                fine.P[IDXP_LEVEL(fine,i,j,k)] += correction / weightSum;
+            }
+        }
+    }
+
+    // The smoother needs the updated values in the halo cells.
+    exchangeMultigridLevelMpi(fine, fine.P, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+}
+
+/**
+ * Gathers the residual of the agglomerated level on all processes, solves for the correction redundantly with the
+ * serial multigrid solver and adds the correction to the local part (including the halo cells) of the level.
+ */
+void solveAgglomeratedLevelMpi(MultigridDataMpi &multigridData) {
+    MultigridLevelMpi &level = multigridData.levels.back();
+    const int imax = level.imax, jmax = level.jmax, kmax = level.kmax;
+
+    // In W-cycles, P already contains the correction of the previous visit.
+    computeResidualMultigridMpi(level);
+    mpiAllgatherCellData(
+            level.R, level.il, level.iu, level.jl, level.ju, level.kl, level.ku, jmax, kmax,
+            multigridData.agglomerationRanges, multigridData.R_global);
+    for (int i = 1; i <= imax; i++) {
+        for (int j = 1; j <= jmax; j++) {
+            for (int k = 1; k <= kmax; k++) {
+                multigridData.RS_global[IDXRS_NORMAL(i,j,k)] = multigridData.R_global[IDXP_NORMAL(i,j,k)];
+            }
+        }
+    }
+
+    // All processes compute the same correction, so no communication is needed for scattering it.
+    memset(multigridData.P_global, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2));
+    Real residual = Real(1e9);
+    int it = 0;
+    multigridSolverCpp(
+            Real(0.0), NUM_AGGLOMERATED_LEVEL_CYCLES, false, multigridData.agglomeratedLevels, residual, it);
+
+    for (int i = std::max(level.il-1, 1); i <= std::min(level.iu+1, imax); i++) {
+        for (int j = std::max(level.jl-1, 1); j <= std::min(level.ju+1, jmax); j++) {
+            for (int k = std::max(level.kl-1, 1); k <= std::min(level.ku+1, kmax); k++) {
+                level.P[IDXP_LEVEL(level,i,j,k)] += multigridData.P_global[IDXP_NORMAL(i,j,k)];
+            }
+        }
+    }
+}
+
+void multigridCycleMpi(
+        size_t l, int gamma,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, MultigridDataMpi &multigridData) {
+    if (l == multigridData.levels.size() - 1) {
+        solveAgglomeratedLevelMpi(multigridData);
+        return;
+    }
+
+    MultigridLevelMpi &level = multigridData.levels.at(l);
+    MultigridLevelMpi &coarseLevel = multigridData.levels.at(l + 1);
+    smoothMultigridLevelMpi(
+            level, NUM_PRE_SMOOTHING_SWEEPS, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+    computeResidualMultigridMpi(level);
+    restrictResidualMpi(level, coarseLevel, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+
+    // gamma = 1: V-cycle, gamma = 2: W-cycle.
+    for (int i = 0; i < gamma; i++) {
+        multigridCycleMpi(l + 1, gamma, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+    }
+
+    prolongateCorrectionMpi(coarseLevel, level, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+    smoothMultigridLevelMpi(
+            level, NUM_POST_SMOOTHING_SWEEPS, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+}
+
+void multigridSolverMpi(
+        Real eps, int itermax, bool useWCycle,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
+        MultigridDataMpi &multigridData, Real &residual, int &it) {
+    MultigridLevelMpi &fineLevel = multigridData.levels.front();
+    const int numFluidCells = fineLevel.pressureOperator.numFluidCells;
+    if (numFluidCells == 0) {
+        residual = Real(0.0);
+        return;
+    }
+
+    // The right-hand side needs to be compatible with the Neumann boundary conditions, i.e., its global mean over the
+    // fluid cells needs to be zero.
+    Real sumRs = Real(0.0);
+    for (int i = fineLevel.il; i <= fineLevel.iu; i++) {
+        for (int j = fineLevel.jl; j <= fineLevel.ju; j++) {
+            for (int k = fineLevel.kl; k <= fineLevel.ku; k++) {
+                sumRs += fineLevel.RS[IDXRS_LEVEL(fineLevel,i,j,k)];
+            }
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &sumRs, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
+    const Real meanRs = sumRs / Real(numFluidCells);
+    for (int i = fineLevel.il; i <= fineLevel.iu; i++) {
+        for (int j = fineLevel.jl; j <= fineLevel.ju; j++) {
+            for (int k = fineLevel.kl; k <= fineLevel.ku; k++) {
+                if (isFluid(fineLevel.Flag[IDXFLAG_LEVEL(fineLevel,i,j,k)])) {
+                    fineLevel.RS[IDXRS_LEVEL(fineLevel,i,j,k)] -= meanRs;
+                }
+            }
+        }
+    }
+
+    exchangeMultigridLevelMpi(fineLevel, fineLevel.P, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+
+    const int gamma = useWCycle ? 2 : 1;
+    while (it < itermax && residual > eps) {
+        multigridCycleMpi(0, gamma, rankL, rankR, rankD, rankU, rankB, rankF, multigridData);
+        Real residualLocal = computeResidualMultigridMpi(fineLevel);
+        MPI_Allreduce(MPI_IN_PLACE, &residualLocal, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
+        residual = std::sqrt(residualLocal / Real(numFluidCells));
+        it++;
+    }
+}
+
+}
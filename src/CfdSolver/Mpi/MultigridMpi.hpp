@@ -0,0 +1,104 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_MULTIGRIDMPI_HPP
+#define CFD3D_MULTIGRIDMPI_HPP
+
+#include <vector>
+#include "Defines.hpp"
+#include "PressureOperatorMpi.hpp"
+#include "CfdSolver/Cpp/MultigridCpp.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * One distributed level of the MPI multigrid hierarchy. The levels are coarsened with the global indices, i.e., the
+ * coarse cell I consists of the fine cells 2I-1 and 2I. A coarse cell belongs to the process owning its first child.
+ * Thus, any domain decomposition can be coarsened, and the second child may lie in the halo of the fine level.
+ * On the coarse levels, P stores the correction of the pressure and RS the restricted residual of the finer level.
+ */
+struct MultigridLevelMpi {
+    // Global size of the level and index range of the process.
+    int imax, jmax, kmax;
+    int il, iu, jl, ju, kl, ku;
+    // Coarsening factor (1 or 2) in x, y and z direction with respect to the next finer level.
+    int ci, cj, ck;
+    Real dx, dy, dz;
+    // Arrays of the level (P, R and Flag including the halo cells). For level 0, P, RS, Flag and the pressure operator
+    // belong to the solver and are not freed.
+    Real *P, *RS, *R;
+    FlagType *Flag;
+    PressureOperatorMpi pressureOperator;
+};
+
+/**
+ * The MPI multigrid hierarchy. The distributed levels are coarsened until the subdomain of one process gets too small.
+ * The coarsest distributed level is then agglomerated, i.e., its residual is gathered on all processes, and all
+ * processes solve it redundantly with the serial multigrid solver (@see MultigridCpp.hpp).
+ */
+struct MultigridDataMpi {
+    std::vector<MultigridLevelMpi> levels;
+    // Buffers for the halo exchanges including the edge and corner cells (@see mpiExchangeCellDataWithCorners).
+    std::vector<Real> bufSend, bufRecv;
+    // The index ranges il, iu, jl, ju, kl, ku of all processes on the agglomerated level.
+    std::vector<int> agglomerationRanges;
+    // Global arrays of the agglomerated level (layout of the non-MPI solvers). R_global receives the gathered residual.
+    Real *P_global = nullptr, *P_temp_global = nullptr, *RS_global = nullptr, *R_global = nullptr;
+    FlagType *Flag_global = nullptr;
+    std::vector<MultigridLevelCpp> agglomeratedLevels;
+};
+
+/**
+ * Creates the MPI multigrid hierarchy for the local subdomain. Needs to be called by all processes.
+ * @param pressureOperator The pressure operator of the fine grid (used for level 0).
+ */
+void createMultigridDataMpi(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax, int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
+        Real *P, Real *RS, FlagType *Flag, PressureOperatorMpi &pressureOperator, MultigridDataMpi &multigridData);
+
+/**
+ * Frees the memory allocated by createMultigridDataMpi.
+ */
+void destroyMultigridDataMpi(MultigridDataMpi &multigridData);
+
+/**
+ * Solves the PPE using distributed geometric multigrid cycles. Red-black Gauss-Seidel sweeps are used as the smoother,
+ * which makes the result independent of the domain decomposition. RS needs to be zero in all non-fluid cells.
+ * @param useWCycle Whether to use W-cycles (true) or V-cycles (false).
+ * @param residual The residual after the last cycle.
+ * @param it The number of cycles performed.
+ */
+void multigridSolverMpi(
+        Real eps, int itermax, bool useWCycle,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF,
+        MultigridDataMpi &multigridData, Real &residual, int &it);
+
+}
+
+#endif //CFD3D_MULTIGRIDMPI_HPP
@@ -0,0 +1,173 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "MpiHelpers.hpp"
+#include "../Cpp/PressureHistoryCpp.hpp"
+#include "PressureHistoryMpi.hpp"
+#include "DefinesMpi.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createPressureHistoryMpi(
+        int maxSize, int il, int iu, int jl, int ju, int kl, int ku, PressureHistoryMpi &pressureHistory) {
+    const int sizeP = (iu - il + 3)*(ju - jl + 3)*(ku - kl + 3);
+    const int sizeRs = (iu - il + 1)*(ju - jl + 1)*(ku - kl + 1);
+    pressureHistory.maxSize = maxSize;
+    pressureHistory.numStored = 0;
+    pressureHistory.nextSlot = 0;
+    pressureHistory.gramMatrix.resize(maxSize*maxSize, 0.0);
+    for (int slot = 0; slot < maxSize; slot++) {
+        Real *solution = new Real[sizeP];
+        Real *operatorSolution = new Real[sizeRs];
+        memset(solution, 0, sizeof(Real)*sizeP);
+        memset(operatorSolution, 0, sizeof(Real)*sizeRs);
+        pressureHistory.solutions.push_back(solution);
+        pressureHistory.operatorSolutions.push_back(operatorSolution);
+    }
+}
+
+void destroyPressureHistoryMpi(PressureHistoryMpi &pressureHistory) {
+    for (Real *solution : pressureHistory.solutions) {
+        delete[] solution;
+    }
+    for (Real *operatorSolution : pressureHistory.operatorSolutions) {
+        delete[] operatorSolution;
+    }
+    pressureHistory = PressureHistoryMpi();
+}
+
+/**
+ * Computes the dot product of two arrays with the size of the local RS array (in double precision). The result is
+ * only the contribution of the local subdomain.
+ */
+double dotProductRsMpi(int il, int iu, int jl, int ju, int kl, int ku, const Real *A, const Real *B) {
+    double dotProduct = 0.0;
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                dotProduct += double(A[IDXRS(i,j,k)]) * double(B[IDXRS(i,j,k)]);
+            }
+        }
+    }
+    return dotProduct;
+}
+
+void computePressureInitialGuessMpi(
+        int il, int iu, int jl, int ju, int kl, int ku, Real *P, Real *RS, PressureHistoryMpi &pressureHistory) {
+    const int n = pressureHistory.numStored;
+    const int maxSize = pressureHistory.maxSize;
+    if (n == 0) {
+        return;
+    }
+
+    // The newest solution comes first, such that it is never dropped as linearly dependent.
+    std::vector<int> slots(n);
+    std::vector<double> bLocal(n), b(n), c;
+    for (int l = 0; l < n; l++) {
+        slots[l] = (pressureHistory.nextSlot - 1 - l + maxSize) % maxSize;
+        // A x_i is zero in all non-fluid cells, so RS doesn't need to be masked.
+        bLocal[l] = dotProductRsMpi(il, iu, jl, ju, kl, ku, pressureHistory.operatorSolutions[slots[l]], RS);
+    }
+    MPI_Allreduce(bLocal.data(), b.data(), n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    if (!solvePressureHistoryNormalEquations(maxSize, pressureHistory.gramMatrix, slots, b, c)) {
+        // All stored solutions are zero.
+        return;
+    }
+
+    // The boundary and halo values of the stored solutions are combined as well.
+    std::vector<Real> coefficients(n);
+    for (int a = 0; a < n; a++) {
+        coefficients[a] = Real(c[a]);
+    }
+    for (int i = il-1; i <= iu+1; i++) {
+        for (int j = jl-1; j <= ju+1; j++) {
+            for (int k = kl-1; k <= ku+1; k++) {
+                Real value = Real(0.0);
+                for (int a = 0; a < n; a++) {
+                    value += coefficients[a] * pressureHistory.solutions[slots[a]][IDXP(i,j,k)];
+                }
+                P[IDXP(i,j,k)] = value;
+            }
+        }
+    }
+}
+
+void addPressureSolutionMpi(
+        int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        Real *P, PressureOperatorMpi &pressureOperator, PressureHistoryMpi &pressureHistory) {
+    const int maxSize = pressureHistory.maxSize;
+    const int slot = pressureHistory.nextSlot;
+    Real *solution = pressureHistory.solutions[slot];
+    Real *operatorSolution = pressureHistory.operatorSolutions[slot];
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+
+    MPI_Status status;
+    mpiExchangeCellData(P, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, &status);
+    memcpy(solution, P, sizeof(Real)*(iu - il + 3)*(ju - jl + 3)*(ku - kl + 3));
+
+    // The coefficients of the operator are zero for all faces not coupling two fluid cells, so A x is zero in all
+    // non-fluid cells.
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+                const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+                const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+                operatorSolution[IDXRS(i,j,k)] =
+                        cR*(P[IDXP(i+1,j,k)] - P[IDXP(i,j,k)]) + cL*(P[IDXP(i-1,j,k)] - P[IDXP(i,j,k)])
+                        + cU*(P[IDXP(i,j+1,k)] - P[IDXP(i,j,k)]) + cD*(P[IDXP(i,j-1,k)] - P[IDXP(i,j,k)])
+                        + cF*(P[IDXP(i,j,k+1)] - P[IDXP(i,j,k)]) + cB*(P[IDXP(i,j,k-1)] - P[IDXP(i,j,k)]);
+            }
+        }
+    }
+
+    pressureHistory.numStored = std::min(pressureHistory.numStored + 1, maxSize);
+    pressureHistory.nextSlot = (slot + 1) % maxSize;
+
+    // Update the row and column of the Gram matrix belonging to the new solution (in one reduction).
+    const int n = pressureHistory.numStored;
+    std::vector<double> dotProductsLocal(n), dotProducts(n);
+    for (int l = 0; l < n; l++) {
+        int otherSlot = (slot - l + maxSize) % maxSize;
+        dotProductsLocal[l] = dotProductRsMpi(
+                il, iu, jl, ju, kl, ku, operatorSolution, pressureHistory.operatorSolutions[otherSlot]);
+    }
+    MPI_Allreduce(dotProductsLocal.data(), dotProducts.data(), n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    for (int l = 0; l < n; l++) {
+        int otherSlot = (slot - l + maxSize) % maxSize;
+        pressureHistory.gramMatrix[slot*maxSize + otherSlot] = dotProducts[l];
+        pressureHistory.gramMatrix[otherSlot*maxSize + slot] = dotProducts[l];
+    }
+}
+
+}
@@ -0,0 +1,83 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_PRESSUREHISTORYMPI_HPP
+#define CFD3D_PRESSUREHISTORYMPI_HPP
+
+#include <vector>
+#include "Defines.hpp"
+#include "PressureOperatorMpi.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The pressure solutions of the last time steps of the local subdomain (@see PressureHistoryCpp). The Gram matrix and
+ * the dot products with the right-hand side are reduced over all processes, so all processes use the same coefficients.
+ */
+struct PressureHistoryMpi {
+    // The maximum number of stored solutions (0 disables the projection).
+    int maxSize = 0;
+    // Ring buffer of the stored solutions (local pressure array size including the halo cells) and of A applied to the
+    // solutions (local RS array size).
+    std::vector<Real*> solutions, operatorSolutions;
+    // Number of stored solutions and index of the slot the next solution is stored in.
+    int numStored = 0, nextSlot = 0;
+    // Global Gram matrix (A x_i) * (A x_j) of the stored solutions (maxSize x maxSize, row-major).
+    std::vector<double> gramMatrix;
+};
+
+/**
+ * Allocates the memory for storing up to maxSize pressure solutions of the local subdomain.
+ */
+void createPressureHistoryMpi(
+        int maxSize, int il, int iu, int jl, int ju, int kl, int ku, PressureHistoryMpi &pressureHistory);
+
+/**
+ * Frees the memory allocated by createPressureHistoryMpi.
+ */
+void destroyPressureHistoryMpi(PressureHistoryMpi &pressureHistory);
+
+/**
+ * Overwrites P with the least-squares initial guess for the right-hand side RS. If no solution is stored yet, P is not
+ * changed.
+ */
+void computePressureInitialGuessMpi(
+        int il, int iu, int jl, int ju, int kl, int ku, Real *P, Real *RS, PressureHistoryMpi &pressureHistory);
+
+/**
+ * Adds the solution P (including its boundary values) to the history. If the history is full, the oldest solution is
+ * replaced. The halo cells of P are exchanged before the operator is applied to the solution.
+ */
+void addPressureSolutionMpi(
+        int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        Real *P, PressureOperatorMpi &pressureOperator, PressureHistoryMpi &pressureHistory);
+
+}
+
+#endif //CFD3D_PRESSUREHISTORYMPI_HPP
@@ -0,0 +1,104 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "MpiHelpers.hpp"
+#include "../Flag.hpp"
+#include "PressureOperatorMpi.hpp"
+#include "DefinesMpi.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+void createPressureOperatorMpi(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        int il, int iu, int jl, int ju, int kl, int ku, FlagType *Flag,
+        PressureOperatorMpi &pressureOperator) {
+    const int size = (iu - il + 3)*(ju - jl + 3)*(ku - kl + 3);
+    pressureOperator.coeffR = new Real[size];
+    pressureOperator.coeffU = new Real[size];
+    pressureOperator.coeffF = new Real[size];
+    pressureOperator.diagonalInverse = new Real[size];
+    memset(pressureOperator.coeffR, 0, sizeof(Real)*size);
+    memset(pressureOperator.coeffU, 0, sizeof(Real)*size);
+    memset(pressureOperator.coeffF, 0, sizeof(Real)*size);
+    memset(pressureOperator.diagonalInverse, 0, sizeof(Real)*size);
+
+    Real *coeffR = pressureOperator.coeffR;
+    Real *coeffU = pressureOperator.coeffU;
+    Real *coeffF = pressureOperator.coeffF;
+    Real *diagonalInverse = pressureOperator.diagonalInverse;
+
+    // The faces to the halo cells are included. A face only couples two cells if both of them are fluid cells inside of
+    // the global domain.
+    for (int i = std::max(il-1, 1); i <= iu; i++) {
+        for (int j = std::max(jl-1, 1); j <= ju; j++) {
+            for (int k = std::max(kl-1, 1); k <= ku; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    if (i < imax && isFluid(Flag[IDXFLAG(i+1,j,k)])) {
+                        coeffR[IDXP(i,j,k)] = Real(1.0) / (dx*dx);
+                    }
+                    if (j < jmax && isFluid(Flag[IDXFLAG(i,j+1,k)])) {
+                        coeffU[IDXP(i,j,k)] = Real(1.0) / (dy*dy);
+                    }
+                    if (k < kmax && isFluid(Flag[IDXFLAG(i,j,k+1)])) {
+                        coeffF[IDXP(i,j,k)] = Real(1.0) / (dz*dz);
+                    }
+                }
+            }
+        }
+    }
+
+    int numFluidCells = 0;
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                Real diagonal =
+                        coeffR[IDXP(i,j,k)] + coeffR[IDXP(i-1,j,k)]
+                        + coeffU[IDXP(i,j,k)] + coeffU[IDXP(i,j-1,k)]
+                        + coeffF[IDXP(i,j,k)] + coeffF[IDXP(i,j,k-1)];
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    diagonalInverse[IDXP(i,j,k)] = diagonal > Real(0.0) ? Real(1.0) / diagonal : Real(0.0);
+                    numFluidCells++;
+                }
+            }
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &numFluidCells, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    pressureOperator.numFluidCells = numFluidCells;
+}
+
+void destroyPressureOperatorMpi(PressureOperatorMpi &pressureOperator) {
+    delete[] pressureOperator.coeffR;
+    delete[] pressureOperator.coeffU;
+    delete[] pressureOperator.coeffF;
+    delete[] pressureOperator.diagonalInverse;
+    pressureOperator = PressureOperatorMpi();
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_PRESSUREOPERATORMPI_HPP
+#define CFD3D_PRESSUREOPERATORMPI_HPP
+
+#include "Defines.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * The discrete Laplace operator of the PPE with the Neumann boundary conditions folded into per-cell coefficients
+ * (@see PressureOperatorCpp). The arrays have the size of the local pressure array including the halo cells.
+ */
+struct PressureOperatorMpi {
+    // Coefficients of the neighbors (i+1,j,k), (i,j+1,k) and (i,j,k+1).
+    Real *coeffR = nullptr, *coeffU = nullptr, *coeffF = nullptr;
+    // Inverse of the diagonal entry. Zero for all non-fluid cells.
+    Real *diagonalInverse = nullptr;
+    // The number of fluid cells in the whole domain (i.e., of all processes).
+    int numFluidCells = 0;
+};
+
+/**
+ * Allocates the arrays of the pressure operator and computes the coefficients from the local Flag array (including the
+ * halo cells).
+ */
+void createPressureOperatorMpi(
+        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        int il, int iu, int jl, int ju, int kl, int ku, FlagType *Flag,
+        PressureOperatorMpi &pressureOperator);
+
+/**
+ * Frees the memory allocated by createPressureOperatorMpi.
+ */
+void destroyPressureOperatorMpi(PressureOperatorMpi &pressureOperator);
+
+}
+
+#endif //CFD3D_PRESSUREOPERATORMPI_HPP
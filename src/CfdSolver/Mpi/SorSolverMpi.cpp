@@ -29,16 +29,23 @@
 #include <iostream>
 #include <cmath>
 #include <cstring>
+#include <utility>
 #include "../Flag.hpp"
 #include "MpiHelpers.hpp"
 #include "SorSolverMpi.hpp"
+#include "PressureOperatorMpi.hpp"
+#include "ChebyshevMpi.hpp"
+#include "MultigridMpi.hpp"
 #include "DefinesMpi.hpp"
 
-void sorSolverIterationMpi(
-        Real omg, Real dx, Real dy, Real dz, Real coeff, LinearSystemSolverType linearSystemSolverType,
-        int imax, int jmax, int kmax, int il, int iu, int jl, int ju, int kl, int ku,
-        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag, Real &residual) {
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Sets the pressure values in the ghost cells at the domain boundary and in obstacle cells next to fluid cells, such
+ * that the homogeneous Neumann boundary condition dp/dn = 0 holds.
+ */
+void setPressureBoundaryValuesMpi(
+        int imax, int jmax, int kmax, int il, int iu, int jl, int ju, int kl, int ku, Real *P, FlagType *Flag) {
     // Set the boundary values for the pressure on the x-y-planes.
     if (kl == 1) {
         for (int i = il; i <= iu; i++) {
@@ -134,85 +141,130 @@ void sorSolverIterationMpi(
             }     
         }
     }
+}
 
+/**
+ * Returns the residual of cell (i,j,k) using the precomputed operator, where the neighbor values are read from
+ * P_neighbor and the value of the cell itself from P_center.
+ */
+inline Real computeCellResidualMpi(
+        int i, int j, int k, int il, int jl, int ju, int kl, int ku,
+        const Real *P_neighbor, const Real *P_center, const Real *RS,
+        const Real *coeffR, const Real *coeffU, const Real *coeffF) {
+    const Real cR = coeffR[IDXP(i,j,k)], cL = coeffR[IDXP(i-1,j,k)];
+    const Real cU = coeffU[IDXP(i,j,k)], cD = coeffU[IDXP(i,j-1,k)];
+    const Real cF = coeffF[IDXP(i,j,k)], cB = coeffF[IDXP(i,j,k-1)];
+    return cR*P_neighbor[IDXP(i+1,j,k)] + cL*P_neighbor[IDXP(i-1,j,k)]
+            + cU*P_neighbor[IDXP(i,j+1,k)] + cD*P_neighbor[IDXP(i,j-1,k)]
+            + cF*P_neighbor[IDXP(i,j,k+1)] + cB*P_neighbor[IDXP(i,j,k-1)]
+            - RS[IDXRS(i,j,k)] - (cR + cL + cU + cD + cF + cB)*P_center[IDXP(i,j,k)];
+}
 
-    if (linearSystemSolverType == LINEAR_SOLVER_JACOBI) {
-        for (int i = il-1; i <= iu+1; i++) {
-            for (int j = jl-1; j <= ju+1; j++) {
-                for (int k = kl-1; k <= ku+1; k++) {
-                    P_temp[IDXP(i, j, k)] = P[IDXP(i, j, k)];
-                }
-            }
-        }
-    }
+void sorSolverIterationMpi(
+        Real omg, LinearSystemSolverType linearSystemSolverType,
+        int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        Real *&P, Real *&P_temp, Real *RS, PressureOperatorMpi &pressureOperator, bool checkResidual, Real &residual) {
+    const Real *coeffR = pressureOperator.coeffR;
+    const Real *coeffU = pressureOperator.coeffU;
+    const Real *coeffF = pressureOperator.coeffF;
+    const Real *diagonalInverse = pressureOperator.diagonalInverse;
 
+    // The boundary conditions are part of the operator, so no boundary values need to be set. The residual is computed
+    // in the update sweep (for the Jacobi solver, this is the residual of the pressure values before the sweep).
+    Real residualLocal = Real(0.0);
 
     if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL) {
         for (int i = il; i <= iu; i++) {
             for (int j = jl; j <= ju; j++) {
                 for (int k = kl; k <= ku; k++) {
-                    if (isFluid(Flag[IDXFLAG(i,j,k)])){
-                        P[IDXP(i,j,k)] = (Real(1.0) - omg)*P[IDXP(i,j,k)] + coeff *
-                                ((P[IDXP(i+1,j,k)]+P[IDXP(i-1,j,k)])/(dx*dx)
-                                + (P[IDXP(i,j+1,k)]+P[IDXP(i,j-1,k)])/(dy*dy)
-                                + (P[IDXP(i,j,k+1)]+P[IDXP(i,j,k-1)])/(dz*dz)
-                                - RS[IDXRS(i,j,k)]);
+                    Real r = computeCellResidualMpi(
+                            i, j, k, il, jl, ju, kl, ku, P, P, RS, coeffR, coeffU, coeffF);
+                    residualLocal += r*r;
+                    P[IDXP(i,j,k)] += omg * diagonalInverse[IDXP(i,j,k)] * r;
+                }
+            }
+        }
+    } else if (linearSystemSolverType == LINEAR_SOLVER_SOR_RED_BLACK
+            || linearSystemSolverType == LINEAR_SOLVER_GAUSS_SEIDEL_RED_BLACK) {
+        // Red-black ordering with the color determined by the global cell index. The halo cells of the first color are
+        // exchanged before updating the second color, such that the result is independent of the domain decomposition.
+        for (int color = 0; color < 2; color++) {
+            for (int i = il; i <= iu; i++) {
+                for (int j = jl; j <= ju; j++) {
+                    for (int k = kl + (i + j + kl + color) % 2; k <= ku; k += 2) {
+                        Real r = computeCellResidualMpi(
+                                i, j, k, il, jl, ju, kl, ku, P, P, RS, coeffR, coeffU, coeffF);
+                        residualLocal += r*r;
+                        P[IDXP(i,j,k)] += omg * diagonalInverse[IDXP(i,j,k)] * r;
                     }
                 }
             }
+            if (color == 0) {
+                MPI_Status status;
+                mpiExchangeCellData(
+                        P, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv,
+                        &status);
+            }
         }
     } else if (linearSystemSolverType == LINEAR_SOLVER_JACOBI) {
+        // The new values are written to P_temp and the buffers are swapped instead of copying P (including the halo)
+        // in each iteration. All interior cells are written, so the halo exchange below completes the new buffer.
         for (int i = il; i <= iu; i++) {
             for (int j = jl; j <= ju; j++) {
                 for (int k = kl; k <= ku; k++) {
-                    if (isFluid(Flag[IDXFLAG(i,j,k)])) {
-                        P[IDXP(i,j,k)] = (Real(1.0) - omg)*P_temp[IDXP(i,j,k)] + coeff *
-                                ((P_temp[IDXP(i+1,j,k)]+P_temp[IDXP(i-1,j,k)])/(dx*dx)
-                                 + (P_temp[IDXP(i,j+1,k)]+P_temp[IDXP(i,j-1,k)])/(dy*dy)
-                                 + (P_temp[IDXP(i,j,k+1)]+P_temp[IDXP(i,j,k-1)])/(dz*dz)
-                                 - RS[IDXRS(i,j,k)]);
-                    }
+                    Real r = computeCellResidualMpi(
+                            i, j, k, il, jl, ju, kl, ku, P, P, RS, coeffR, coeffU, coeffF);
+                    residualLocal += r*r;
+                    P_temp[IDXP(i,j,k)] = P[IDXP(i,j,k)] + omg * diagonalInverse[IDXP(i,j,k)] * r;
                 }
             }
         }
+        std::swap(P, P_temp);
     }
 
-
     MPI_Status status;
     mpiExchangeCellData(P, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, &status);
 
-    // Compute the residual.
-    residual = 0;
-    int numFluidCells = 0;
+    // The residual is normalized by dividing by the total number of fluid cells.
+    if (checkResidual) {
+        MPI_Allreduce(MPI_IN_PLACE, &residualLocal, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
+        residual = pressureOperator.numFluidCells == 0 ? Real(0.0) : std::sqrt(residualLocal/pressureOperator.numFluidCells);
+    }
+}
+
+Real computeRsNormMpi(
+        int il, int iu, int jl, int ju, int kl, int ku, Real *RS, FlagType *Flag,
+        PressureOperatorMpi &pressureOperator) {
+    Real rsSum = Real(0.0);
     for (int i = il; i <= iu; i++) {
         for (int j = jl; j <= ju; j++) {
             for (int k = kl; k <= ku; k++) {
-                if (isFluid(Flag[IDXFLAG(i,j,k)])){
-                    residual += SQR(
-                               (P[IDXP(i+1,j,k)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i-1,j,k)])/(dx*dx)
-                             + (P[IDXP(i,j+1,k)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i,j-1,k)])/(dy*dy)
-                             + (P[IDXP(i,j,k+1)] - Real(2.0)*P[IDXP(i,j,k)] + P[IDXP(i,j,k-1)])/(dz*dz)
-                             - RS[IDXRS(i,j,k)]
-                    );
-                    numFluidCells++;
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    rsSum += RS[IDXRS(i,j,k)] * RS[IDXRS(i,j,k)];
                 }
             }
         }
     }
-
-    // The residual is normalized by dividing by the total number of fluid cells.
-    MPI_Allreduce(MPI_IN_PLACE, &numFluidCells, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, &residual, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
-    residual = std::sqrt(residual/numFluidCells);
+    MPI_Allreduce(MPI_IN_PLACE, &rsSum, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
+    return pressureOperator.numFluidCells == 0 ? Real(0.0) : std::sqrt(rsSum / pressureOperator.numFluidCells);
 }
 
 void sorSolverMpi(
-        int myrank, Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType,
-        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        int myrank, Real omg, Real eps, int itermax, int residualCheckInterval,
+        LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput, int imax, int jmax, int kmax,
         int il, int iu, int jl, int ju, int kl, int ku,
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag) {
-    if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL) {
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag, PressureOperatorMpi &pressureOperator,
+        ChebyshevDataMpi &chebyshevData, MultigridDataMpi &multigridData, AdaptiveOmegaData &adaptiveOmegaData) {
+    const bool isSor = linearSystemSolverType == LINEAR_SOLVER_SOR
+            || linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL
+            || linearSystemSolverType == LINEAR_SOLVER_SOR_RED_BLACK;
+    const bool estimateOmega = isSor && adaptiveOmegaData.isEnabled;
+    if (estimateOmega) {
+        // The factor estimated in the last solves (or 1, i.e., Gauss-Seidel, in the first solve).
+        omg = adaptiveOmegaData.omg;
+    } else if (isSor) {
         // Successive over-relaxation based on Gauss-Seidl. A factor of 1.2 proved to give the best results here.
         omg = 1.2;
     } else {
@@ -220,19 +272,59 @@ void sorSolverMpi(
         omg = 1.0;
     }
 
-    const Real coeff = omg / (Real(2.0) * (Real(1.0) / (dx*dx) + Real(1.0) / (dy*dy) + Real(1.0) / (dz*dz)));
     Real residual = Real(1e9);
     int it = 0;
 
-    while (it < itermax && residual > eps) {
-        sorSolverIterationMpi(
-                omg, dx, dy, dz, coeff, linearSystemSolverType,
-                imax, jmax, kmax, il, iu, jl, ju, kl, ku,
+    // Non-fluid cells have no neighbor coefficients. With a zero right-hand side, they neither change their pressure
+    // value nor contribute to the residual.
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                if (!isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    RS[IDXRS(i,j,k)] = Real(0.0);
+                }
+            }
+        }
+    }
+
+    if (linearSystemSolverType == LINEAR_SOLVER_CHEBYSHEV) {
+        chebyshevSolverMpi(
+                eps, itermax, residualCheckInterval, il, iu, jl, ju, kl, ku,
                 rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv,
-                P, P_temp, RS, Flag, residual);
-        it++;
+                P, RS, pressureOperator, chebyshevData, residual, it);
+    } else if (linearSystemSolverType == LINEAR_SOLVER_MULTIGRID
+            || linearSystemSolverType == LINEAR_SOLVER_MULTIGRID_W_CYCLE) {
+        multigridSolverMpi(
+                eps, itermax, linearSystemSolverType == LINEAR_SOLVER_MULTIGRID_W_CYCLE,
+                rankL, rankR, rankD, rankU, rankB, rankF, multigridData, residual, it);
+    } else {
+        Real residualEstimationStart = Real(0.0);
+        while (it < itermax && residual > eps) {
+            // Convergence is only checked every residualCheckInterval iterations (saves the global reduction).
+            // For estimating the over-relaxation factor, the residual is additionally needed at the start and the end
+            // of the estimation interval.
+            bool isEstimationIteration = estimateOmega
+                    && (it + 1 == ADAPTIVE_OMEGA_ESTIMATION_START || it + 1 == ADAPTIVE_OMEGA_ESTIMATION_END);
+            bool checkResidual = (it + 1) % residualCheckInterval == 0 || it + 1 == itermax || isEstimationIteration;
+            sorSolverIterationMpi(
+                    omg, linearSystemSolverType, il, iu, jl, ju, kl, ku,
+                    rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv,
+                    P, P_temp, RS, pressureOperator, checkResidual, residual);
+            it++;
+
+            if (estimateOmega && it == ADAPTIVE_OMEGA_ESTIMATION_START) {
+                residualEstimationStart = residual;
+            } else if (estimateOmega && it == ADAPTIVE_OMEGA_ESTIMATION_END) {
+                // All processes compute the same factor, as the residuals are global values.
+                updateAdaptiveOmega(residualEstimationStart, residual, adaptiveOmegaData);
+                omg = adaptiveOmegaData.omg;
+            }
+        }
     }
 
+    // The values in the ghost cells and obstacle cells are only needed for the velocity update and the output.
+    setPressureBoundaryValuesMpi(imax, jmax, kmax, il, iu, jl, ju, kl, ku, P, Flag);
+
     if (myrank == 0) {
         if (((residual > eps && it == itermax) || std::isnan(residual)) && shallWriteOutput) {
             std::cerr << "\nSOR solver reached maximum number of iterations without converging (res: "
@@ -247,3 +339,5 @@ void sorSolverMpi(
         exit(1);
     }
 }
+
+}
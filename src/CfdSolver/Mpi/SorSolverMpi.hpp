@@ -30,15 +30,55 @@
 #define CFD3D_SORSOLVERMPI_HPP
 
 #include "Defines.hpp"
+#include "PressureOperatorMpi.hpp"
+#include "ChebyshevMpi.hpp"
+#include "MultigridMpi.hpp"
+#include "CfdSolver/AdaptiveOmega.hpp"
+
+namespace CFD3D_PRECISION_NAMESPACE {
+
+/**
+ * Performs one iteration of the SOR/Gauss-Seidel (lexicographic or red-black) or Jacobi solver using the passed
+ * pressure operator and exchanges the halo cells of P afterwards. P_temp is only used by the Jacobi solver, which
+ * writes the new values to P_temp and swaps the two pointers, so P always points to the current values.
+ * @param checkResidual Whether to compute the global residual (needs a global reduction).
+ * @param residual The residual of the pressure values before the update (only set if checkResidual is true).
+ */
+void sorSolverIterationMpi(
+        Real omg, LinearSystemSolverType linearSystemSolverType,
+        int il, int iu, int jl, int ju, int kl, int ku,
+        int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
+        Real *&P, Real *&P_temp, Real *RS, PressureOperatorMpi &pressureOperator, bool checkResidual, Real &residual);
+
+/**
+ * Computes the norm of the right-hand side of the PPE normalized by the number of fluid cells in the whole domain.
+ * Needs to be called by all processes.
+ */
+Real computeRsNormMpi(
+        int il, int iu, int jl, int ju, int kl, int ku, Real *RS, FlagType *Flag,
+        PressureOperatorMpi &pressureOperator);
 
 /**
  * Uses an SOR solver to compute the updated pressure values using the pressure poisson equation (PPE).
+ * @param P The pressure values. The Jacobi solver alternates between P and P_temp, so the two pointers may be swapped
+ * after the call.
+ * @param residualCheckInterval The number of iterations after which the convergence is checked.
+ * @param pressureOperator The operator with the boundary conditions folded into the coefficients.
+ * @param chebyshevData The data of the Chebyshev solver (only used if linearSystemSolverType is
+ * LINEAR_SOLVER_CHEBYSHEV).
+ * @param multigridData The multigrid hierarchy (only used if linearSystemSolverType is LINEAR_SOLVER_MULTIGRID or
+ * LINEAR_SOLVER_MULTIGRID_W_CYCLE).
+ * @param adaptiveOmegaData The online estimate of the over-relaxation factor. If it is enabled, it is used by the SOR
+ * type solvers instead of the fixed factor and updated during the solve.
  */
 void sorSolverMpi(
-        int myrank, Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType,
-        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        int myrank, Real omg, Real eps, int itermax, int residualCheckInterval,
+        LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput, int imax, int jmax, int kmax,
         int il, int iu, int jl, int ju, int kl, int ku,
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
-        Real *P, Real *P_temp, Real *RS, FlagType *Flag);
+        Real *&P, Real *&P_temp, Real *RS, FlagType *Flag, PressureOperatorMpi &pressureOperator,
+        ChebyshevDataMpi &chebyshevData, MultigridDataMpi &multigridData, AdaptiveOmegaData &adaptiveOmegaData);
+
+}
 
 #endif //CFD3D_SORSOLVERMPI_HPP
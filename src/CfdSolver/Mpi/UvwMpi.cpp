@@ -34,6 +34,8 @@
 #include "../Flag.hpp"
 #include "DefinesMpi.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void calculateFghMpi(
         Real Re, Real GX, Real GY, Real GZ, Real alpha, Real beta,
         Real dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
@@ -357,6 +359,31 @@ void calculateUvwMpi(
     mpiExchangeUvw(U, V, W, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, &status);
 }
 
+Real computeDivergenceNormMpi(
+        Real dx, Real dy, Real dz, int il, int iu, int jl, int ju, int kl, int ku,
+        Real *U, Real *V, Real *W, FlagType *Flag) {
+    Real divergenceSum = Real(0.0);
+    int numFluidCells = 0;
+    for (int i = il; i <= iu; i++) {
+        for (int j = jl; j <= ju; j++) {
+            for (int k = kl; k <= ku; k++) {
+                if (isFluid(Flag[IDXFLAG(i,j,k)])) {
+                    Real divergence = (U[IDXU(i,j,k)] - U[IDXU(i-1,j,k)]) / dx
+                            + (V[IDXV(i,j,k)] - V[IDXV(i,j-1,k)]) / dy
+                            + (W[IDXW(i,j,k)] - W[IDXW(i,j,k-1)]) / dz;
+                    divergenceSum += divergence * divergence;
+                    numFluidCells++;
+                }
+            }
+        }
+    }
+
+    // The divergence is normalized by dividing by the total number of fluid cells (like the residual of the PPE).
+    MPI_Allreduce(MPI_IN_PLACE, &divergenceSum, 1, MPI_REAL_CFD3D, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &numFluidCells, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return numFluidCells == 0 ? Real(0.0) : std::sqrt(divergenceSum / numFluidCells);
+}
+
 void calculateTemperatureMpi(
         Real Re, Real Pr, Real alpha,
         Real dt, Real dx, Real dy, Real dz,
@@ -420,3 +447,5 @@ void calculateTemperatureMpi(
     MPI_Status status;
     mpiExchangeCellData(T, il, iu, jl, ju, kl, ku, rankL, rankR, rankD, rankU, rankB, rankF, bufSend, bufRecv, &status);
 }
+
+}
@@ -31,6 +31,8 @@
 
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /*
  * Determines the value of F, H and H for computing RS.
  */
@@ -67,6 +69,14 @@ void calculateUvwMpi(
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
         Real *U, Real *V, Real *W, Real *F, Real *G, Real *H, Real *P, FlagType *Flag);
 
+/**
+ * Computes the norm of the divergence of the velocity field normalized by the number of fluid cells in the whole
+ * domain. Needs to be called by all processes.
+ */
+Real computeDivergenceNormMpi(
+        Real dx, Real dy, Real dz, int il, int iu, int jl, int ju, int kl, int ku,
+        Real *U, Real *V, Real *W, FlagType *Flag);
+
 /*
  * Calculates the new temperature values.
  */
@@ -78,4 +88,6 @@ void calculateTemperatureMpi(
         int rankL, int rankR, int rankD, int rankU, int rankB, int rankF, Real *bufSend, Real *bufRecv,
         Real *U, Real *V, Real *W, Real *T, Real *T_temp, FlagType *Flag);
 
+}
+
 #endif //CFD3D_UVWMPI_HPP
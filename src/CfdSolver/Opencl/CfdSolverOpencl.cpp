@@ -37,6 +37,8 @@
 #include "../Cpp/SorSolverCpp.hpp"
 #include "../Cpp/BoundaryValuesCpp.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 const std::string openclSourceDirectory = "../src/CfdSolver/Opencl/";
 
 CfdSolverOpencl::CfdSolverOpencl(int platformId, int blockSizeX, int blockSizeY, int blockSizeZ, int blockSize1D) {
@@ -84,7 +86,6 @@ CfdSolverOpencl::CfdSolverOpencl(int platformId, int blockSizeX, int blockSizeY,
     setYZPlanesPressureBoundariesOpenclKernel = cl::Kernel(computeProgramSor, "setYZPlanesPressureBoundariesOpencl");
     setBoundaryConditionsPressureInDomainOpenclKernel = cl::Kernel(
             computeProgramSor, "setBoundaryConditionsPressureInDomainOpencl");
-    copyPressureOpenclKernel = cl::Kernel(computeProgramSor, "copyPressureOpencl");
     reduceSumOpenclKernelReal = cl::Kernel(computeProgramSor, "reduceSumOpenclKernelReal");
     reduceSumOpenclKernelUint = cl::Kernel(computeProgramSor, "reduceSumOpenclKernelUint");
     sorSolverIterationOpenclKernel = cl::Kernel(computeProgramSor, "sorSolverIterationOpencl");
@@ -117,9 +118,10 @@ CfdSolverOpencl::CfdSolverOpencl(int platformId, int blockSizeX, int blockSizeY,
 
 void CfdSolverOpencl::initialize(
         const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-        Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-        int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+        Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+        bool adaptiveOmega, Real epsRelative, bool /*implicitDiffusion*/, TimeIntegratorType /*timeIntegrator*/,
+        Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+        bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
         Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag) {
     this->scenarioName = scenarioName;
     this->linearSystemSolverType = linearSystemSolverType;
@@ -129,6 +131,7 @@ void CfdSolverOpencl::initialize(
     this->omg = omg;
     this->eps = eps;
     this->itermax = itermax;
+    this->residualCheckInterval = residualCheckInterval;
     this->alpha = alpha;
     this->beta = beta;
     this->dt = dt;
@@ -165,7 +168,9 @@ void CfdSolverOpencl::initialize(
     this->Flag = cl::Buffer(
             context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
             (imax+2)*(jmax+2)*(kmax+2)*sizeof(unsigned int), (void*)Flag);
-    this->P_temp = cl::Buffer(context, CL_MEM_READ_WRITE, (imax+2)*(jmax+2)*(kmax+2)*sizeof(Real));
+    this->P_temp = cl::Buffer(
+            context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+            (imax+2)*(jmax+2)*(kmax+2)*sizeof(Real), (void*)P);
     this->T_temp = cl::Buffer(context, CL_MEM_READ_WRITE, (imax+2)*(jmax+2)*(kmax+2)*sizeof(Real));
     this->F = cl::Buffer(context, CL_MEM_READ_WRITE, (imax+1)*(jmax+1)*(kmax+1)*sizeof(Real));
     this->G = cl::Buffer(context, CL_MEM_READ_WRITE, (imax+1)*(jmax+1)*(kmax+1)*sizeof(Real));
@@ -331,7 +336,8 @@ void CfdSolverOpencl::calculateRs() {
 
 void CfdSolverOpencl::executeSorSolver() {
     sorSolverOpencl(
-            omg, eps, itermax, linearSystemSolverType, shallWriteOutput, dx, dy, dz, imax, jmax, kmax,
+            omg, eps, itermax, residualCheckInterval, linearSystemSolverType, shallWriteOutput,
+            dx, dy, dz, imax, jmax, kmax,
             blockSizeX, blockSizeY, blockSizeZ, blockSize1D,
             queue, workGroupSize1D, workGroupSize2D, workGroupSize3D,
             P, P_temp, RS, Flag,
@@ -339,7 +345,7 @@ void CfdSolverOpencl::executeSorSolver() {
             openclReductionArrayNumCells1, openclReductionArrayNumCells2,
             setXYPlanesPressureBoundariesOpenclKernel, setXZPlanesPressureBoundariesOpenclKernel,
             setYZPlanesPressureBoundariesOpenclKernel,
-            setBoundaryConditionsPressureInDomainOpenclKernel, copyPressureOpenclKernel,
+            setBoundaryConditionsPressureInDomainOpenclKernel,
             reduceSumOpenclKernelReal, reduceSumOpenclKernelUint,
             sorSolverIterationOpenclKernel, sorSolverComputeResidualArrayOpenclKernel);
 }
@@ -362,3 +368,5 @@ void CfdSolverOpencl::getDataForOutput(Real *U, Real *V, Real *W, Real *P, Real
     queue.enqueueReadBuffer(this->T, CL_FALSE, 0, sizeof(Real)*(imax+2)*(jmax+2)*(kmax+2), (void*)T);
     queue.finish();
 }
+
+}
@@ -33,6 +33,8 @@
 #include "CfdSolver/CfdSolver.hpp"
 #include "ClInterface.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 class CfdSolverOpencl : public CfdSolver {
 public:
     /**
@@ -56,6 +58,9 @@ public:
      * @param omg The over-relaxation factor of the SOR solver.
      * @param eps The residual value (epsilon) for which the solution of the SOR solver is considered as converged.
      * @param itermax The maximum number of iterations the SOR solver performs until it gives up.
+     * @param residualCheckInterval The number of iterations of the SOR solver after which the convergence is checked.
+     * @param pressureHistorySize The number of previous pressure solutions the initial guess of the SOR solver is
+     * computed from (not supported by this solver, the last solution is always used as the initial guess).
      * @param alpha Donor-cell scheme factor.
      * @param beta Coefficient of thermal expansion.
      * @param dt If tau > 0: The constant time step to use for simulating. Otherwise, dt is overwritten each iteration.
@@ -82,9 +87,10 @@ public:
      */
     virtual void initialize(
             const std::string &scenarioName, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-            Real Re, Real Pr, Real omg, Real eps, int itermax, Real alpha, Real beta, Real dt, Real tau,
-            Real GX, Real GY, Real GZ, bool useTemperature, Real T_h, Real T_c,
-            int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
+            Real Re, Real Pr, Real omg, Real eps, int itermax, int residualCheckInterval, int pressureHistorySize,
+            bool adaptiveOmega, Real epsRelative, bool implicitDiffusion, TimeIntegratorType timeIntegrator,
+            Real alpha, Real beta, Real dt, Real tau, Real GX, Real GY, Real GZ,
+            bool useTemperature, Real T_h, Real T_c, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
             Real *U, Real *V, Real *W, Real *P, Real *T, uint32_t *Flag);
 
     /**
@@ -154,7 +160,7 @@ private:
     bool shallWriteOutput;
     Real Re, Pr, omg, eps, alpha, beta, dt, tau, GX, GY, GZ, T_h, T_c;
     bool useTemperature;
-    int itermax;
+    int itermax, residualCheckInterval;
     int imax, jmax, kmax;
     Real dx, dy, dz;
     cl::Buffer U, V, W, P, P_temp, T, T_temp, F, G, H, RS;
@@ -176,7 +182,7 @@ private:
 
     cl::Kernel setXYPlanesPressureBoundariesOpenclKernel, setXZPlanesPressureBoundariesOpenclKernel,
             setYZPlanesPressureBoundariesOpenclKernel, setBoundaryConditionsPressureInDomainOpenclKernel,
-            copyPressureOpenclKernel, reduceSumOpenclKernelReal, reduceSumOpenclKernelUint,
+            reduceSumOpenclKernelReal, reduceSumOpenclKernelUint,
             sorSolverIterationOpenclKernel, sorSolverComputeResidualArrayOpenclKernel;
 
     cl::Kernel calculateFghOpenclKernel, setFBoundariesOpenclKernel, setGBoundariesOpenclKernel,
@@ -192,4 +198,6 @@ private:
 };
 
 
+}
+
 #endif //CFD3D_CFDSOLVEROPENCL_HPP
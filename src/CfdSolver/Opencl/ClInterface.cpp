@@ -31,6 +31,8 @@
 #include <fstream>
 #include "ClInterface.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 ClInterface::~ClInterface()
 {
 }
@@ -171,3 +173,4 @@ cl::NDRange ClInterface::rangePadding3D(int w, int h, int d, cl::NDRange local)
     return cl::NDRange(iceil(w, local[0])*local[0], iceil(h, local[1])*local[1], iceil(d, local[2])*local[2]);
 }
 
+}
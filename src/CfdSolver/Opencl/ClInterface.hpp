@@ -38,6 +38,8 @@
 #include "CL/cl2.hpp"
 #include "Singleton.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /// Represents information on OpenCL context creation
 struct CLContextInfo {
     /// The number of the OpenCL platform to be used (usually 0)
@@ -103,4 +105,6 @@ private:
 
 std::string loadTextFile(const std::string &filename);
 
+}
+
 #endif /* CLINTERFACE_HPP_ */
@@ -108,16 +108,6 @@ kernel void setBoundaryConditionsPressureInDomainOpencl(
     }
 }
 
-kernel void copyPressureOpencl(int imax, int jmax, int kmax, global Real *P, global Real *P_temp) {
-    int i = get_global_id(2);
-    int j = get_global_id(1);
-    int k = get_global_id(0);
-
-    if (i <= imax + 1 && j <= jmax + 1 && k <= kmax + 1) {
-        P_temp[IDXP(i, j, k)] = P[IDXP(i, j, k)];
-    }
-}
-
 /**
  * Reference: Based on kernel 4 from https://developer.download.nvidia.com/assets/cuda/files/reduction.pdf
  * @param input The array of input values (of size 'sizeOfInput').
@@ -198,10 +188,10 @@ kernel void sorSolverIterationOpencl(
 
     if (i <= imax && j <= jmax && k <= kmax) {
         if (isFluid(Flag[IDXFLAG(i,j,k)])) {
-            P[IDXP(i, j, k)] = ((Real)(1.0) - omg) * P_temp[IDXP(i, j, k)] + coeff *
-                    ((P_temp[IDXP(i + 1, j, k)] + P_temp[IDXP(i - 1, j, k)]) / (dx * dx)
-                     + (P_temp[IDXP(i, j + 1, k)] + P_temp[IDXP(i, j - 1, k)]) / (dy * dy)
-                     + (P_temp[IDXP(i, j, k + 1)] + P_temp[IDXP(i, j, k - 1)]) / (dz * dz)
+            P_temp[IDXP(i, j, k)] = ((Real)(1.0) - omg) * P[IDXP(i, j, k)] + coeff *
+                    ((P[IDXP(i + 1, j, k)] + P[IDXP(i - 1, j, k)]) / (dx * dx)
+                     + (P[IDXP(i, j + 1, k)] + P[IDXP(i, j - 1, k)]) / (dy * dy)
+                     + (P[IDXP(i, j, k + 1)] + P[IDXP(i, j, k - 1)]) / (dz * dz)
                      - RS[IDXRS(i, j, k)]);
         }
     }
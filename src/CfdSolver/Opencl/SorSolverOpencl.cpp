@@ -28,8 +28,11 @@
 
 #include <iostream>
 #include <cmath>
+#include <utility>
 #include "SorSolverOpencl.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /*
  * Overwrites the contents of the passed reduction arrays.
  */
@@ -127,8 +130,8 @@ unsigned int reduceSumOpenclUint(
 
 
 void sorSolverOpencl(
-        Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
         int blockSizeX, int blockSizeY, int blockSizeZ, int blockSize1D,
         cl::CommandQueue &queue, cl::NDRange workGroupSize1D, cl::NDRange workGroupSize2D, cl::NDRange workGroupSize3D,
         cl::Buffer &P, cl::Buffer &P_temp, cl::Buffer &RS, cl::Buffer &Flag,
@@ -136,7 +139,7 @@ void sorSolverOpencl(
         cl::Buffer &openclReductionArrayNumCells1, cl::Buffer &openclReductionArrayNumCells2,
         cl::Kernel &setXYPlanesPressureBoundariesOpenclKernel, cl::Kernel &setXZPlanesPressureBoundariesOpenclKernel,
         cl::Kernel &setYZPlanesPressureBoundariesOpenclKernel,
-        cl::Kernel &setBoundaryConditionsPressureInDomainOpenclKernel, cl::Kernel &copyPressureOpenclKernel,
+        cl::Kernel &setBoundaryConditionsPressureInDomainOpenclKernel,
         cl::Kernel &reduceSumOpenclKernelReal, cl::Kernel &reduceSumOpenclKernelUint,
         cl::Kernel &sorSolverIterationOpenclKernel, cl::Kernel &sorSolverComputeResidualArrayOpenclKernel) {
     if (linearSystemSolverType == LINEAR_SOLVER_SOR || linearSystemSolverType == LINEAR_SOLVER_SOR_PARALLEL) {
@@ -169,11 +172,6 @@ void sorSolverOpencl(
     auto setBoundaryConditionsPressureInDomainOpencl = cl::KernelFunctor<int, int, int, cl::Buffer, cl::Buffer>(
             setBoundaryConditionsPressureInDomainOpenclKernel);
 
-    cl::EnqueueArgs eargsWholeDomain3D(
-            queue, cl::NullRange,
-            ClInterface::get()->rangePadding3D(kmax+2, jmax+2, imax+2, workGroupSize3D), workGroupSize3D);
-    auto copyPressureOpencl = cl::KernelFunctor<int, int, int, cl::Buffer, cl::Buffer>(copyPressureOpenclKernel);
-
     auto sorSolverIterationOpencl = cl::KernelFunctor<
             Real, Real, Real, Real, Real, int, int, int, cl::Buffer, cl::Buffer, cl::Buffer, cl::Buffer>(
             sorSolverIterationOpenclKernel);
@@ -192,24 +190,34 @@ void sorSolverOpencl(
         setYZPlanesPressureBoundariesOpencl(eargsYZ, imax, jmax, kmax, P);
         setBoundaryConditionsPressureInDomainOpencl(eargs3D, imax, jmax, kmax, P, Flag);
 
-        copyPressureOpencl(eargsWholeDomain3D, imax, jmax, kmax, P, P_temp);
-
+        // The new values are written to P_temp. Swapping the buffers replaces the copy of P.
         sorSolverIterationOpencl(eargs3D, omg, dx, dy, dz, coeff, imax, jmax, kmax, P, P_temp, RS, Flag);
-        sorSolverComputeResidualArrayOpencl(
-                eargs3D, dx, dy, dz, imax, jmax, kmax, P, RS, Flag,
-                openclReductionArrayResidual1, openclReductionArrayNumCells1);
-
-        residual = reduceSumOpenclReal(
-                queue, workGroupSize1D, reduceSumOpenclKernelReal, openclReductionArrayResidual1,
-                imax*jmax*kmax, openclReductionArrayResidual2, blockSize1D);
-        unsigned int numFluidCells = reduceSumOpenclUint(
-                queue, workGroupSize1D, reduceSumOpenclKernelUint, openclReductionArrayNumCells1,
-                imax*jmax*kmax, openclReductionArrayNumCells2, blockSize1D);
-        residual = std::sqrt(residual / Real(numFluidCells));
-
+        std::swap(P, P_temp);
         it++;
+
+        // Convergence is only checked every residualCheckInterval iterations. The boundary values of the current buffer
+        // were last set two iterations ago, so they are updated before computing the residual.
+        if (it % residualCheckInterval == 0 || it == itermax) {
+            setXYPlanesPressureBoundariesOpencl(eargsXY, imax, jmax, kmax, P);
+            setXZPlanesPressureBoundariesOpencl(eargsXZ, imax, jmax, kmax, P);
+            setYZPlanesPressureBoundariesOpencl(eargsYZ, imax, jmax, kmax, P);
+            setBoundaryConditionsPressureInDomainOpencl(eargs3D, imax, jmax, kmax, P, Flag);
+            sorSolverComputeResidualArrayOpencl(
+                    eargs3D, dx, dy, dz, imax, jmax, kmax, P, RS, Flag,
+                    openclReductionArrayResidual1, openclReductionArrayNumCells1);
+
+            residual = reduceSumOpenclReal(
+                    queue, workGroupSize1D, reduceSumOpenclKernelReal, openclReductionArrayResidual1,
+                    imax*jmax*kmax, openclReductionArrayResidual2, blockSize1D);
+            unsigned int numFluidCells = reduceSumOpenclUint(
+                    queue, workGroupSize1D, reduceSumOpenclKernelUint, openclReductionArrayNumCells1,
+                    imax*jmax*kmax, openclReductionArrayNumCells2, blockSize1D);
+            residual = std::sqrt(residual / Real(numFluidCells));
+        }
     }
 
+    // The loop only terminates after a residual check, so the boundary values of the current buffer are up to date.
+
     if (((residual > eps && it == itermax) || std::isnan(residual)) && shallWriteOutput) {
         std::cerr << "\nSOR solver reached maximum number of iterations without converging (res: "
                   << residual << ")." << std::endl;
@@ -219,3 +227,5 @@ void sorSolverOpencl(
         exit(1);
     }
 }
+
+}
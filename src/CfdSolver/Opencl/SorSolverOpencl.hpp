@@ -32,12 +32,15 @@
 #include "Defines.hpp"
 #include "ClInterface.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Uses an SOR solver to compute the updated pressure values using the pressure poisson equation (PPE).
+ * The iterations alternate between the buffers P and P_temp, so the two may be swapped after the call.
  */
 void sorSolverOpencl(
-        Real omg, Real eps, int itermax, LinearSystemSolverType linearSystemSolverType, bool shallWriteOutput,
-        Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
+        Real omg, Real eps, int itermax, int residualCheckInterval, LinearSystemSolverType linearSystemSolverType,
+        bool shallWriteOutput, Real dx, Real dy, Real dz, int imax, int jmax, int kmax,
         int blockSizeX, int blockSizeY, int blockSizeZ, int blockSize1D,
         cl::CommandQueue &queue, cl::NDRange workGroupSize1D, cl::NDRange workGroupSize2D, cl::NDRange workGroupSize3D,
         cl::Buffer &P, cl::Buffer &P_temp, cl::Buffer &RS, cl::Buffer &Flag,
@@ -45,8 +48,10 @@ void sorSolverOpencl(
         cl::Buffer &openclReductionArrayNumCells1, cl::Buffer &openclReductionArrayNumCells2,
         cl::Kernel &setXYPlanesPressureBoundariesOpenclKernel, cl::Kernel &setXZPlanesPressureBoundariesOpenclKernel,
         cl::Kernel &setYZPlanesPressureBoundariesOpenclKernel,
-        cl::Kernel &setBoundaryConditionsPressureInDomainOpenclKernel, cl::Kernel &copyPressureOpenclKernel,
+        cl::Kernel &setBoundaryConditionsPressureInDomainOpenclKernel,
         cl::Kernel &reduceSumOpenclKernelReal, cl::Kernel &reduceSumOpenclKernelUint,
         cl::Kernel &sorSolverIterationOpenclKernel, cl::Kernel &sorSolverComputeResidualArrayOpenclKernel);
 
+}
+
 #endif //CFD3D_SORSOLVEROPENCL_HPP
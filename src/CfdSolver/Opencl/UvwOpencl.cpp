@@ -30,6 +30,8 @@
 #include <iostream>
 #include "UvwOpencl.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void calculateDtOpencl(
         Real Re, Real Pr, Real tau,
         Real &dt, Real dx, Real dy, Real dz, int imax, int jmax, int kmax, int blockSize1D,
@@ -142,3 +144,4 @@ void calculateDtOpencl(
     dt = tau * dt;
 }
 
+}
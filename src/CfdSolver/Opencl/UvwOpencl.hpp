@@ -32,6 +32,8 @@
 #include "Defines.hpp"
 #include "ClInterface.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /*
  * Determines the maximum time step size. The time step size is restricted according to the CFL theorem.
  */
@@ -45,4 +47,6 @@ void calculateDtOpencl(
         cl::Buffer &openclReductionArrayW1, cl::Buffer &openclReductionArrayW2,
         bool useTemperature);
 
+}
+
 #endif //CFD3D_UVWOPENCL_HPP
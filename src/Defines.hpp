@@ -31,8 +31,6 @@
 
 #include <glm/vec3.hpp>
 
-#define REAL_FLOAT
-
 /**
  * The type used for the Flag array. The array stores the type of each cell (i.e., fluid, type of obstacle cell, etc.).
  */
@@ -43,15 +41,34 @@ typedef unsigned int FlagType;
  */
 enum LinearSystemSolverType {
     LINEAR_SOLVER_JACOBI, LINEAR_SOLVER_SOR, LINEAR_SOLVER_GAUSS_SEIDEL, LINEAR_SOLVER_SOR_PARALLEL,
-    LINEAR_SOLVER_GAUSS_SEIDEL_PARALLEL
+    LINEAR_SOLVER_GAUSS_SEIDEL_PARALLEL, LINEAR_SOLVER_MULTIGRID, LINEAR_SOLVER_MULTIGRID_W_CYCLE,
+    LINEAR_SOLVER_PCG_JACOBI, LINEAR_SOLVER_PCG_SGS, LINEAR_SOLVER_SOR_RED_BLACK, LINEAR_SOLVER_GAUSS_SEIDEL_RED_BLACK,
+    LINEAR_SOLVER_DCT, LINEAR_SOLVER_JACOBI_TEMPORAL_BLOCKING, LINEAR_SOLVER_CHEBYSHEV, LINEAR_SOLVER_ZEBRA_LINE,
+    LINEAR_SOLVER_SOR_WAVEFRONT, LINEAR_SOLVER_GAUSS_SEIDEL_WAVEFRONT
+};
+
+/**
+ * The explicit time integration scheme of the momentum and temperature equations: Forward Euler, the second-order
+ * Adams-Bashforth method or the third-order strong stability preserving Runge-Kutta method (with one pressure
+ * projection per stage).
+ */
+enum TimeIntegratorType {
+    TIME_INTEGRATOR_EULER, TIME_INTEGRATOR_ADAMS_BASHFORTH_2, TIME_INTEGRATOR_RUNGE_KUTTA_3
 };
 
 
 /**
  * The floating point type used for the simulation. float is faster, but double has a higher accuracy.
+ * The build compiles all sources depending on Real twice, once with REAL_FLOAT and once with REAL_DOUBLE defined. All
+ * of their declarations are placed in the namespace CFD3D_PRECISION_NAMESPACE (i.e., cfd3d_float or cfd3d_double), so
+ * both variants can be linked into one binary. Which one is run is selected with the command line argument
+ * '--precision'. Sources compiled without either macro (i.e., the ones not depending on Real) see the float variant.
  */
+#if !defined(REAL_FLOAT) && !defined(REAL_DOUBLE)
+#define REAL_FLOAT
+#endif
 #ifdef REAL_FLOAT
-typedef float Real;
+#define CFD3D_PRECISION_NAMESPACE cfd3d_float
 #define stringToReal std::stof
 #define nc_put_var_real nc_put_var_float
 #define nc_put_vara_real nc_put_vara_float
@@ -59,7 +76,7 @@ typedef float Real;
 #define NC_REAL 5
 #endif
 #ifdef REAL_DOUBLE
-typedef double Real;
+#define CFD3D_PRECISION_NAMESPACE cfd3d_double
 #define stringToReal std::stod
 #define nc_put_var_real nc_put_var_double
 #define nc_put_vara_real nc_put_vara_double
@@ -67,7 +84,15 @@ typedef double Real;
 #define NC_REAL 6
 #endif
 
+namespace CFD3D_PRECISION_NAMESPACE {
+#ifdef REAL_FLOAT
+typedef float Real;
+#endif
+#ifdef REAL_DOUBLE
+typedef double Real;
+#endif
 typedef glm::vec<3, Real, glm::defaultp> rvec3;
+}
 
 // Computes the square of a number.
 #define SQR(x) ((x)*(x))
@@ -42,7 +42,8 @@ void parseArguments(
     solverName = "cpp";
     shallWriteOutput = true;
     outputFileWriterType = "vtk";
-    linearSystemSolverType = LINEAR_SOLVER_JACOBI;
+    // The direct DCT solver is used if the geometry allows it, otherwise the Jacobi solver is used.
+    linearSystemSolverType = LINEAR_SOLVER_DCT;
     numParticles = 500;
     traceStreamlines = false;
     iproc = jproc = kproc = 1;
@@ -64,10 +65,34 @@ void parseArguments(
         } else if (strcmp(argv[i], "--linsolver") == 0 && i != argc - 1) {
             if (strcmp(argv[i+1], "jacobi") == 0) {
                 linearSystemSolverType = LINEAR_SOLVER_JACOBI;
+            } else if (strcmp(argv[i+1], "jacobi-blocked") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_JACOBI_TEMPORAL_BLOCKING;
+            } else if (strcmp(argv[i+1], "chebyshev") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_CHEBYSHEV;
             } else if (strcmp(argv[i+1], "sor") == 0) {
                 linearSystemSolverType = LINEAR_SOLVER_SOR;
             } else if (strcmp(argv[i+1], "gauss-seidel") == 0) {
                 linearSystemSolverType = LINEAR_SOLVER_GAUSS_SEIDEL;
+            } else if (strcmp(argv[i+1], "sor-wavefront") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_SOR_WAVEFRONT;
+            } else if (strcmp(argv[i+1], "gauss-seidel-wavefront") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_GAUSS_SEIDEL_WAVEFRONT;
+            } else if (strcmp(argv[i+1], "sor-redblack") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_SOR_RED_BLACK;
+            } else if (strcmp(argv[i+1], "gauss-seidel-redblack") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_GAUSS_SEIDEL_RED_BLACK;
+            } else if (strcmp(argv[i+1], "zebra-line") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_ZEBRA_LINE;
+            } else if (strcmp(argv[i+1], "multigrid") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_MULTIGRID;
+            } else if (strcmp(argv[i+1], "multigrid-w") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_MULTIGRID_W_CYCLE;
+            } else if (strcmp(argv[i+1], "pcg") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_PCG_JACOBI;
+            } else if (strcmp(argv[i+1], "pcg-sgs") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_PCG_SGS;
+            } else if (strcmp(argv[i+1], "dct") == 0) {
+                linearSystemSolverType = LINEAR_SOLVER_DCT;
             } else {
                 std::cerr << "Specified invalid linear systems solver name." << std::endl;
                 exit(1);
@@ -92,3 +117,58 @@ void parseArguments(
         }
     }
 }
+
+std::string getLinearSystemSolverName(LinearSystemSolverType linearSystemSolverType) {
+    switch (linearSystemSolverType) {
+        case LINEAR_SOLVER_JACOBI:
+            return "jacobi";
+        case LINEAR_SOLVER_JACOBI_TEMPORAL_BLOCKING:
+            return "jacobi-blocked";
+        case LINEAR_SOLVER_CHEBYSHEV:
+            return "chebyshev";
+        case LINEAR_SOLVER_SOR:
+            return "sor";
+        case LINEAR_SOLVER_GAUSS_SEIDEL:
+            return "gauss-seidel";
+        case LINEAR_SOLVER_SOR_PARALLEL:
+            return "sor-parallel";
+        case LINEAR_SOLVER_GAUSS_SEIDEL_PARALLEL:
+            return "gauss-seidel-parallel";
+        case LINEAR_SOLVER_SOR_WAVEFRONT:
+            return "sor-wavefront";
+        case LINEAR_SOLVER_GAUSS_SEIDEL_WAVEFRONT:
+            return "gauss-seidel-wavefront";
+        case LINEAR_SOLVER_SOR_RED_BLACK:
+            return "sor-redblack";
+        case LINEAR_SOLVER_GAUSS_SEIDEL_RED_BLACK:
+            return "gauss-seidel-redblack";
+        case LINEAR_SOLVER_ZEBRA_LINE:
+            return "zebra-line";
+        case LINEAR_SOLVER_MULTIGRID:
+            return "multigrid";
+        case LINEAR_SOLVER_MULTIGRID_W_CYCLE:
+            return "multigrid-w";
+        case LINEAR_SOLVER_PCG_JACOBI:
+            return "pcg";
+        case LINEAR_SOLVER_PCG_SGS:
+            return "pcg-sgs";
+        case LINEAR_SOLVER_DCT:
+            return "dct";
+    }
+    return "unknown";
+}
+
+std::string parsePrecisionArgument(int argc, char *argv[]) {
+    std::string precision = "float";
+    // Arguments like '--numproc' take more than one value, so all positions are checked.
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--precision") == 0) {
+            precision = argv[i+1];
+        }
+    }
+    if (precision != "float" && precision != "double" && precision != "mixed") {
+        std::cerr << "Specified invalid precision \"" << precision << "\"." << std::endl;
+        exit(1);
+    }
+    return precision;
+}
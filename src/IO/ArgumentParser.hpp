@@ -61,4 +61,19 @@ void parseArguments(
         int &blockSizeX, int &blockSizeY, int &blockSizeZ, int &blockSize1D,
         int &openclPlatformId);
 
+/**
+ * Returns the name of the passed linear system solver as used by the command line argument '--linsolver'.
+ */
+std::string getLinearSystemSolverName(LinearSystemSolverType linearSystemSolverType);
+
+/**
+ * Parses the command line argument '--precision', which selects the floating point precision of the simulation.
+ * "mixed" runs the simulation in double precision, but lets the Jacobi and SOR type solvers of the C++ solver iterate
+ * in single precision on the correction of the pressure. Invalid values terminate the program.
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return "float" (the default), "double" or "mixed".
+ */
+std::string parsePrecisionArgument(int argc, char *argv[]);
+
 #endif //CFD3D_ARGUMENTPARSER_HPP
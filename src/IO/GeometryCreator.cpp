@@ -32,6 +32,8 @@
 #include "GeometryFile.hpp"
 #include "GeometryCreator.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * For more details regarding these values, please see docs/FlagsBitfield.pdf.
  */
@@ -277,4 +279,6 @@ void generateScenario(
     } else if (boost::starts_with(scenarioName, "HK_Habor")) {
         createHeightMapGeometry(scenarioName, geometryFilename, "../geometry-pgm/HK_Habor.pgm", imax, jmax, kmax);
     }
-}
\ No newline at end of file
+}
+
+}
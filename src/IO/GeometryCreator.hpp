@@ -33,6 +33,8 @@
 #include <functional>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * GeometryCreator is a class for programmatically generating .bingeo files storing the geometry information for
  * different scenarios. It offers functions to set certain layers in the domain, to set layers from two-dimensional
@@ -120,4 +122,6 @@ private:
 void generateScenario(
         const std::string &scenarioName, const std::string &geometryFilename, int imax, int jmax, int kmax);
 
+}
+
 #endif //CFD3D_GEOMETRYCREATOR_HPP
@@ -30,6 +30,8 @@
 #include <netcdf.h>
 #include "NetCdfWriter.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void NetCdfWriter::setMpiData(int il, int iu, int jl, int ju, int kl, int ku) {
     this->il = il;
     this->iu = iu;
@@ -225,3 +227,5 @@ void NetCdfWriter::writeTimestep(int timeStepNumber, Real time, Real *U, Real *V
 
     //nc_sync(ncid);
 }
+
+}
@@ -31,6 +31,8 @@
 
 #include "OutputFileWriter.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 class NetCdfWriter : public OutputFileWriter {
 public:
     NetCdfWriter(int nproc, int myrank) : nproc(nproc), myrank(myrank) {}
@@ -101,4 +103,6 @@ private:
 };
 
 
+}
+
 #endif //CFD3D_NETCDFWRITER_HPP
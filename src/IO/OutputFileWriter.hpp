@@ -32,6 +32,8 @@
 #include <string>
 #include "CfdSolver/Flag.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * This class is the super class of @see VtkWriter and @see NetCdfWriter.
  */
@@ -82,4 +84,6 @@ public:
 };
 
 
+}
+
 #endif //CFD3D_OUTPUTFILEWRITER_HPP
@@ -29,6 +29,8 @@
 #include <iostream>
 #include "ProgressBar.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 const char prefix[] = "Progress: [";
 const char suffix[] = "]";
 const size_t prefixLength = sizeof(prefix) - 1;
@@ -62,3 +64,5 @@ void ProgressBar::printProgress(Real t, Real tEnd, std::size_t max) {
     std::cout << currentProgressPercent << "%\tt = " << t;
     std::cout.flush();
 }
+
+}
@@ -33,6 +33,8 @@
 #include <string>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 class ProgressBar {
 public:
     /**
@@ -56,4 +58,6 @@ private:
 };
 
 
+}
+
 #endif //CFD3D_PROGRESSBAR_HPP
@@ -32,6 +32,8 @@
 #include <boost/algorithm/string/split.hpp>
 #include "ScenarioFile.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 std::map<std::string, std::string> loadVariablesFromDatFile(const std::string &filename) {
     std::map<std::string, std::string> variables;
     std::ifstream file(filename.c_str());
@@ -137,8 +139,9 @@ void readScenarioConfigurationFromFile(
         Real &tEnd, Real &dtWrite, Real &xLength, Real &yLength, Real &zLength,
         Real &xOrigin, Real &yOrigin, Real &zOrigin,
         Real &UI, Real &VI, Real &WI, Real &PI, Real &TI, Real &GX, Real &GY, Real &GZ,
-        Real &Re, Real &Pr, Real &omg, Real &eps, int &itermax, Real &alpha, Real &beta, Real &dt, Real &tau,
-        bool &useTemperature, Real &T_h, Real &T_c,
+        Real &Re, Real &Pr, Real &omg, Real &eps, int &itermax, int &residualCheckInterval, int &pressureHistorySize,
+        bool &adaptiveOmega, Real &epsRelative, bool &implicitDiffusion, TimeIntegratorType &timeIntegrator,
+        Real &alpha, Real &beta, Real &dt, Real &tau, bool &useTemperature, Real &T_h, Real &T_c,
         int &imax, int &jmax, int &kmax, Real &dx, Real &dy, Real &dz) {
     std::map<std::string, std::string> variables = loadVariablesFromDatFile(scenarioFilename);
 
@@ -169,6 +172,54 @@ void readScenarioConfigurationFromFile(
     omg = readRealVariable(variables, "omg");
     eps = readRealVariable(variables, "eps");
     itermax = readIntVariable(variables, "itermax");
+    bool residualCheckIntervalFound = true;
+    residualCheckInterval = readIntVariableOptional(
+            variables, "residualCheckInterval", 1, residualCheckIntervalFound);
+    if (residualCheckInterval < 1) {
+        std::cerr << "Variable 'residualCheckInterval' needs to be a positive integer." << std::endl;
+        exit(1);
+    }
+    bool pressureHistorySizeFound = true;
+    pressureHistorySize = readIntVariableOptional(variables, "pressureHistorySize", 0, pressureHistorySizeFound);
+    if (pressureHistorySize < 0) {
+        std::cerr << "Variable 'pressureHistorySize' must not be negative." << std::endl;
+        exit(1);
+    }
+    bool adaptiveOmegaFound = true;
+    std::string adaptiveOmegaString = readStringVariableOptional(
+            variables, "adaptiveOmega", "false", adaptiveOmegaFound);
+    if (adaptiveOmegaString != "true" && adaptiveOmegaString != "false") {
+        std::cerr << "Variable 'adaptiveOmega' needs to be either 'true' or 'false'." << std::endl;
+        exit(1);
+    }
+    adaptiveOmega = adaptiveOmegaString == "true";
+    bool epsRelativeFound = true;
+    epsRelative = readRealVariableOptional(variables, "epsRelative", 0.0, epsRelativeFound);
+    if (epsRelative < 0 || epsRelative >= 1) {
+        std::cerr << "Variable 'epsRelative' needs to be in the range [0,1)." << std::endl;
+        exit(1);
+    }
+    bool implicitDiffusionFound = true;
+    std::string implicitDiffusionString = readStringVariableOptional(
+            variables, "implicitDiffusion", "false", implicitDiffusionFound);
+    if (implicitDiffusionString != "true" && implicitDiffusionString != "false") {
+        std::cerr << "Variable 'implicitDiffusion' needs to be either 'true' or 'false'." << std::endl;
+        exit(1);
+    }
+    implicitDiffusion = implicitDiffusionString == "true";
+    bool timeIntegratorFound = true;
+    std::string timeIntegratorString = readStringVariableOptional(
+            variables, "timeIntegrator", "euler", timeIntegratorFound);
+    if (timeIntegratorString == "euler") {
+        timeIntegrator = TIME_INTEGRATOR_EULER;
+    } else if (timeIntegratorString == "ab2") {
+        timeIntegrator = TIME_INTEGRATOR_ADAMS_BASHFORTH_2;
+    } else if (timeIntegratorString == "rk3") {
+        timeIntegrator = TIME_INTEGRATOR_RUNGE_KUTTA_3;
+    } else {
+        std::cerr << "Variable 'timeIntegrator' needs to be either 'euler', 'ab2' or 'rk3'." << std::endl;
+        exit(1);
+    }
     alpha = readRealVariable(variables, "alpha");
     beta = readRealVariableOptional(variables, "beta", 0.0, useTemperature);
     dt = readRealVariable(variables, "dt");
@@ -184,3 +235,5 @@ void readScenarioConfigurationFromFile(
     dy = yLength / Real(jmax);
     dz = zLength / Real(kmax);
 }
+
+}
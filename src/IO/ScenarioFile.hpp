@@ -34,6 +34,8 @@
 #include <vector>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Loads a scenario configuration file in the .dat format.
  * @param scenarioFilename The file name of the scenario configuration file.
@@ -60,6 +62,16 @@
  * @param omg The over-relaxation factor of the SOR solver.
  * @param eps The residual value (epsilon) for which the solution of the SOR solver is considered as converged.
  * @param itermax The maximum number of iterations the SOR solver performs until it gives up.
+ * @param residualCheckInterval The number of iterations of the SOR solver after which the convergence is checked
+ * (optional, 1 if not specified).
+ * @param pressureHistorySize The number of previous pressure solutions the initial guess of the SOR solver is computed
+ * from (optional, 0 if not specified).
+ * @param adaptiveOmega Whether the over-relaxation factor of the SOR solver is estimated online (optional, false if not
+ * specified).
+ * @param epsRelative The residual for which the solution of the SOR solver is considered as converged relative to the
+ * norm of the right-hand side (optional, 0 if not specified, i.e., only eps is used).
+ * @param implicitDiffusion Whether the diffusive terms are treated implicitly (optional, false if not specified).
+ * @param timeIntegrator The time integration scheme, 'euler', 'ab2' or 'rk3' (optional, 'euler' if not specified).
  * @param alpha Donor-cell scheme factor.
  * @param beta Coefficient of thermal expansion.
  * @param dt If tau > 0: The constant time step to use for simulating. Otherwise, dt is overwritten each iteration.
@@ -86,8 +98,11 @@ void readScenarioConfigurationFromFile(
         Real &tEnd, Real &dtWrite, Real &xLength, Real &yLength, Real &zLength,
         Real &xOrigin, Real &yOrigin, Real &zOrigin,
         Real &UI, Real &VI, Real &WI, Real &PI, Real &TI, Real &GX, Real &GY, Real &GZ,
-        Real &Re, Real &Pr, Real &omg, Real &eps, int &itermax, Real &alpha, Real &beta, Real &dt, Real &tau,
-        bool &useTemperature, Real &T_h, Real &T_c,
+        Real &Re, Real &Pr, Real &omg, Real &eps, int &itermax, int &residualCheckInterval, int &pressureHistorySize,
+        bool &adaptiveOmega, Real &epsRelative, bool &implicitDiffusion, TimeIntegratorType &timeIntegrator,
+        Real &alpha, Real &beta, Real &dt, Real &tau, bool &useTemperature, Real &T_h, Real &T_c,
         int &imax, int &jmax, int &kmax, Real &dx, Real &dy, Real &dz);
 
+}
+
 #endif //CFD3D_SCENARIOFILE_HPP
@@ -32,6 +32,8 @@
 #include "IO/BinaryStream.hpp"
 #include "TrajectoriesFile.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 bool writeTrajectoriesToObjFile(const std::string &filename, const Trajectories &trajectories) {
     std::ofstream file(filename.c_str(), std::ofstream::binary);
     if (!file.is_open()) {
@@ -54,7 +56,7 @@ bool writeTrajectoriesToObjFile(const std::string &filename, const Trajectories
         }
 
         for (size_t i = 0; i < trajectorySize; i++) {
-            const glm::vec3 &v = trajectory.positions.at(i);
+            const rvec3 &v = trajectory.positions.at(i);
             file << "v " << std::setprecision(5) << v.x << " " << v.y << " " << v.z << "\n";
             file << "vt ";// << std::setprecision(5) << trajectory.attributes.at(0).at(i) << "\n";
             for (size_t attributeIndex = 0; attributeIndex < trajectory.attributes.size(); attributeIndex++) {
@@ -135,3 +137,5 @@ bool writeTrajectoriesToBinLinesFile(const std::string &filename, const Trajecto
     file.close();
     return true;
 }
+
+}
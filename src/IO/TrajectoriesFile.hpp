@@ -34,6 +34,8 @@
 #include "Defines.hpp"
 #include "ParticleTracer/ParticleTracer.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Saves a list of trajectories to an .obj file.
  * @param filename The file name of the .obj file.
@@ -50,4 +52,6 @@ bool writeTrajectoriesToObjFile(const std::string &filename, const Trajectories
  */
 bool writeTrajectoriesToBinLinesFile(const std::string &filename, const Trajectories &trajectories);
 
+}
+
 #endif //CFD3D_TRAJECTORIESFILE_HPP
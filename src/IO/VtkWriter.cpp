@@ -31,6 +31,8 @@
 #include "VtkWriter.hpp"
 #include "CfdSolver/Mpi/DefinesMpi.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void VtkWriter::setMpiData(int il, int iu, int jl, int ju, int kl, int ku) {
     this->il = il;
     this->iu = iu;
@@ -416,3 +418,5 @@ void VtkWriter::writeCellData(FILE *file, Real *P, Real *T, FlagType *Flag) {
         }
     }
 }
+
+}
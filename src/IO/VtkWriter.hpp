@@ -31,6 +31,8 @@
 
 #include "OutputFileWriter.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 class VtkWriter : public OutputFileWriter {
 public:
     VtkWriter(int nproc, int myrank, bool isBinaryVtk = true) : nproc(nproc), myrank(myrank), isBinaryVtk(isBinaryVtk)
@@ -101,4 +103,6 @@ private:
 };
 
 
+}
+
 #endif //CFD3D_VTKWRITER_HPP
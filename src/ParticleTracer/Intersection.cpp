@@ -31,6 +31,8 @@
 
 #define BIAS (Real(0.00001))
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Helper function for rayBoxIntersection (see below).
  */
@@ -91,3 +93,5 @@ bool rayBoxIntersection(
     //exitPoint = rayOrigin + tFar * rayDirection;
     return true;
 }
+
+}
@@ -31,6 +31,8 @@
 
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * Computes the intersections of a ray with a box in 3D.
  * @param rayOrigin The origin of the ray in R^3.
@@ -45,4 +47,6 @@ bool rayBoxIntersection(
         const rvec3 &rayOrigin, const rvec3 &rayDirection, const rvec3 &lower, const rvec3 &upper,
         Real &tNear, Real &tFar);
 
+}
+
 #endif //CFD3D_INTERSECTION_HPP
@@ -31,6 +31,8 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include "ParticleTracer.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 rvec3 integrateParticlePositionEuler(
         const rvec3 &particlePosition, const rvec3 &gridOrigin, const rvec3 &gridSize,
         int imax, int jmax, int kmax, Real *U, Real *V, Real *W, Real dt) {
@@ -54,3 +56,5 @@ std::vector<rvec3> getParticleSeedingLocationsForScenario(
 
     return particleSeedingLocations;
 }
+
+}
@@ -35,6 +35,8 @@
 #include "Defines.hpp"
 #include "TrajectoryAttributes.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 /**
  * SteadyFlowParticleTracer is the super-class of StreamlineTracer.
  * TimeVaryingParticleTracer is the super-class of PathlineTracer, StreaklineTracer.
@@ -180,4 +182,6 @@ rvec3 integrateParticlePositionEuler(
 std::vector<rvec3> getParticleSeedingLocationsForScenario(
         const std::string &scenarioName, int numParticles, const rvec3 &gridOrigin, const rvec3 &gridSize);
 
+}
+
 #endif //CFD3D_PARTICLETRACER_HPP
@@ -29,6 +29,8 @@
 #include "StreamlineTracer.hpp"
 #include "Intersection.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void traceStreamlineParticle(
         Trajectory &currentTrajectory, const rvec3 &particleStartPosition, const rvec3 &gridOrigin,
         const rvec3 &gridSize, Real dt, int imax, int jmax, int kmax, Real dx, Real dy, Real dz,
@@ -140,3 +142,5 @@ Trajectories StreamlineTracer::trace(
     }
     return trajectories;
 }
+
+}
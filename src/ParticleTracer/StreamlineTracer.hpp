@@ -31,6 +31,8 @@
 
 #include "ParticleTracer.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 class StreamlineTracer : public SteadyFlowParticleTracer
 {
 public:
@@ -58,4 +60,6 @@ public:
             int imax, int jmax, int kmax, Real dx, Real dy, Real dz, Real *U, Real *V, Real *W, Real *P, Real *T);
 };
 
+}
+
 #endif //CFD3D_STREAMLINETRACER_HPP
@@ -28,6 +28,8 @@
 
 #include "TrajectoryAttributes.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 void pushTrajectoryAttributes(
         Trajectory &currentTrajectory, const rvec3 &gridOrigin, const rvec3 &gridSize,
         int imax, int jmax, int kmax, Real dx, Real dy, Real dz, Real *U, Real *V, Real *W, Real *P, Real *T) {
@@ -327,3 +329,5 @@ rvec3 getCurlAt(
     Real dWdy = trilinearInterpolation_dWdy(particlePosition, gridOrigin, gridSize, imax, jmax, kmax, dy, W);
     return rvec3(dWdy - dVdz, dUdz - dWdx, dVdx - dUdy);
 }
+
+}
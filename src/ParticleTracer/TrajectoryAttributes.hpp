@@ -33,6 +33,8 @@
 #include <glm/glm.hpp>
 #include "Defines.hpp"
 
+namespace CFD3D_PRECISION_NAMESPACE {
+
 struct Trajectory {
     std::vector<rvec3> positions;
     std::vector<std::vector<Real>> attributes;
@@ -74,4 +76,6 @@ rvec3 getCurlAt(
         const rvec3 &particlePosition, const rvec3 &gridOrigin, const rvec3 &gridSize,
         int imax, int jmax, int kmax, Real dx, Real dy, Real dz, Real *U, Real *V, Real *W);
 
+}
+
 #endif //CFD3D_TRAJECTORYATTRIBUTES_HPP
@@ -0,0 +1,57 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2019, Christoph Neuhauser, Stefan Haas, Paul Ng
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CFD3D_SIMULATION_HPP
+#define CFD3D_SIMULATION_HPP
+
+/*
+ * The simulation is compiled once per floating point precision (see Defines.hpp). Both variants are declared explicitly
+ * here, as this header is also included by the precision independent main function.
+ */
+
+namespace cfd3d_float {
+/**
+ * Runs the simulation in single precision.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments. For more information on the format, please see README.md.
+ * @return The exit code of the program.
+ */
+int runSimulation(int argc, char *argv[]);
+}
+
+namespace cfd3d_double {
+/**
+ * Runs the simulation in double precision.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments. For more information on the format, please see README.md.
+ * @return The exit code of the program.
+ */
+int runSimulation(int argc, char *argv[]);
+}
+
+#endif //CFD3D_SIMULATION_HPP